@@ -5,25 +5,102 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../example/src/adc.c \
+../example/src/adc_cal.c \
+../example/src/adc_capture.c \
+../example/src/adc_ctrl.c \
+../example/src/adc_decim.c \
+../example/src/adc_dma.c \
+../example/src/adc_dual.c \
+../example/src/adc_event.c \
+../example/src/adc_readout.c \
+../example/src/adc_sched.c \
+../example/src/adc_spectrum.c \
+../example/src/adc_summary.c \
+../example/src/adc_time.c \
+../example/src/adc_trig.c \
+../example/src/audio_desc.c \
+../example/src/cdc_desc.c \
+../example/src/cdc_vcom.c \
 ../example/src/cr_startup_lpc15xx.c \
+../example/src/diag_stats.c \
+../example/src/dsp_fft.c \
+../example/src/dsp_filter.c \
+../example/src/dsp_rice.c \
+../example/src/frame_pool.c \
 ../example/src/hid_desc.c \
 ../example/src/hid_mouse.c \
-../example/src/sysinit.c 
+../example/src/hid_stream.c \
+../example/src/host_frame.c \
+../example/src/host_link.c \
+../example/src/sysinit.c \
+../example/src/uac_stream.c \
+../example/src/usb_audio.c 
 
 OBJS += \
 ./example/src/adc.o \
+./example/src/adc_cal.o \
+./example/src/adc_capture.o \
+./example/src/adc_ctrl.o \
+./example/src/adc_decim.o \
+./example/src/adc_dma.o \
+./example/src/adc_dual.o \
+./example/src/adc_event.o \
+./example/src/adc_readout.o \
+./example/src/adc_sched.o \
+./example/src/adc_spectrum.o \
+./example/src/adc_summary.o \
+./example/src/adc_time.o \
+./example/src/adc_trig.o \
+./example/src/audio_desc.o \
+./example/src/cdc_desc.o \
+./example/src/cdc_vcom.o \
 ./example/src/cr_startup_lpc15xx.o \
+./example/src/diag_stats.o \
+./example/src/dsp_fft.o \
+./example/src/dsp_filter.o \
+./example/src/dsp_rice.o \
+./example/src/frame_pool.o \
 ./example/src/hid_desc.o \
 ./example/src/hid_mouse.o \
-./example/src/sysinit.o 
+./example/src/hid_stream.o \
+./example/src/host_frame.o \
+./example/src/host_link.o \
+./example/src/sysinit.o \
+./example/src/uac_stream.o \
+./example/src/usb_audio.o 
 
 C_DEPS += \
 ./example/src/adc.d \
+./example/src/adc_cal.d \
+./example/src/adc_capture.d \
+./example/src/adc_ctrl.d \
+./example/src/adc_decim.d \
+./example/src/adc_dma.d \
+./example/src/adc_dual.d \
+./example/src/adc_event.d \
+./example/src/adc_readout.d \
+./example/src/adc_sched.d \
+./example/src/adc_spectrum.d \
+./example/src/adc_summary.d \
+./example/src/adc_time.d \
+./example/src/adc_trig.d \
+./example/src/audio_desc.d \
+./example/src/cdc_desc.d \
+./example/src/cdc_vcom.d \
 ./example/src/cr_startup_lpc15xx.d \
+./example/src/diag_stats.d \
+./example/src/dsp_fft.d \
+./example/src/dsp_filter.d \
+./example/src/dsp_rice.d \
+./example/src/frame_pool.d \
 ./example/src/hid_desc.d \
 ./example/src/hid_mouse.d \
-./example/src/sysinit.d 
-
+./example/src/hid_stream.d \
+./example/src/host_frame.d \
+./example/src/host_link.d \
+./example/src/sysinit.d \
+./example/src/uac_stream.d \
+./example/src/usb_audio.d 
 
 # Each subdirectory must supply rules for building sources it contributes
 example/src/%.o: ../example/src/%.c
@@ -0,0 +1,121 @@
+/*
+ * @brief Non-blocking ADC calibration with a context cached across warm resets
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __ADC_CAL_H_
+#define __ADC_CAL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* The calibration result itself cannot be read back and is lost on every
+   reset, so the cached context only records the setup that was last
+   calibrated successfully. A warm reset that finds the same setup starts
+   converting at once and calibrates in the first gap between blocks. */
+
+/** ADC selection bits for ADC_Cal_Setup() */
+#define ADC_CAL_ADC0                (1 << 0)
+#define ADC_CAL_ADC1                (1 << 1)
+
+/** Calibration context kept in no-init RAM across warm resets */
+typedef struct {
+	uint32_t magic;				/*!< ADC_CAL_MAGIC when the context is valid */
+	uint32_t sysClk;			/*!< System clock the ADC clock was derived from */
+	uint32_t adcClk;			/*!< ADC clock rate used for conversions */
+	uint32_t trim;				/*!< ADC_TRIM_VRANGE_* setting */
+	uint32_t adcMask;			/*!< ADCs calibrated, ADC_CAL_ADCn bits */
+	uint32_t calCount;			/*!< Calibrations completed since the last cold boot */
+	uint32_t calCycles;			/*!< Duration of the last calibration in core cycles */
+	uint32_t check;				/*!< Checksum of the fields above */
+} ADC_CAL_CTX_T;
+
+/**
+ * @brief	Apply trim and clock to the ADCs and check the cached context
+ * @param	adcMask	: ADCs to set up and calibrate, ADC_CAL_ADCn bits
+ * @param	trim	: ADC_TRIM_VRANGE_HIGHV or ADC_TRIM_VRANGE_LOWV
+ * @param	adcClk	: ADC clock rate restored after every calibration
+ * @return	true on a warm boot with a context matching this setup
+ * @note	Chip_ADC_Init() must have been called for the ADCs. A power-on
+ *			or brown-out reset always counts as a cold boot.
+ */
+bool ADC_Cal_Setup(uint32_t adcMask, uint32_t trim, uint32_t adcClk);
+
+/**
+ * @brief	Start calibrating the ADCs without waiting for the result
+ * @return	Nothing
+ * @note	The sequencers must be disabled until ADC_Cal_Poll() reports
+ *			the end of the calibration.
+ */
+void ADC_Cal_Start(void);
+
+/**
+ * @brief	Finish a calibration started by ADC_Cal_Start()
+ * @return	true once, when the calibration of all ADCs has just completed
+ * @note	Restores the conversion clock and stores the cached context.
+ *			Call from the main loop.
+ */
+bool ADC_Cal_Poll(void);
+
+/**
+ * @brief	Return whether a calibration is in progress
+ * @return	true between ADC_Cal_Start() and its completion
+ */
+bool ADC_Cal_IsBusy(void);
+
+/**
+ * @brief	Return whether the ADCs were calibrated since the last reset
+ * @return	true if a calibration completed since ADC_Cal_Setup()
+ */
+bool ADC_Cal_IsValid(void);
+
+/**
+ * @brief	Return the cached calibration context
+ * @return	Pointer to the context of the last completed calibration
+ * @note	The magic field is 0 until a calibration has completed on a
+ *			cold boot.
+ */
+const ADC_CAL_CTX_T *ADC_Cal_GetContext(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_CAL_H_ */
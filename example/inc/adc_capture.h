@@ -0,0 +1,174 @@
+/*
+ * @brief Pre/post-trigger capture from a circular sample history
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __ADC_CAPTURE_H_
+#define __ADC_CAPTURE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Oscilloscope style capture. Every sample of the stream goes into a
+   circular history in Ram1_16; a trigger freezes the window of samples
+   around it, which is then read out while the history keeps running.
+   Samples are addressed by their index in the stream. */
+
+/** Samples kept in the history, power of 2 */
+#define ADC_CAPTURE_HISTORY         4096
+
+#if (ADC_CAPTURE_HISTORY & (ADC_CAPTURE_HISTORY - 1)) != 0
+#error "ADC_CAPTURE_HISTORY must be a power of 2"
+#endif
+
+/** What fires the trigger */
+typedef enum {
+	ADC_CAPTURE_LEVEL,			/*!< Sample crosses a level */
+	ADC_CAPTURE_SLOPE,			/*!< Step between consecutive samples reaches a value */
+	ADC_CAPTURE_EXTERNAL,		/*!< ADC_Capture_Trigger(), e.g. from a threshold compare event */
+} ADC_CAPTURE_SRC_T;
+
+/** Trigger edge */
+typedef enum {
+	ADC_CAPTURE_RISING = (1 << 0),
+	ADC_CAPTURE_FALLING = (1 << 1),
+	ADC_CAPTURE_BOTH = ADC_CAPTURE_RISING | ADC_CAPTURE_FALLING,
+} ADC_CAPTURE_EDGE_T;
+
+/** Capture state */
+typedef enum {
+	ADC_CAPTURE_IDLE,			/*!< History running, no trigger armed */
+	ADC_CAPTURE_ARMED,			/*!< Waiting for the trigger */
+	ADC_CAPTURE_TRIGGERED,		/*!< Collecting the post-trigger samples */
+	ADC_CAPTURE_READY,			/*!< Window complete, being read out */
+} ADC_CAPTURE_STATE_T;
+
+/** Trigger set up */
+typedef struct {
+	ADC_CAPTURE_SRC_T source;
+	ADC_CAPTURE_EDGE_T edge;
+	int32_t level;				/*!< Level for ADC_CAPTURE_LEVEL, step size for ADC_CAPTURE_SLOPE */
+	uint32_t pre;				/*!< Samples kept before the trigger */
+	uint32_t post;				/*!< Samples kept from the trigger on */
+	bool autoArm;				/*!< Arm again once a window has been read out */
+} ADC_CAPTURE_CFG_T;
+
+/** Counters of the capture */
+typedef struct {
+	uint32_t captures;			/*!< Windows completed */
+	uint32_t lateTriggers;		/*!< Triggers ignored, their pre-trigger samples were gone */
+	uint32_t skipped;			/*!< Samples not stored while a window was protected */
+} ADC_CAPTURE_STATS_T;
+
+/**
+ * @brief	Clear the history and disarm the trigger
+ * @return	Nothing
+ */
+void ADC_Capture_Init(void);
+
+/**
+ * @brief	Arm the trigger
+ * @param	pCfg	: Trigger set up, copied
+ * @return	true on success, false if pre + post exceeds ADC_CAPTURE_HISTORY
+ * @note	Takes a few cycles whatever the window size. A trigger is
+ *			accepted as soon as the history holds its pre-trigger samples,
+ *			which right after a read out is usually at once.
+ */
+bool ADC_Capture_Arm(const ADC_CAPTURE_CFG_T *pCfg);
+
+/**
+ * @brief	Disarm the trigger and drop a window not yet read
+ * @return	Nothing
+ */
+void ADC_Capture_Disarm(void);
+
+/**
+ * @brief	Append samples to the history and look for the trigger
+ * @param	pSamples	: 12-bit samples of the stream
+ * @param	count		: Number of samples
+ * @return	Nothing
+ * @note	Samples that would overwrite a window not yet read out are not
+ *			stored and counted as skipped.
+ */
+void ADC_Capture_Write(const uint16_t *pSamples, uint32_t count);
+
+/**
+ * @brief	Fire an external trigger
+ * @param	index	: Stream index of the triggering sample
+ * @param	edge	: ADC_CAPTURE_RISING or ADC_CAPTURE_FALLING
+ * @return	true if the trigger was taken
+ * @note	Only taken when armed with ADC_CAPTURE_EXTERNAL and a matching
+ *			edge. The index may be ahead of the samples written so far.
+ */
+bool ADC_Capture_Trigger(uint32_t index, ADC_CAPTURE_EDGE_T edge);
+
+/**
+ * @brief	Return the capture state
+ * @return	ADC_CAPTURE_STATE_T
+ */
+ADC_CAPTURE_STATE_T ADC_Capture_GetState(void);
+
+/**
+ * @brief	Return the stream index of the last trigger
+ * @return	Index of the triggering sample
+ */
+uint32_t ADC_Capture_GetTriggerIndex(void);
+
+/**
+ * @brief	Read the next samples of a completed window
+ * @param	pDest	: Where to copy the samples
+ * @param	max		: Most samples to copy
+ * @return	Samples copied, 0 when no window is ready
+ * @note	The window is released after its last sample has been read,
+ *			the trigger is armed again if autoArm was set.
+ */
+uint32_t ADC_Capture_Read(uint16_t *pDest, uint32_t max);
+
+/**
+ * @brief	Return the counters of the capture
+ * @return	Pointer to the counters
+ */
+const ADC_CAPTURE_STATS_T *ADC_Capture_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_CAPTURE_H_ */
@@ -0,0 +1,143 @@
+/*
+ * @brief Low latency control channels on ADC1 sequencer B
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __ADC_CTRL_H_
+#define __ADC_CTRL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Low latency control channels. Sequencer B of ADC1 converts a few
+   channels on every edge of its own SCT1 trigger and preempts sequence A:
+   the conversion of A in progress is aborted and redone after B, so a B
+   trigger never waits for the streaming channels. The latency from the
+   trigger edge to the sequence B interrupt is measured on every pass. */
+
+/** SCT generating the control trigger, independent from the sample clock */
+#define ADC_CTRL_SCT                LPC_SCT1
+
+/** SCT1_OUT8 is internally connected to ADC1 trigger input 4 */
+#define ADC_CTRL_SCT_OUT            8
+#define ADC1_SEQ_CTRL_HWTRIG_CTRL   ADC1_SEQ_CTRL_HWTRIG_SCT1_OUT8
+
+/** ADC channels per converter */
+#define ADC_CTRL_ADC_CHANNELS       12
+
+/**
+ * Control loop hook, called from the sequence B interrupt
+ * @param	pValues	: 12-bit results indexed by channel number
+ * @param	chans	: Channels converted in this pass
+ */
+typedef void (*ADC_CTRL_HANDLER_T)(const uint16_t *pValues, uint32_t chans);
+
+/** Latency counters, in system clock cycles */
+typedef struct {
+	uint32_t count;				/*!< Sequences completed */
+	uint32_t overruns;			/*!< Results overwritten, a whole trigger period was missed */
+	uint32_t latencyLast;		/*!< Trigger edge to interrupt handler, last pass */
+	uint32_t latencyMin;
+	uint32_t latencyMax;		/*!< Worst case since the last reset */
+	uint64_t latencySum;
+} ADC_CTRL_STATS_T;
+
+/**
+ * @brief	Set up sequencer B of ADC1 and the control trigger
+ * @param	chans	: ADC1 channel mask (ADC_SEQ_CTRL_CHANSEL), not converted by sequence A
+ * @param	rateHz	: Trigger rate
+ * @param	handler	: Control loop hook, or NULL
+ * @return	Programmed trigger rate, 0 on a bad channel mask
+ * @note	The ADC1_SEQB interrupt gets the highest priority, the other
+ *			interrupts of the application must be set below it for the
+ *			latency to stay bounded. ADC1B_IRQHandler must call
+ *			ADC_Ctrl_SeqHandler().
+ */
+uint32_t ADC_Ctrl_Init(uint32_t chans, uint32_t rateHz, ADC_CTRL_HANDLER_T handler);
+
+/**
+ * @brief	Let sequence B preempt sequence A and start the control trigger
+ * @return	Nothing
+ * @note	Call after sequence A of ADC1 has been set up, setting it up
+ *			again clears the preemption.
+ */
+void ADC_Ctrl_Start(void);
+
+/**
+ * @brief	Stop the control trigger
+ * @return	Nothing
+ * @note	Returns once the sequence in progress has completed.
+ */
+void ADC_Ctrl_Stop(void);
+
+/**
+ * @brief	Read the results of a control sequence and time it
+ * @return	Nothing
+ * @note	Call first thing from the ADC1_SEQB interrupt handler.
+ */
+void ADC_Ctrl_SeqHandler(void);
+
+/**
+ * @brief	Copy the latency counters
+ * @param	pStats	: Where to copy the counters
+ * @return	Nothing
+ * @note	Lock free, the copy is taken again if a pass completed meanwhile.
+ */
+void ADC_Ctrl_GetStats(ADC_CTRL_STATS_T *pStats);
+
+/**
+ * @brief	Clear the latency counters
+ * @return	Nothing
+ * @note	Applied by the next pass of the interrupt handler.
+ */
+void ADC_Ctrl_ResetStats(void);
+
+/**
+ * @brief	Return the latest result of a control channel
+ * @param	ch	: ADC1 channel
+ * @return	12-bit result
+ */
+uint16_t ADC_Ctrl_GetValue(uint32_t ch);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_CTRL_H_ */
@@ -0,0 +1,124 @@
+/*
+ * @brief CIC oversampling and decimation of ADC samples
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __ADC_DECIM_H_
+#define __ADC_DECIM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* This module has no chip dependencies and also builds on the host. */
+
+/** Oversampling ratio limits, the ratio must be a power of 2 */
+#define ADC_DECIM_MIN_RATIO         2
+#define ADC_DECIM_MAX_RATIO         256
+
+/** Mid scale of the 12-bit input, removed before integration */
+#define ADC_DECIM_INPUT_MID         2048
+
+/**
+ * CIC compensation FIR tap, [-a, 1 + 2a, -a]. a = 0.117 lifts the passband
+ * droop of the 2nd order CIC to within 0.15 dB up to a quarter of the
+ * output rate.
+ */
+#define ADC_DECIM_COMP_ALPHA        0.117
+
+/**
+ * Decimator state: 2nd order CIC (sinc^2) followed by a 3-tap droop
+ * compensation FIR at the output rate. The integrators use 32-bit
+ * wrap-around arithmetic, which holds 12 + 2 * 8 bits of growth.
+ */
+typedef struct {
+	uint32_t log2Ratio;			/*!< log2 of the oversampling ratio */
+	uint32_t left;				/*!< Input samples until the next output */
+	uint32_t integ[2];			/*!< Integrator state */
+	uint32_t comb[2];			/*!< Comb delay state */
+	int32_t hist[2];			/*!< Compensation FIR history */
+} ADC_DECIM_T;
+
+/**
+ * @brief	Initialize a decimator
+ * @param	pDec	: Decimator to initialize
+ * @param	ratio	: Oversampling ratio, power of 2 from ADC_DECIM_MIN_RATIO to ADC_DECIM_MAX_RATIO
+ * @return	true on success, false if the ratio is not supported
+ */
+bool ADC_Decim_Init(ADC_DECIM_T *pDec, uint32_t ratio);
+
+/**
+ * @brief	Change the oversampling ratio
+ * @param	pDec	: Decimator to change
+ * @param	ratio	: New oversampling ratio
+ * @return	true on success, false if the ratio is not supported
+ * @note	The filter state is cleared, the first outputs after a change
+ *			are part of the CIC settling time.
+ */
+bool ADC_Decim_SetRatio(ADC_DECIM_T *pDec, uint32_t ratio);
+
+/**
+ * @brief	Return the current oversampling ratio
+ * @param	pDec	: Decimator
+ * @return	Oversampling ratio
+ */
+static inline uint32_t ADC_Decim_GetRatio(const ADC_DECIM_T *pDec)
+{
+	return 1UL << pDec->log2Ratio;
+}
+
+/**
+ * @brief	Decimate a block of 12-bit samples
+ * @param	pDec	: Decimator
+ * @param	pIn		: 12-bit unsigned input samples at the ADC rate
+ * @param	count	: Number of input samples
+ * @param	pOut	: Output samples, room for count / ratio + 1 values
+ * @return	Number of output samples written
+ * @note	Outputs are signed 16-bit, with 0 at ADC mid scale and +/-32768
+ *			at the ends of the ADC range. Each output carries
+ *			12 + log2(ratio) / 2 bits of resolution for white input noise.
+ */
+uint32_t ADC_Decim_Process(ADC_DECIM_T *pDec, const uint16_t *pIn, uint32_t count, int16_t *pOut);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_DECIM_H_ */
@@ -0,0 +1,145 @@
+/*
+ * @brief DMA ping-pong capture of ADC sequencer results
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+#include "adc_time.h"
+
+#ifndef __ADC_DMA_H_
+#define __ADC_DMA_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/** Samples per capture block. A DMA descriptor moves at most 1024 words. */
+#ifndef ADC_DMA_BLOCK_SAMPLES
+#define ADC_DMA_BLOCK_SAMPLES       256
+#endif
+
+#if (ADC_DMA_BLOCK_SAMPLES < 1) || (ADC_DMA_BLOCK_SAMPLES > 1024)
+#error "ADC_DMA_BLOCK_SAMPLES must be between 1 and 1024"
+#endif
+
+/** Maximum number of ADC sequencers captured by DMA at the same time */
+#define ADC_DMA_MAX_STREAMS         2
+
+/**
+ * DMA capture stream of one ADC sequencer into two alternating blocks.
+ * Blocks hold the raw SEQ_GDAT words, use the ADC_DR_* macros to decode them.
+ */
+typedef struct {
+	LPC_ADC_T *pADC;			/*!< ADC being captured */
+	ADC_SEQ_IDX_T seqIndex;		/*!< Sequencer being captured */
+	DMA_CHID_T dmaCh;			/*!< DMA channel moving the results */
+	volatile uint32_t doneCount;	/*!< Blocks completed by the DMA */
+	uint32_t readCount;			/*!< Blocks consumed by the application */
+	uint32_t lostCount;			/*!< Blocks overwritten before being consumed */
+	uint32_t block[2][ADC_DMA_BLOCK_SAMPLES];	/*!< Ping-pong sample blocks */
+	ADC_TIME_MARK_T mark[2];	/*!< Time reference latched when each block completed */
+} ADC_DMA_STREAM_T;
+
+/**
+ * @brief	Initialize the DMA controller for ADC capture
+ * @return	Nothing
+ */
+void ADC_DMA_Init(void);
+
+/**
+ * @brief	Start capturing an ADC sequencer into a stream
+ * @param	pStream		: Stream to start
+ * @param	pADC		: ADC to capture (LPC_ADC0 or LPC_ADC1)
+ * @param	seqIndex	: Sequencer to capture
+ * @param	dmaCh		: DMA channel to use
+ * @return	true on success, false if all stream slots are in use
+ * @note	The sequencer must run in end-of-conversion mode (no
+ *			ADC_SEQ_CTRL_MODE_EOS) with its sequence interrupt enabled in
+ *			INTEN, but with its NVIC interrupt disabled. Each conversion then
+ *			raises one DMA request and the DMA read of SEQ_GDAT clears it.
+ */
+bool ADC_DMA_Start(ADC_DMA_STREAM_T *pStream, LPC_ADC_T *pADC, ADC_SEQ_IDX_T seqIndex, DMA_CHID_T dmaCh);
+
+/**
+ * @brief	Stop a capture stream
+ * @param	pStream	: Stream to stop
+ * @return	Nothing
+ */
+void ADC_DMA_Stop(ADC_DMA_STREAM_T *pStream);
+
+/**
+ * @brief	Return the oldest completed block of a stream
+ * @param	pStream	: Stream to check
+ * @return	Pointer to ADC_DMA_BLOCK_SAMPLES raw samples, or NULL if no block is ready
+ * @note	The block stays valid until ADC_DMA_ReleaseBlock() is called and
+ *			for at most one more block time. If the application falls further
+ *			behind, the oldest blocks are skipped and counted in lostCount.
+ */
+const uint32_t *ADC_DMA_GetBlock(ADC_DMA_STREAM_T *pStream);
+
+/**
+ * @brief	Give back the block returned by ADC_DMA_GetBlock()
+ * @param	pStream	: Stream the block belongs to
+ * @return	Nothing
+ */
+void ADC_DMA_ReleaseBlock(ADC_DMA_STREAM_T *pStream);
+
+/**
+ * @brief	Return the time reference of the block returned by ADC_DMA_GetBlock()
+ * @param	pStream	: Stream the block belongs to
+ * @return	Reference latched by the DMA interrupt when the block completed
+ * @note	The cycle count is that of the latest phase 0 trigger edge, see
+ *			ADC_Trig_GetEdgeCycles(); for a stream triggered at another
+ *			phase only the start of frame part is meaningful. Valid as
+ *			long as the block is.
+ */
+const ADC_TIME_MARK_T *ADC_DMA_GetMark(const ADC_DMA_STREAM_T *pStream);
+
+/**
+ * @brief	Return the index of the latest sample moved by the DMA
+ * @param	pStream	: Stream to check
+ * @return	Number of samples captured since ADC_DMA_Start(), minus one
+ * @note	Can be called from an interrupt, a completed block whose DMA
+ *			interrupt is still pending is accounted for.
+ */
+uint32_t ADC_DMA_GetSampleIndex(const ADC_DMA_STREAM_T *pStream);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_DMA_H_ */
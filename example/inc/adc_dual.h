@@ -0,0 +1,156 @@
+/*
+ * @brief Dual ADC0/ADC1 sampling from a common SCT trigger
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+#include "adc_dma.h"
+
+#ifndef __ADC_DUAL_H_
+#define __ADC_DUAL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/** Unity gain for ADC_DUAL_MATCH_T.gain */
+#define ADC_DUAL_GAIN_ONE           (1 << 15)
+
+/** Samples in one merged block, one block from each converter */
+#define ADC_DUAL_BLOCK_SAMPLES      (2 * ADC_DMA_BLOCK_SAMPLES)
+
+/** Converter index used by the match functions */
+typedef enum {
+	ADC_DUAL_ADC0 = 0,
+	ADC_DUAL_ADC1 = 1,
+} ADC_DUAL_CONV_T;
+
+/** One simultaneously sampled channel pair */
+typedef struct {
+	uint8_t adc0Ch;				/*!< ADC0 channel */
+	uint8_t adc1Ch;				/*!< ADC1 channel */
+} ADC_DUAL_PAIR_T;
+
+/**
+ * Offset and gain correction of one converter:
+ * corrected = (result - offset) * gain / ADC_DUAL_GAIN_ONE
+ */
+typedef struct {
+	int32_t offset;				/*!< Offset in LSB, subtracted first */
+	int32_t gain;				/*!< Gain in Q15 (ADC_DUAL_GAIN_ONE = 1.0) */
+} ADC_DUAL_MATCH_T;
+
+/**
+ * @brief	Start ADC0 and ADC1 sequencer A from a common SCT period
+ * @param	adc0Chans	: ADC0 channel mask (ADC_SEQ_CTRL_CHANSEL)
+ * @param	adc1Chans	: ADC1 channel mask (ADC_SEQ_CTRL_CHANSEL)
+ * @param	adc0Phase	: ADC0 trigger phase relative to ADC1 (ADC_TRIG_PHASE_*)
+ * @param	rateHz		: Trigger rate of each converter
+ * @return	Trigger rate actually programmed in Hz
+ * @note	Both ADCs must be initialized, clocked and calibrated. The SCT
+ *			trigger (ADC_Trig_Init) and DMA (ADC_DMA_Init) must be initialized
+ *			and the SCT must still be stopped. Both masks must select the same
+ *			number of channels.
+ */
+uint32_t ADC_Dual_Start(uint32_t adc0Chans, uint32_t adc1Chans, uint16_t adc0Phase, uint32_t rateHz);
+
+/**
+ * @brief	Build the sequencer channel masks for a list of channel pairs
+ * @param	pPairs		: Channel pairs
+ * @param	count		: Number of pairs
+ * @param	pAdc0Chans	: Filled with the ADC0 channel mask
+ * @param	pAdc1Chans	: Filled with the ADC1 channel mask
+ * @return	true if the list can be sampled as pairs, false otherwise
+ * @note	Each sequencer converts its channels from lowest to highest, in
+ *			lock step with the other converter. The list is only valid when
+ *			both the ADC0 and the ADC1 channels are strictly ascending and
+ *			ADC_DMA_BLOCK_SAMPLES is a multiple of the pair count, so that
+ *			entry n of the list is always converted in step n of a sequence.
+ */
+bool ADC_Dual_PairMasks(const ADC_DUAL_PAIR_T *pPairs, uint32_t count,
+						uint32_t *pAdc0Chans, uint32_t *pAdc1Chans);
+
+/**
+ * @brief	Return the next merged block
+ * @return	Pointer to ADC_DUAL_BLOCK_SAMPLES corrected 12-bit samples, or NULL
+ * @note	Samples alternate ADC1, ADC0, ADC1, ... in trigger order. With a
+ *			180 degree ADC0 phase this is one stream at twice the rate of each
+ *			converter. With a 0 degree phase every ADC1/ADC0 couple is one
+ *			simultaneously sampled pair, pairs following the order of the
+ *			pair list. The block stays valid until the next call.
+ */
+const uint16_t *ADC_Dual_GetBlock(void);
+
+/**
+ * @brief	Set the offset and gain correction of one converter
+ * @param	conv	: Converter to correct
+ * @param	pMatch	: Correction to apply
+ * @return	Nothing
+ */
+void ADC_Dual_SetMatch(ADC_DUAL_CONV_T conv, const ADC_DUAL_MATCH_T *pMatch);
+
+/**
+ * @brief	Estimate the correction of ADC0 against ADC1
+ * @param	pMatch	: Filled with the correction to apply to ADC0
+ * @return	true if an estimate was made, false if the input was too quiet
+ * @note	Both converters must be sampling the same signal. The estimate
+ *			uses the raw results of the last merged block, so call it right
+ *			after ADC_Dual_GetBlock(). The signal should span a good part of
+ *			the input range for the gain estimate to be meaningful.
+ */
+bool ADC_Dual_EstimateMatch(ADC_DUAL_MATCH_T *pMatch);
+
+/**
+ * @brief	Return the time reference of the last merged block
+ * @return	Reference of the ADC1 block, in ADC1 conversions
+ * @note	ADC1 is triggered at phase 0, so its conversion index counts
+ *			the trigger edges. Valid until the next ADC_Dual_GetBlock().
+ */
+const ADC_TIME_MARK_T *ADC_Dual_GetMark(void);
+
+/**
+ * @brief	Return the index of the latest conversion of one converter
+ * @param	conv	: Converter
+ * @return	Conversions captured by the converter since ADC_Dual_Start(), minus one
+ */
+uint32_t ADC_Dual_GetSampleIndex(ADC_DUAL_CONV_T conv);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_DUAL_H_ */
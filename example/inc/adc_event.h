@@ -0,0 +1,122 @@
+/*
+ * @brief ADC threshold crossing events
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __ADC_EVENT_H_
+#define __ADC_EVENT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/** Event records buffered between the compare interrupt and the host link, power of 2.
+	Events dropped on a full queue are counted in g_diag.eventsLost. */
+#define ADC_EVENT_QUEUE_LEN         32
+
+#if (ADC_EVENT_QUEUE_LEN & (ADC_EVENT_QUEUE_LEN - 1)) != 0
+#error "ADC_EVENT_QUEUE_LEN must be a power of 2"
+#endif
+
+/** Direction of a threshold crossing */
+typedef enum {
+	ADC_EVENT_DOWN = 0,			/*!< Result went below the low threshold */
+	ADC_EVENT_UP = 1,			/*!< Result went above the high threshold */
+} ADC_EVENT_DIR_T;
+
+/** One threshold crossing reported by the ADC compare logic */
+typedef struct {
+	uint32_t timestamp;			/*!< Core cycle counter when the interrupt was taken */
+	uint32_t sampleIndex;		/*!< Index of the crossing conversion in the converter stream */
+	uint16_t value;				/*!< 12-bit result that crossed the threshold */
+	uint8_t adcNum;				/*!< 0 for ADC0, 1 for ADC1 */
+	uint8_t channel;			/*!< ADC channel */
+	uint8_t dir;				/*!< ADC_EVENT_DIR_T */
+} ADC_EVENT_T;
+
+/**
+ * @brief	Enable threshold crossing events on ADC channels
+ * @param	pADC		: ADC to monitor (LPC_ADC0 or LPC_ADC1)
+ * @param	chanMask	: Channels to monitor, ADC_SEQ_CTRL_CHANSEL() bits
+ * @param	low			: Low threshold, 12-bit
+ * @param	high		: High threshold, 12-bit
+ * @return	Nothing
+ * @note	The channels use threshold pair 0 and interrupt on crossings
+ *			only. The compare interrupt of the ADC is enabled in the NVIC,
+ *			its handler must call ADC_Event_Capture().
+ */
+void ADC_Event_Init(LPC_ADC_T *pADC, uint32_t chanMask, uint16_t low, uint16_t high);
+
+/**
+ * @brief	Change the thresholds of the monitored channels
+ * @param	pADC	: ADC being monitored
+ * @param	low		: Low threshold, 12-bit
+ * @param	high	: High threshold, 12-bit
+ * @return	Nothing
+ */
+void ADC_Event_SetThresholds(LPC_ADC_T *pADC, uint16_t low, uint16_t high);
+
+/**
+ * @brief	Queue the pending threshold events of an ADC
+ * @param	pADC		: ADC that raised the compare interrupt
+ * @param	sampleIndex	: Index of the latest conversion of the ADC stream
+ * @return	Nothing
+ * @note	Call from the ADCn_THCMP interrupt handler.
+ */
+void ADC_Event_Capture(LPC_ADC_T *pADC, uint32_t sampleIndex);
+
+/**
+ * @brief	Take the oldest queued event
+ * @param	pEvent	: Where to copy the event
+ * @return	true if an event was returned, false if the queue is empty
+ */
+bool ADC_Event_Get(ADC_EVENT_T *pEvent);
+
+/**
+ * @brief	Look at the oldest queued event without taking it
+ * @param	pEvent	: Where to copy the event
+ * @return	true if an event was returned, false if the queue is empty
+ */
+bool ADC_Event_Peek(ADC_EVENT_T *pEvent);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_EVENT_H_ */
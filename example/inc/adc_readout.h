@@ -0,0 +1,149 @@
+/*
+ * @brief Channel mask driven ADC result readout
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+#include "adc_dma.h"
+
+#ifndef __ADC_READOUT_H_
+#define __ADC_READOUT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Result readout driven by a sequencer channel mask. The enabled channels
+   get consecutive slots in ascending channel order, and the results are
+   stored as one array per slot (structure of arrays). The per-sample work
+   has no branches and only touches the enabled channels. */
+
+/** ADC input channels */
+#define ADC_READOUT_CHANNELS        12
+
+/** Largest raw block accepted by ADC_Readout_Block() */
+#ifndef ADC_READOUT_BLOCK_WORDS
+#define ADC_READOUT_BLOCK_WORDS     ADC_DMA_BLOCK_SAMPLES
+#endif
+
+/** Values of the 4-bit CHANNEL field of a result word */
+#define ADC_READOUT_TAGS            16
+
+/** Slot storage: every slot holds up to ceil(words / channels) + 1 samples,
+	plus one word absorbing results of channels outside the mask */
+#define ADC_READOUT_SOA_WORDS       (ADC_READOUT_BLOCK_WORDS + (2 * ADC_READOUT_CHANNELS) + 1)
+
+/** Readout plan built from a channel mask */
+typedef struct {
+	uint32_t chanMask;			/*!< Enabled channels, ADC_SEQ_CTRL_CHANSEL() bits */
+	uint32_t numChans;			/*!< Number of enabled channels */
+	uint32_t stride;			/*!< Samples reserved per slot */
+	uint8_t chans[ADC_READOUT_CHANNELS];	/*!< Channel of each slot */
+	uint16_t offset[ADC_READOUT_TAGS];		/*!< Start of the slot of each channel in the block */
+	uint8_t step[ADC_READOUT_TAGS];			/*!< 1 for enabled channels, 0 for the discard word */
+} ADC_READOUT_T;
+
+/** Structure of arrays sample block, one array of 12-bit results per slot */
+typedef struct {
+	uint16_t len[ADC_READOUT_CHANNELS];		/*!< Samples in each slot */
+	uint16_t data[ADC_READOUT_SOA_WORDS];	/*!< Slot s starts at data[s * stride] */
+} ADC_SOA_BLOCK_T;
+
+/**
+ * @brief	Build the readout plan of a channel mask
+ * @param	pR			: Readout plan
+ * @param	chanMask	: Enabled channels, ADC_SEQ_CTRL_CHANSEL() bits
+ * @param	blockWords	: Raw words per block given to ADC_Readout_Block(), up to ADC_READOUT_BLOCK_WORDS
+ * @return	Number of enabled channels
+ */
+uint32_t ADC_Readout_Init(ADC_READOUT_T *pR, uint32_t chanMask, uint32_t blockWords);
+
+/**
+ * @brief	Read the data registers of the enabled channels
+ * @param	pR		: Readout plan
+ * @param	pADC	: ADC to read
+ * @param	pOut	: Result of each slot, numChans entries
+ * @param	pValid	: Slots holding a new result, bit per slot
+ * @param	pOvr	: Slots that overran, bit per slot
+ * @return	Nothing
+ * @note	Reading a data register clears its valid and overrun flags.
+ */
+void ADC_Readout_Regs(const ADC_READOUT_T *pR, LPC_ADC_T *pADC, uint16_t *pOut,
+					  uint32_t *pValid, uint32_t *pOvr);
+
+/**
+ * @brief	Sort a block of raw sequence results into slots
+ * @param	pR		: Readout plan
+ * @param	pRaw	: Raw SEQ_GDAT words, in conversion order
+ * @param	count	: Number of words, up to the blockWords given to ADC_Readout_Init()
+ * @param	pBlock	: Output block, slot lengths are set in pBlock->len
+ * @return	Nothing
+ * @note	Words are placed by their CHANNEL field, so a block may start
+ *			anywhere in the sequence.
+ */
+void ADC_Readout_Block(const ADC_READOUT_T *pR, const uint32_t *pRaw, uint32_t count,
+					   ADC_SOA_BLOCK_T *pBlock);
+
+/**
+ * @brief	Return the sample array of one slot
+ * @param	pR		: Readout plan
+ * @param	pBlock	: Block filled by ADC_Readout_Block()
+ * @param	slot	: Slot number, 0 .. numChans - 1
+ * @return	Pointer to pBlock->len[slot] samples
+ */
+STATIC INLINE const uint16_t *ADC_Readout_Slot(const ADC_READOUT_T *pR, const ADC_SOA_BLOCK_T *pBlock,
+											   uint32_t slot)
+{
+	return &pBlock->data[slot * pR->stride];
+}
+
+/**
+ * @brief	Return the slot of an enabled channel
+ * @param	pR	: Readout plan
+ * @param	ch	: Channel, must be in the mask
+ * @return	Slot number
+ */
+STATIC INLINE uint32_t ADC_Readout_SlotOf(const ADC_READOUT_T *pR, uint32_t ch)
+{
+	return pR->offset[ch] / pR->stride;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_READOUT_H_ */
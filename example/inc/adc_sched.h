@@ -0,0 +1,137 @@
+/*
+ * @brief Multi-rate scheduler for slow ADC channels
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __ADC_SCHED_H_
+#define __ADC_SCHED_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Multi-rate sampling of slow channels. Sequencer A of ADC1 keeps the
+   fast group; the slow channels of each ADC form a group converted by
+   sequencer B of that ADC. Each group is paced by its own MRT channel
+   at the rate of its fastest channel, and a tick only converts the
+   channels that are due. */
+
+/** Slow channels handled by the scheduler */
+#define ADC_SCHED_MAX_CHANNELS      8
+
+/** Records buffered between the sequence interrupts and the main loop, power of 2.
+	Records dropped on a full queue are counted in g_diag.schedRecordsLost. */
+#define ADC_SCHED_QUEUE_LEN         32
+
+#if (ADC_SCHED_QUEUE_LEN & (ADC_SCHED_QUEUE_LEN - 1)) != 0
+#error "ADC_SCHED_QUEUE_LEN must be a power of 2"
+#endif
+
+/** MRT channel pacing the slow group of ADCn */
+#define ADC_SCHED_MRT_CH(adcNum)    (adcNum)
+
+/** Slowest group tick, the 24-bit MRT cannot count longer periods */
+#define ADC_SCHED_MIN_TICK_HZ       10
+
+/** One slow channel */
+typedef struct {
+	uint8_t adcNum;				/*!< 0 for ADC0, 1 for ADC1 */
+	uint8_t channel;			/*!< ADC channel, must not be converted by sequencer A */
+	uint16_t rateHz;			/*!< Sample rate, rounded to the group tick divided by an integer */
+} ADC_SCHED_CHAN_T;
+
+/** One conversion result of a slow channel */
+typedef struct {
+	uint32_t timestamp;			/*!< Core cycle counter when the conversion was started */
+	uint16_t value;				/*!< 12-bit result */
+	uint8_t adcNum;				/*!< 0 for ADC0, 1 for ADC1 */
+	uint8_t channel;			/*!< ADC channel */
+} ADC_SCHED_REC_T;
+
+/**
+ * @brief	Set up the slow channel groups
+ * @param	pChans	: Slow channels, at most ADC_SCHED_MAX_CHANNELS
+ * @param	count	: Number of channels
+ * @return	true on success, false on a bad channel list
+ * @note	Sequencer B of every ADC with slow channels is set up for a
+ *			software start and its interrupt enabled in the NVIC. The
+ *			ADCn_SEQB interrupt handlers must call ADC_Sched_SeqHandler().
+ */
+bool ADC_Sched_Init(const ADC_SCHED_CHAN_T *pChans, uint32_t count);
+
+/**
+ * @brief	Start the group timers
+ * @return	Nothing
+ */
+void ADC_Sched_Start(void);
+
+/**
+ * @brief	Stop the group timers
+ * @return	Nothing
+ * @note	Returns once the sequences in progress have completed.
+ */
+void ADC_Sched_Stop(void);
+
+/**
+ * @brief	Queue the results of a completed slow group sequence
+ * @param	pADC	: ADC that raised the sequence B interrupt
+ * @return	Nothing
+ * @note	Call from the ADCn_SEQB interrupt handler.
+ */
+void ADC_Sched_SeqHandler(LPC_ADC_T *pADC);
+
+/**
+ * @brief	Take the oldest queued record
+ * @param	pRec	: Where to copy the record
+ * @return	true if a record was returned, false if the queue is empty
+ */
+bool ADC_Sched_Get(ADC_SCHED_REC_T *pRec);
+
+/**
+ * @brief	Look at the oldest queued record without taking it
+ * @param	pRec	: Where to copy the record
+ * @return	true if a record was returned, false if the queue is empty
+ */
+bool ADC_Sched_Peek(ADC_SCHED_REC_T *pRec);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_SCHED_H_ */
@@ -0,0 +1,123 @@
+/*
+ * @brief Averaged magnitude spectra of the ADC sample stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+#include "dsp_fft.h"
+
+#ifndef __ADC_SPECTRUM_H_
+#define __ADC_SPECTRUM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Magnitude spectra of the raw sample stream. Samples are windowed as
+   they arrive into a frame buffer in Ram1_16; every full frame is
+   transformed and its bin magnitudes added up until the requested
+   number of frames has been averaged. The averaged spectrum is then held
+   until it has been read, spectra completed meanwhile are dropped. */
+
+/** Most frames averaged into one spectrum */
+#define ADC_SPECTRUM_MAX_AVERAGE    256
+
+/** Magnitudes are sinusoid amplitudes in 1/16 LSB (DC reads twice its level) */
+#define ADC_SPECTRUM_FRAC_BITS      4
+
+/** Spectrum set up */
+typedef struct {
+	uint32_t size;				/*!< FFT size, DSP_FFT_MIN_SIZE to DSP_FFT_MAX_SIZE */
+	DSP_FFT_WINDOW_T window;
+	uint32_t average;			/*!< Frames averaged per spectrum, 1 to ADC_SPECTRUM_MAX_AVERAGE */
+} ADC_SPECTRUM_CFG_T;
+
+/** Counters of the spectrum stage */
+typedef struct {
+	uint32_t frames;			/*!< Frames transformed */
+	uint32_t spectra;			/*!< Averaged spectra completed */
+	uint32_t dropped;			/*!< Spectra dropped, the previous one was still being read */
+	uint32_t cyclesLast;		/*!< Windowing, FFT and magnitudes of the last frame */
+	uint32_t cyclesMax;			/*!< Worst frame since the last configuration */
+} ADC_SPECTRUM_STATS_T;
+
+/**
+ * @brief	Set up the frame size, window and averaging
+ * @param	pCfg	: Spectrum set up, copied
+ * @return	true on success, false on a bad size or average count
+ * @note	Restarts the frame and the averaging, drops a spectrum not yet read.
+ */
+bool ADC_Spectrum_Config(const ADC_SPECTRUM_CFG_T *pCfg);
+
+/**
+ * @brief	Return the spectrum set up
+ * @return	Pointer to the set up
+ */
+const ADC_SPECTRUM_CFG_T *ADC_Spectrum_GetConfig(void);
+
+/**
+ * @brief	Window samples into the frame, transform every full frame
+ * @param	pSamples	: 12-bit samples of the stream
+ * @param	count		: Number of samples
+ * @return	Nothing
+ */
+void ADC_Spectrum_Write(const uint16_t *pSamples, uint32_t count);
+
+/**
+ * @brief	Return the averaged spectrum waiting to be read
+ * @param	pSeq	: Where to store the spectrum number, may be NULL
+ * @return	size / 2 magnitudes from DC up, NULL if none is waiting
+ */
+const uint16_t *ADC_Spectrum_GetBins(uint32_t *pSeq);
+
+/**
+ * @brief	Release the spectrum returned by ADC_Spectrum_GetBins()
+ * @return	Nothing
+ */
+void ADC_Spectrum_Release(void);
+
+/**
+ * @brief	Return the counters of the spectrum stage
+ * @return	Pointer to the counters
+ */
+const ADC_SPECTRUM_STATS_T *ADC_Spectrum_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_SPECTRUM_H_ */
@@ -0,0 +1,142 @@
+/*
+ * @brief Windowed min/max/mean/RMS statistics of the ADC sample stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __ADC_SUMMARY_H_
+#define __ADC_SUMMARY_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Windowed statistics of the raw sample stream. Every channel keeps a
+   minimum, a maximum, a sum and a sum of squares over the samples of its
+   current window, all integer and updated in a single pass. A full
+   window is turned into one summary record with the mean and RMS and the
+   accumulators start over. */
+
+/** Channels summarized at once */
+#define ADC_SUMMARY_MAX_CHANNELS    12
+
+/** Longest window in samples per channel */
+#define ADC_SUMMARY_MAX_WINDOW      65536
+
+/** Mean and RMS are given in 1/16 LSB */
+#define ADC_SUMMARY_FRAC_BITS       4
+
+/** Records buffered for the main loop, power of 2.
+	Records dropped on a full queue are counted in g_diag.summaryRecordsLost. */
+#define ADC_SUMMARY_QUEUE_LEN       16
+
+#if (ADC_SUMMARY_QUEUE_LEN & (ADC_SUMMARY_QUEUE_LEN - 1)) != 0
+#error "ADC_SUMMARY_QUEUE_LEN must be a power of 2"
+#endif
+
+/** One summarized channel */
+typedef struct {
+	uint8_t adcNum;				/*!< 0 for ADC0, 1 for ADC1 */
+	uint8_t channel;			/*!< ADC channel */
+} ADC_SUMMARY_CHAN_T;
+
+/** Statistics of one window of one channel */
+typedef struct {
+	uint32_t seq;				/*!< Window number of the channel */
+	uint32_t count;				/*!< Samples in the window */
+	uint16_t min;				/*!< Smallest 12-bit sample */
+	uint16_t max;				/*!< Largest 12-bit sample */
+	uint16_t mean;				/*!< Mean in 1/16 LSB */
+	uint16_t rms;				/*!< Root mean square in 1/16 LSB */
+	uint8_t adcNum;				/*!< 0 for ADC0, 1 for ADC1 */
+	uint8_t channel;			/*!< ADC channel */
+} ADC_SUMMARY_REC_T;
+
+/**
+ * @brief	Set up the summarized channels and the window
+ * @param	pChans		: Channels, at most ADC_SUMMARY_MAX_CHANNELS, copied
+ * @param	numChans	: Number of channels
+ * @param	window		: Samples per channel and window, 1 to ADC_SUMMARY_MAX_WINDOW
+ * @return	true on success, false on a bad channel count or window
+ */
+bool ADC_Summary_Init(const ADC_SUMMARY_CHAN_T *pChans, uint32_t numChans, uint32_t window);
+
+/**
+ * @brief	Change the window length
+ * @param	window	: Samples per channel and window, 1 to ADC_SUMMARY_MAX_WINDOW
+ * @return	true on success, false on a bad window
+ * @note	Every channel starts a new window, partial windows are dropped.
+ */
+bool ADC_Summary_SetWindow(uint32_t window);
+
+/**
+ * @brief	Return the window length
+ * @return	Samples per channel and window
+ */
+uint32_t ADC_Summary_GetWindow(void);
+
+/**
+ * @brief	Add samples of one channel to its window
+ * @param	idx			: Channel index in the list given to ADC_Summary_Init()
+ * @param	pSamples	: First 12-bit sample of the channel
+ * @param	count		: Number of samples of the channel
+ * @param	stride		: Distance between two samples of the channel, 1 for a plain array
+ * @return	Nothing
+ * @note	Queues a record at the end of every window.
+ */
+void ADC_Summary_Write(uint32_t idx, const uint16_t *pSamples, uint32_t count, uint32_t stride);
+
+/**
+ * @brief	Take the oldest queued record
+ * @param	pRec	: Where to copy the record
+ * @return	true if a record was returned, false if the queue is empty
+ */
+bool ADC_Summary_Get(ADC_SUMMARY_REC_T *pRec);
+
+/**
+ * @brief	Look at the oldest queued record without taking it
+ * @param	pRec	: Where to copy the record
+ * @return	true if a record was returned, false if the queue is empty
+ */
+bool ADC_Summary_Peek(ADC_SUMMARY_REC_T *pRec);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_SUMMARY_H_ */
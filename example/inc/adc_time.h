@@ -0,0 +1,93 @@
+/*
+ * @brief Sample time references locked to the USB start of frame
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __ADC_TIME_H_
+#define __ADC_TIME_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Sample time references. When a capture block completes, the latest
+   conversion and the core cycle count at the trigger edge that started
+   it are latched together with the cycle count of the latest USB start
+   of frame. The host knows the frame clock, so the cycle counts tie the
+   samples to it with the resolution of the core clock, and the cycles
+   between start of frames give the drift of the board oscillator. */
+
+/** USB INTSTAT bit of the start of frame interrupt */
+#define ADC_TIME_USB_FRAME_INT      (1UL << 30)
+
+/** Frame number field of the USB INFO register */
+#define ADC_TIME_USB_FRAME_NR       0x7FF
+
+/** Time reference of a capture block */
+typedef struct {
+	uint32_t blockEnd;			/*!< Index of the last conversion of the block */
+	uint32_t index;				/*!< Latest conversion at the reference, at or after blockEnd */
+	uint32_t cycles;			/*!< Cycle count at the trigger edge that started it */
+	uint32_t sofFrame;			/*!< Start of frames counted, the low 11 bits are the frame number */
+	uint32_t sofCycles;			/*!< Cycle count at that start of frame */
+	bool sofValid;				/*!< A start of frame has been seen */
+} ADC_TIME_MARK_T;
+
+/**
+ * @brief	Latch a pending USB start of frame
+ * @return	Nothing
+ * @note	Call first thing in USB_IRQHandler(), before the stack clears
+ *			the interrupt. The start of frame interrupt must be enabled.
+ */
+void ADC_Time_SofIrq(void);
+
+/**
+ * @brief	Return the latest start of frame
+ * @param	pFrame	: Start of frames counted, the low 11 bits are the frame number
+ * @param	pCycles	: Cycle count when its interrupt was taken
+ * @return	true if a start of frame has been seen
+ * @note	Interrupts are enabled on return.
+ */
+bool ADC_Time_GetSof(uint32_t *pFrame, uint32_t *pCycles);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_TIME_H_ */
@@ -0,0 +1,175 @@
+/*
+ * @brief SCT based hardware trigger for the ADC sequencers
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __ADC_TRIG_H_
+#define __ADC_TRIG_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* SCT used as the sample clock. It runs as one 32-bit counter limited by
+   match 0, so every attached output shares the same period. */
+#define ADC_TRIG_SCT                LPC_SCT0
+
+/* SCT0 outputs internally connected to the ADC hardware trigger inputs */
+#define ADC_TRIG_OUT_ADC0           7	/*!< SCT0_OUT7 -> ADC0 trigger input 2 */
+#define ADC_TRIG_OUT_ADC1           6	/*!< SCT0_OUT6 -> ADC1 trigger input 2 */
+
+/* SEQ_CTRL trigger selection matching the outputs above */
+#define ADC0_SEQ_CTRL_HWTRIG_SCT    ADC0_SEQ_CTRL_HWTRIG_SCT0_OUT7
+#define ADC1_SEQ_CTRL_HWTRIG_SCT    ADC1_SEQ_CTRL_HWTRIG_SCT0_OUT6
+
+/** Maximum number of SCT outputs that can be driven as ADC triggers */
+#define ADC_TRIG_MAX_OUTPUTS        2
+
+/** Phase of a trigger output in 1/65536 of the sample period */
+#define ADC_TRIG_PHASE_0            0x0000
+#define ADC_TRIG_PHASE_180          0x8000
+
+/** ADC clocks needed for one 12-bit conversion */
+#define ADC_CLOCKS_PER_CONV         25
+
+/** Slowest sample rate accepted by ADC_Trig_SetRate() */
+#define ADC_TRIG_MIN_RATE_HZ        1
+
+/**
+ * @brief	Initialize the SCT as a free running ADC sample clock
+ * @return	Nothing
+ * @note	The SCT is left halted, call ADC_Trig_Start() once the
+ *			sequencers have been enabled.
+ */
+void ADC_Trig_Init(void);
+
+/**
+ * @brief	Drive an SCT output as an ADC hardware trigger
+ * @param	sctOut	: SCT output number (ADC_TRIG_OUT_ADC0 or ADC_TRIG_OUT_ADC1)
+ * @param	phase	: Rising edge position within the period (ADC_TRIG_PHASE_*)
+ * @return	true on success, false if all trigger slots are in use
+ * @note	The output rises once per period at the given phase and falls
+ *			half a period later. The ADC sequencer must be set up for a
+ *			positive edge (ADC_SEQ_CTRL_HWTRIG_POLPOS).
+ */
+bool ADC_Trig_AttachOutput(uint8_t sctOut, uint16_t phase);
+
+/**
+ * @brief	Set the trigger rate
+ * @param	rateHz		: Requested rate in Hz
+ * @param	convPerTrig	: Conversions started by each trigger (channels in the sequence)
+ * @return	The rate actually programmed in Hz
+ * @note	The rate is clamped between ADC_TRIG_MIN_RATE_HZ and the fastest rate
+ *			the ADC clock can sustain for convPerTrig conversions.
+ */
+uint32_t ADC_Trig_SetRate(uint32_t rateHz, uint32_t convPerTrig);
+
+/**
+ * @brief	Return the trigger rate programmed by ADC_Trig_SetRate()
+ * @return	Trigger rate in Hz
+ */
+uint32_t ADC_Trig_GetRate(void);
+
+/**
+ * @brief	Return the exact period of the rate set by ADC_Trig_SetRate()
+ * @return	Period in 1/65536 SCT clock ticks
+ */
+uint32_t ADC_Trig_GetPeriodFrac(void);
+
+/**
+ * @brief	Trim the period of the running sample clock
+ * @param	period	: Period in 1/65536 SCT clock ticks
+ * @return	Nothing
+ * @note	The counter limit takes whole ticks; the fraction is carried
+ *			from call to call so that the average period over many calls
+ *			is the one requested. Call it regularly from one interrupt
+ *			context, e.g. every USB start of frame, to lock the sample
+ *			clock to another clock. ADC_Trig_GetRate() keeps returning
+ *			the rate set by ADC_Trig_SetRate().
+ */
+void ADC_Trig_SetPeriodFrac(uint32_t period);
+
+/**
+ * @brief	Return the cycle count at the latest phase 0 trigger edge
+ * @param	pCycles	: Core cycle count at the edge
+ * @return	false while the first conversion started by that edge may not
+ *			have been read by the DMA yet
+ * @note	Call with interrupts disabled and read the conversion index
+ *			before enabling them again, retry while false. The latest
+ *			conversion then belongs to the edge returned. When a
+ *			conversion takes the whole period the previous edge is
+ *			returned; while the SCT is stopped, the current cycle count.
+ */
+bool ADC_Trig_GetEdgeCycles(uint32_t *pCycles);
+
+/**
+ * @brief	Return the fastest trigger rate the ADCs can follow
+ * @param	convPerTrig	: Conversions started by each trigger
+ * @return	Rate in Hz
+ */
+uint32_t ADC_Trig_GetMaxRate(uint32_t convPerTrig);
+
+/**
+ * @brief	Start generating triggers
+ * @return	Nothing
+ */
+void ADC_Trig_Start(void);
+
+/**
+ * @brief	Stop generating triggers
+ * @return	Nothing
+ */
+void ADC_Trig_Stop(void);
+
+/**
+ * @brief	Stop generating triggers at a period boundary
+ * @return	Nothing
+ * @note	Every output has triggered the same number of times and the
+ *			sequences started by the last edges have completed on return,
+ *			so the ADCs can be recalibrated and ADC_Trig_Start() resumes
+ *			with the outputs still paired. Interrupts are disabled for a
+ *			few cycles while the counter is halted.
+ */
+void ADC_Trig_Pause(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_TRIG_H_ */
@@ -47,10 +47,56 @@ extern "C"
 /* HID In/Out Endpoint Address */
 #define HID_EP_IN                           0x81
 #define HID_EP_OUT                          0x01
+/* Vendor HID reports of raw samples (hid_stream.c) instead of the rudder
+   report: HID_STREAM_REPORT_SIZE bytes every 1 ms. hid_desc.c and
+   hid_mouse.c take the report descriptor, the IN endpoint size and the
+   report buffer from it. Only used by the HID personality. */
+#define HID_VENDOR_STREAM
+
+#if defined(HID_VENDOR_STREAM)
+/** Interval between mouse reports expressed in milliseconds for full-speed device. */
+#define HID_MOUSE_REPORT_INTERVAL_MS        1
+/* bInterval value used in descriptor. For HS this macro will differ from HID_MOUSE_REPORT_INTERVAL_MS macro. */
+#define HID_MOUSE_REPORT_INTERVAL           1
+#else
 /** Interval between mouse reports expressed in milliseconds for full-speed device. */
 #define HID_MOUSE_REPORT_INTERVAL_MS        10
 /* bInterval value used in descriptor. For HS this macro will differ from HID_MOUSE_REPORT_INTERVAL_MS macro. */
 #define HID_MOUSE_REPORT_INTERVAL           10
+#endif
+
+/* USB personality: CDC virtual COM port carrying the host link. Undefine
+   to enumerate as the HID mouse (hid_desc.c, hid_mouse.c) instead, or
+   replace it with APP_USB_AUDIO for the USB audio microphone
+   (audio_desc.c, usb_audio.c). */
+#define APP_USB_VCOM
+/* #define APP_USB_AUDIO */
+
+#if defined(APP_USB_VCOM) && defined(APP_USB_AUDIO)
+#error "APP_USB_VCOM and APP_USB_AUDIO are alternative personalities"
+#endif
+
+#if !defined(APP_USB_VCOM) && !defined(APP_USB_AUDIO)
+#define APP_USB_HID
+#endif
+
+/* Manifest constants defining interface numbers and endpoints used by the
+   CDC virtual COM port (cdc_desc.c). The HID mouse and the VCOM port are
+   alternative personalities, so they share endpoint 1.
+ */
+#define USB_CDC_CIF_NUM         0
+#define USB_CDC_DIF_NUM         1
+#define USB_CDC_IN_EP           0x81
+#define USB_CDC_OUT_EP          0x01
+#define USB_CDC_INT_EP          0x82
+
+/* Interfaces and endpoint of the USB audio personality (audio_desc.c),
+   endpoint 1 again. The rate must be the one of the ADC stream. */
+#define USB_AUDIO_CIF_NUM       0		/* audio control */
+#define USB_AUDIO_SIF_NUM       1		/* audio streaming */
+#define USB_AUDIO_IN_EP         0x81
+#define USB_AUDIO_RATE_HZ       16000
+#define USB_AUDIO_PACKET_MAX    (((USB_AUDIO_RATE_HZ + 999) / 1000) * 2)	/* 16-bit mono */
 
 /* The following manifest constants are used to define this memory area to be used
    by USBD ROM stack.
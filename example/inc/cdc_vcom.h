@@ -0,0 +1,256 @@
+/*
+ * @brief Programming API used with Virtual Communication port
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#ifndef __CDC_VCOM_H_
+#define __CDC_VCOM_H_
+
+#include "app_usbd_cfg.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+#define VCOM_RX_BUF_SZ      256			/* one OUT transfer, up to 4 packets */
+#define VCOM_RX_BUFS        4			/* RX pool, power of 2 */
+#define VCOM_TX_RING_SZ     2048		/* bytes queued for the IN endpoint, power of 2 */
+#define VCOM_TX_BLOCKS      8			/* blocks queued in place, power of 2 */
+#define VCOM_TX_XFER_MAX    960			/* bytes per IN transfer, packets of a multiple below 1024 */
+#define VCOM_BUF_ALIGN      64			/* endpoint buffers start on a 64-byte boundary, address bits 21:6 */
+#define VCOM_TX_CONNECTED   _BIT(8)		/* connection state is for both RX/Tx */
+#define VCOM_TX_BUSY        _BIT(0)
+#define VCOM_TX_FLUSH       _BIT(1)		/* drop the stale data once the transfer in flight is out */
+
+#define VCOM_RX_BUF_QUEUED  _BIT(2)
+
+/* Backpressure notifications on the interrupt endpoint. SERIAL_STATE
+   carries DCD and DSR while the port is open and an overrun after data
+   was dropped; stock drivers count it (TIOCGICOUNT on Linux). The vendor
+   notification VCOM_NOTIFY_TX_STATE, for readers on libusb, follows the
+   CDC header (0xA1, code, wValue 0, wIndex interface, wLength 8) with:
+	 8	ring bytes queued	16 bits
+	10	fill level			percent of the fuller of the ring and block queue
+	11	blocks queued		8 bits
+	12	drops				32 bits, vcom_tx_drop() calls and cut writes since boot
+   It is sent on drops and when the level crosses a VCOM_NOTIFY_STEP_PCT
+   step. */
+#define VCOM_NOTIFY_BUF_SZ  64			/* notification buffer taken from the stack memory */
+#define VCOM_NOTIFY_STEP_PCT 25			/* TX fill level changes reported in these steps */
+#define VCOM_NOTIFY_TX_STATE 0x7F		/* vendor notification code, outside the CDC PSTN codes */
+#define VCOM_NOTIFY_TX_BYTES 16			/* header and 8 data bytes, one interrupt packet */
+#define VCOM_NOTIFY_SS_BYTES 10			/* SERIAL_STATE: header and the 2-byte bitmap */
+
+/* SERIAL_STATE bitmap */
+#define VCOM_SERIAL_STATE_DCD       _BIT(0)	/* bRxCarrier */
+#define VCOM_SERIAL_STATE_DSR       _BIT(1)	/* bTxCarrier */
+#define VCOM_SERIAL_STATE_OVERRUN   _BIT(6)	/* bOverRun, data was dropped */
+
+#if (VCOM_TX_RING_SZ & (VCOM_TX_RING_SZ - 1)) != 0
+#error "VCOM_TX_RING_SZ must be a power of 2"
+#endif
+
+#if (VCOM_RX_BUFS & (VCOM_RX_BUFS - 1)) != 0
+#error "VCOM_RX_BUFS must be a power of 2"
+#endif
+
+#if (VCOM_TX_BLOCKS & (VCOM_TX_BLOCKS - 1)) != 0
+#error "VCOM_TX_BLOCKS must be a power of 2"
+#endif
+
+#if ((VCOM_TX_XFER_MAX % USB_FS_MAX_BULK_PACKET) != 0) || (VCOM_TX_XFER_MAX > 1023)
+#error "VCOM_TX_XFER_MAX must be whole packets and fit the 10-bit transfer size"
+#endif
+
+#if ((VCOM_RX_BUF_SZ % VCOM_BUF_ALIGN) != 0) || ((VCOM_TX_RING_SZ % VCOM_BUF_ALIGN) != 0)
+#error "VCOM_RX_BUF_SZ and VCOM_TX_RING_SZ must keep the buffers on a VCOM_BUF_ALIGN boundary"
+#endif
+
+/**
+ * Called from the USB interrupt once the last byte of a block is sent
+ */
+typedef void (*VCOM_TX_DONE_T)(uint8_t *pBlock);
+
+/**
+ * Structure containing Virtual Comm port control data
+ */
+typedef struct VCOM_DATA {
+	USBD_HANDLE_T hUsb;
+	USBD_HANDLE_T hCdc;
+	uint8_t *rx_buff;			/* RX pool, VCOM_RX_BUFS buffers used in turn */
+	uint16_t rx_rd_count;		/* bytes of the oldest filled buffer read */
+	volatile uint16_t tx_flags;
+	volatile uint16_t rx_flags;
+	volatile uint32_t rx_head;	/* RX buffers filled, written by the USB interrupt only */
+	volatile uint32_t rx_tail;	/* RX buffers handed back, written by the reader only */
+	volatile uint32_t tx_head;	/* TX ring write index, written by vcom_write() only */
+	volatile uint32_t tx_tail;	/* TX ring read index, written by the USB interrupt only */
+	uint32_t tx_len;			/* bytes on the IN endpoint */
+	uint32_t tx_flush;			/* ring data before this index is dropped with VCOM_TX_FLUSH */
+	volatile uint32_t blk_head;	/* block queue write index, written by vcom_write_block() only */
+	volatile uint32_t blk_tail;	/* block queue read index, written by the USB interrupt only */
+	uint32_t blk_sent;			/* bytes of the oldest block sent */
+	uint32_t blk_flush;			/* blocks before this index are dropped with VCOM_TX_FLUSH */
+	uint8_t *tx_stage;			/* VCOM_BUF_ALIGN bytes, ring data up to the next boundary */
+	uint8_t tx_from_blk;		/* bytes on the IN endpoint come from the oldest block */
+	uint8_t tx_zlp;				/* last transfer ended on a packet boundary */
+	uint32_t tx_xfers;			/* IN transfers completed, zero-length ones included */
+	uint32_t tx_zlps;			/* zero-length packets sent */
+	uint32_t tx_bytes;			/* bytes sent */
+	volatile uint32_t tx_drops;	/* writes cut short or dropped, written by the vcom_write() context only */
+	uint8_t *ntf_buff;			/* notification on the interrupt endpoint */
+	uint8_t ntf_busy;			/* a notification is on the interrupt endpoint */
+	uint8_t ntf_opened;			/* carriers reported since the port was opened */
+	uint8_t ntf_step;			/* fill level step last reported */
+	uint32_t ntf_ss_drops;		/* tx_drops last reported by SERIAL_STATE */
+	uint32_t ntf_tx_drops;		/* tx_drops last reported by VCOM_NOTIFY_TX_STATE */
+	uint32_t ntf_sent;			/* notifications sent */
+} VCOM_DATA_T;
+
+/**
+ * Virtual Comm port control data instance.
+ */
+extern VCOM_DATA_T g_vCOM;
+
+/**
+ * @brief	Virtual com port init routine
+ * @param	hUsb		: Handle to USBD stack instance
+ * @param	pDesc		: Pointer to configuration descriptor
+ * @param	pUsbParam	: Pointer USB param structure returned by previous init call
+ * @return	Always returns LPC_OK.
+ */
+ErrorCode_t vcom_init (USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT_PARAM_T *pUsbParam);
+
+/**
+ * @brief	Bus reset callback, USB_Reset_Event of the init parameters
+ * @param	hUsb	: Handle to USBD stack instance
+ * @return	LPC_OK
+ * @note	Transfers on the endpoints are lost without an event: queued
+ * blocks are handed back, the ring is emptied and the port is closed
+ * until the host sets the line coding again.
+ */
+ErrorCode_t vcom_reset_event(USBD_HANDLE_T hUsb);
+
+/**
+ * @brief	Virtual com port buffered read routine
+ * @param	pBuf	: Pointer to buffer where read data should be copied
+ * @param	buf_len	: Length of the buffer passed
+ * @return	Return number of bytes read.
+ * @note	Copies across as many received buffers as fit in pBuf. Single
+ * reader: call from one context only.
+ */
+uint32_t vcom_bread (uint8_t *pBuf, uint32_t buf_len);
+
+/**
+ * @brief	Look at the oldest received data in place
+ * @param	ppData	: Set to the first unread byte
+ * @return	Unread bytes at *ppData, 0 when nothing was received
+ * @note	More data may follow in the next buffer once these are consumed.
+ */
+uint32_t vcom_rx_peek (uint8_t **ppData);
+
+/**
+ * @brief	Consume bytes returned by vcom_rx_peek()
+ * @param	len		: Number of bytes, up to what vcom_rx_peek() returned
+ * @return	Nothing
+ * @note	A buffer read to its end goes back to the OUT endpoint.
+ */
+void vcom_rx_consume (uint32_t len);
+
+/**
+ * @brief	Check if Vcom is connected
+ * @return	Returns non-zero value if connected.
+ */
+static INLINE uint32_t vcom_connected(void) {
+	return g_vCOM.tx_flags & VCOM_TX_CONNECTED;
+}
+
+/**
+ * @brief	Virtual com port write routine
+ * @param	pBuf	: Pointer to buffer to be written
+ * @param	buf_len	: Length of the buffer passed
+ * @return	Number of bytes queued, less than buf_len when the TX ring is full
+ * @note	Data is copied into the TX ring and sent from the USB interrupt.
+ * Single producer: call from one context only. Never blocks and leaves
+ * USB0_IRQn enabled.
+ */
+uint32_t vcom_write (const uint8_t *pBuf, uint32_t buf_len);
+
+/**
+ * @brief	Queue a block to be sent in place, without a copy
+ * @param	pBlock	: Data to send, must stay untouched until done is called
+ * @param	len		: Number of bytes
+ * @param	done	: Called from the USB interrupt when the block is sent
+ * @return	LPC_OK if queued, ERR_BUSY if the block queue is full or the
+ * port is closed, ERR_FAILED if pBlock is not on a VCOM_BUF_ALIGN
+ * boundary; the caller keeps the block then
+ * @note	The block goes out after everything vcom_write() queued before
+ * it and ahead of what it queues later. Call from the vcom_write() context.
+ */
+ErrorCode_t vcom_write_block(uint8_t *pBlock, uint32_t len, VCOM_TX_DONE_T done);
+
+/**
+ * @brief	Report data the producer dropped for lack of TX room
+ * @return	Nothing
+ * @note	Call from the vcom_write() context once per record, frame or
+ * block given up. The host is told with an overrun in the next
+ * SERIAL_STATE notification and the drop count of VCOM_NOTIFY_TX_STATE.
+ */
+void vcom_tx_drop(void);
+
+/**
+ * @brief	Room left in the TX ring
+ * @return	Bytes vcom_write() can queue now
+ */
+static INLINE uint32_t vcom_tx_free(void) {
+	return VCOM_TX_RING_SZ - (g_vCOM.tx_head - g_vCOM.tx_tail);
+}
+
+/**
+ * @brief	Start sending the TX ring if the IN endpoint is idle
+ * @return	Nothing
+ * @note	Call from USB_IRQHandler() after the stack ISR. vcom_write()
+ * pends USB0_IRQn to get here when no transfer is in flight. Also sends
+ * the pending notification on the interrupt endpoint.
+ */
+void vcom_tx_irq(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CDC_VCOM_H_ */
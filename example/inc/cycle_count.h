@@ -0,0 +1,109 @@
+/*
+ * @brief Core cycle counter helpers for on-target benchmarks
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __CYCLE_COUNT_H_
+#define __CYCLE_COUNT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/** Accumulated cycles of a processing stage */
+typedef struct {
+	uint32_t cycles;			/*!< Cycles spent in the stage */
+	uint32_t samples;			/*!< Input samples processed in those cycles */
+} CYCLE_STAT_T;
+
+/**
+ * @brief	Start the Cortex-M3 DWT cycle counter
+ * @return	Nothing
+ */
+STATIC INLINE void CycleCount_Init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief	Read the core cycle counter
+ * @return	Current cycle count, wraps every 2^32 cycles
+ */
+STATIC INLINE uint32_t CycleCount_Get(void)
+{
+	return DWT->CYCCNT;
+}
+
+/**
+ * @brief	Add one measurement to a stage
+ * @param	pStat	: Stage statistics
+ * @param	start	: CycleCount_Get() value taken before the stage ran
+ * @param	samples	: Input samples processed
+ * @return	Nothing
+ */
+STATIC INLINE void CycleStat_Add(CYCLE_STAT_T *pStat, uint32_t start, uint32_t samples)
+{
+	pStat->cycles += CycleCount_Get() - start;
+	pStat->samples += samples;
+}
+
+/**
+ * @brief	Return the average cost of a stage and restart averaging
+ * @param	pStat	: Stage statistics
+ * @return	Cycles per input sample, in 1/100 cycle
+ */
+STATIC INLINE uint32_t CycleStat_Take(CYCLE_STAT_T *pStat)
+{
+	uint32_t perSample = 0;
+
+	if (pStat->samples) {
+		perSample = (uint32_t) (((uint64_t) pStat->cycles * 100) / pStat->samples);
+	}
+	pStat->cycles = 0;
+	pStat->samples = 0;
+	return perSample;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CYCLE_COUNT_H_ */
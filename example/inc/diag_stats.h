@@ -0,0 +1,126 @@
+/*
+ * @brief Data loss counters of the acquisition pipeline
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+
+#ifndef __DIAG_STATS_H_
+#define __DIAG_STATS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Data loss counters of the acquisition pipeline. Every counter has a
+   single writer (one interrupt or the main loop); a reset from the main
+   loop racing an increment can lose that one count. */
+
+/** ADC channels per converter */
+#define DIAG_ADC_CHANNELS           12
+
+/** Data loss counters and queue high-water marks */
+typedef struct {
+	uint32_t adcChanOvr[2][DIAG_ADC_CHANNELS];	/*!< Channel results overwritten before being read, per ADC */
+	uint32_t adcSeqOvr[2][2];	/*!< Sequence global results overwritten, per ADC and sequencer */
+	uint32_t dmaBlocksLost;		/*!< Capture blocks overwritten before being processed */
+	uint32_t eventsLost;		/*!< Threshold events dropped on a full queue */
+	uint32_t usbTxFull;			/*!< Link_Write() refused on a full CDC TX ring */
+	uint32_t streamDrops;		/*!< Stream samples dropped for lack of TX room */
+	uint32_t dmaBacklogMax;		/*!< Most capture blocks waiting at once */
+	uint32_t eventQueueMax;		/*!< Most threshold events queued at once */
+	uint32_t linkFifoMax;		/*!< Most bytes queued towards the host at once */
+	uint32_t recalPauses;		/*!< Acquisition pauses for a recalibration */
+	uint32_t recalPauseMax;		/*!< Longest recalibration pause in core cycles */
+	uint32_t schedRecordsLost;	/*!< Slow channel results dropped on a full queue */
+	uint32_t schedRetries;		/*!< Slow group starts lost to a busy sequence A and repeated */
+	uint32_t summaryRecordsLost;	/*!< Window summaries dropped on a full queue */
+} DIAG_STATS_T;
+
+/** Counters of the application */
+extern DIAG_STATS_T g_diag;
+
+/**
+ * @brief	Raise a high-water mark
+ * @param	pMax	: High-water mark in g_diag
+ * @param	level	: Current queue level
+ * @return	Nothing
+ */
+STATIC INLINE void Diag_HighWater(uint32_t *pMax, uint32_t level)
+{
+	if (level > *pMax) {
+		*pMax = level;
+	}
+}
+
+/**
+ * @brief	Clear all counters and high-water marks
+ * @return	Nothing
+ */
+void Diag_Reset(void);
+
+/**
+ * @brief	Count the overruns of an ADC from its overrun interrupt
+ * @param	pADC	: ADC to watch (LPC_ADC0 or LPC_ADC1)
+ * @return	Nothing
+ * @note	The ADCn_OVR interrupt handler must call Diag_AdcOverrunHandler().
+ */
+void Diag_EnableAdcOverrun(LPC_ADC_T *pADC);
+
+/**
+ * @brief	Count and clear the pending overruns of an ADC
+ * @param	pADC	: ADC that raised the overrun interrupt
+ * @return	Nothing
+ * @note	A sequence overrun can only be cleared by reading the global
+ *			data register, which belongs to the DMA. The interrupt is then
+ *			masked until Diag_Poll() sees the condition gone, so a lasting
+ *			sequence overrun counts once per main loop pass.
+ */
+void Diag_AdcOverrunHandler(LPC_ADC_T *pADC);
+
+/**
+ * @brief	Re-arm overrun interrupts masked by Diag_AdcOverrunHandler()
+ * @return	Nothing
+ * @note	Call from the main loop.
+ */
+void Diag_Poll(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DIAG_STATS_H_ */
@@ -0,0 +1,126 @@
+/*
+ * @brief Fixed-point FFT of real sample frames
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __DSP_FFT_H_
+#define __DSP_FFT_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Fixed-point FFT of real sample frames. A frame of N real samples is
+   transformed as N/2 complex points with mixed radix-4/radix-2 stages
+   followed by a split into the N/2 bins of the real spectrum. Data is
+   int32 with Q31 twiddles and no scaling between stages, so inputs must
+   leave log2(N) bits of headroom. This module has no chip dependencies
+   and also builds on the host. */
+
+/** Smallest and largest real FFT sizes, powers of 2 */
+#define DSP_FFT_MIN_SIZE            64
+#define DSP_FFT_MAX_SIZE            1024
+
+/** Largest input magnitude that cannot overflow at DSP_FFT_MAX_SIZE */
+#define DSP_FFT_MAX_INPUT           (1 << 20)
+
+/** Window applied to a frame before the transform */
+typedef enum {
+	DSP_FFT_WIN_RECT,			/*!< No window, best resolution, most leakage */
+	DSP_FFT_WIN_HANN,
+	DSP_FFT_WIN_HAMMING,
+	DSP_FFT_WIN_BLACKMAN,		/*!< Lowest leakage, widest main lobe */
+	DSP_FFT_WIN_COUNT
+} DSP_FFT_WINDOW_T;
+
+/**
+ * @brief	Check an FFT size
+ * @param	size	: Real samples per frame
+ * @return	true for a power of 2 from DSP_FFT_MIN_SIZE to DSP_FFT_MAX_SIZE
+ */
+bool DSP_Fft_IsValidSize(uint32_t size);
+
+/**
+ * @brief	Fill a window table
+ * @param	pWin	: Where to store size Q15 weights
+ * @param	size	: Frame size, valid FFT size
+ * @param	type	: Window
+ * @return	Sum of the weights, the coherent gain times size in Q15
+ */
+uint32_t DSP_Fft_Window(int16_t *pWin, uint32_t size, DSP_FFT_WINDOW_T type);
+
+/**
+ * @brief	In-place complex FFT
+ * @param	pData	: points complex values, real and imaginary interleaved
+ * @param	points	: Number of complex points, 32 to DSP_FFT_MAX_SIZE / 2
+ * @return	Nothing
+ * @note	Radix-4 stages with one radix-2 stage when log2(points) is odd.
+ *			The output is in natural order and not scaled.
+ */
+void DSP_Fft_Complex(int32_t *pData, uint32_t points);
+
+/**
+ * @brief	In-place FFT of real samples
+ * @param	pData	: size real samples in, size / 2 complex bins out
+ * @param	size	: Valid FFT size
+ * @return	Nothing
+ * @note	Bin k is at pData[2k] (real) and pData[2k + 1] (imaginary).
+ *			Bin 0 has no imaginary part, the real Nyquist bin is stored
+ *			in its place.
+ */
+void DSP_Fft_Real(int32_t *pData, uint32_t size);
+
+/**
+ * @brief	Add the bin magnitudes of a real FFT to accumulators
+ * @param	pBins	: Output of DSP_Fft_Real()
+ * @param	size	: FFT size
+ * @param	scale	: Factor applied to the magnitudes in Q32
+ * @param	pAcc	: size / 2 accumulators, each gets at most 0xFFFF added
+ * @return	Nothing
+ * @note	Bin 0 is the DC magnitude, the Nyquist bin is left out. Adding
+ *			frame after frame averages the spectra without a frame buffer.
+ */
+void DSP_Fft_AddMagnitude(const int32_t *pBins, uint32_t size, uint32_t scale, uint32_t *pAcc);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_FFT_H_ */
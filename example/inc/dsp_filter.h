@@ -0,0 +1,247 @@
+/*
+ * @brief Fixed-point FIR/IIR filter kernels for the ADC sample stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __DSP_FILTER_H_
+#define __DSP_FILTER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* This module has no chip dependencies and also builds on the host. */
+
+/** Number of taps of the Q15 FIR kernel, odd and symmetric */
+#define DSP_FIR_TAPS                15
+
+/* DSP_LPF_COEF() below is written out for 15 taps */
+#if (DSP_FIR_TAPS != 15)
+#error "DSP_LPF_COEF must be extended to match DSP_FIR_TAPS"
+#endif
+
+/** Samples handled per pass of the FIR kernel, longer blocks are split */
+#ifndef DSP_FILTER_MAX_BLOCK
+#define DSP_FILTER_MAX_BLOCK        256
+#endif
+
+/*
+ * Compile-time coefficient generation. The macros below are arithmetic
+ * constant expressions, so coefficient tables built from them are computed
+ * by the compiler and placed in flash. Sine uses a 15th order Taylor series
+ * after reduction to [-pi, pi], accurate to 1e-6.
+ */
+#define DSP_PI                      3.14159265358979323846
+#define DSP_SIN_R2(r, r2)           ((r) * (1 - (r2) / 6 * (1 - (r2) / 20 * (1 - (r2) / 42 * \
+									(1 - (r2) / 72 * (1 - (r2) / 110 * (1 - (r2) / 156 * \
+									(1 - (r2) / 210))))))))
+#define DSP_SIN_R(r)                DSP_SIN_R2((r), ((r) * (r)))
+#define DSP_WRAP_PI(x)              ((x) - (2 * DSP_PI) * ((long) (((x) / (2 * DSP_PI)) + 1000.5) - 1000))
+#define DSP_SIN(x)                  DSP_SIN_R(DSP_WRAP_PI(x))
+#define DSP_COS(x)                  DSP_SIN((x) + (DSP_PI / 2))
+
+/** Round a constant expression to the nearest integer, also for negative values */
+#define DSP_ROUND(v)                ((long) ((v) + 65536.5) - 65536)
+
+/** Convert a constant to Q30 */
+#define DSP_Q30(v)                  ((int32_t) ((v) * 1073741824.0 + ((v) < 0 ? -0.5 : 0.5)))
+
+/**
+ * Notch biquad coefficients {b0, b1, b2, a1, a2} in Q30 (RBJ cookbook)
+ * @param	fs	: Sample rate in Hz
+ * @param	f0	: Notch frequency in Hz
+ * @param	q	: Quality factor, higher is narrower
+ */
+#define DSP_NOTCH_W0(fs, f0)        (2 * DSP_PI * (double) (f0) / (double) (fs))
+#define DSP_NOTCH_ALPHA(fs, f0, q)  (DSP_SIN(DSP_NOTCH_W0(fs, f0)) / (2.0 * (q)))
+#define DSP_NOTCH_A0(fs, f0, q)     (1.0 + DSP_NOTCH_ALPHA(fs, f0, q))
+#define DSP_NOTCH_COEF(fs, f0, q) { \
+		DSP_Q30(1.0 / DSP_NOTCH_A0(fs, f0, q)), \
+		DSP_Q30(-2.0 * DSP_COS(DSP_NOTCH_W0(fs, f0)) / DSP_NOTCH_A0(fs, f0, q)), \
+		DSP_Q30(1.0 / DSP_NOTCH_A0(fs, f0, q)), \
+		DSP_Q30(-2.0 * DSP_COS(DSP_NOTCH_W0(fs, f0)) / DSP_NOTCH_A0(fs, f0, q)), \
+		DSP_Q30((1.0 - DSP_NOTCH_ALPHA(fs, f0, q)) / DSP_NOTCH_A0(fs, f0, q)) }
+
+/**
+ * DC blocker pole in Q30, y[n] = x[n] - x[n-1] + a * y[n-1]
+ * @param	fs	: Sample rate in Hz
+ * @param	fc	: -3 dB corner in Hz
+ */
+#define DSP_DCBLOCK_COEF(fs, fc)    DSP_Q30(1.0 - (2 * DSP_PI * (double) (fc) / (double) (fs)))
+
+/**
+ * Hamming windowed sinc low-pass, DSP_FIR_TAPS taps in Q15 with unity DC gain
+ * @param	fs	: Sample rate in Hz
+ * @param	fc	: Cut-off frequency in Hz
+ */
+#define DSP_LPF_M                   ((DSP_FIR_TAPS - 1) / 2)
+#define DSP_LPF_RAW(n, fc)          ((((n) == DSP_LPF_M) ? (2 * (fc)) : \
+									  (DSP_SIN(2 * DSP_PI * (fc) * ((n) - DSP_LPF_M)) / \
+									   (DSP_PI * ((n) - DSP_LPF_M)))) * \
+									 (0.54 - 0.46 * DSP_COS(2 * DSP_PI * (n) / (DSP_FIR_TAPS - 1))))
+#define DSP_LPF_SUM(fc)             (DSP_LPF_RAW(0, fc) + DSP_LPF_RAW(1, fc) + DSP_LPF_RAW(2, fc) + \
+									 DSP_LPF_RAW(3, fc) + DSP_LPF_RAW(4, fc) + DSP_LPF_RAW(5, fc) + \
+									 DSP_LPF_RAW(6, fc) + DSP_LPF_RAW(7, fc) + DSP_LPF_RAW(8, fc) + \
+									 DSP_LPF_RAW(9, fc) + DSP_LPF_RAW(10, fc) + DSP_LPF_RAW(11, fc) + \
+									 DSP_LPF_RAW(12, fc) + DSP_LPF_RAW(13, fc) + DSP_LPF_RAW(14, fc))
+#define DSP_LPF_TAP(n, fc)          ((int16_t) DSP_ROUND(DSP_LPF_RAW(n, fc) / DSP_LPF_SUM(fc) * 32768.0))
+#define DSP_LPF_COEF_N(fc)          { \
+		DSP_LPF_TAP(0, fc), DSP_LPF_TAP(1, fc), DSP_LPF_TAP(2, fc), DSP_LPF_TAP(3, fc), \
+		DSP_LPF_TAP(4, fc), DSP_LPF_TAP(5, fc), DSP_LPF_TAP(6, fc), DSP_LPF_TAP(7, fc), \
+		DSP_LPF_TAP(8, fc), DSP_LPF_TAP(9, fc), DSP_LPF_TAP(10, fc), DSP_LPF_TAP(11, fc), \
+		DSP_LPF_TAP(12, fc), DSP_LPF_TAP(13, fc), DSP_LPF_TAP(14, fc) }
+#define DSP_LPF_COEF(fs, fc)        DSP_LPF_COEF_N((double) (fc) / (double) (fs))
+
+/** Biquad coefficients in Q30, y = b0 x0 + b1 x1 + b2 x2 - a1 y1 - a2 y2 */
+typedef struct {
+	int32_t b0, b1, b2, a1, a2;
+} DSP_BIQUAD_COEF_T;
+
+/** Biquad section, Q31 internal state with 64-bit accumulation */
+typedef struct {
+	const DSP_BIQUAD_COEF_T *pCoef;
+	int32_t x1, x2;				/*!< Input history (Q15) */
+	int32_t y1, y2;				/*!< Output history (Q31) */
+} DSP_BIQUAD_T;
+
+/** First order DC blocker, Q31 internal state */
+typedef struct {
+	int32_t a;					/*!< Pole in Q30 (DSP_DCBLOCK_COEF) */
+	int32_t x1;					/*!< Previous input (Q15) */
+	int32_t y1;					/*!< Previous output (Q31) */
+} DSP_DCBLOCK_T;
+
+/** Symmetric Q15 FIR with DSP_FIR_TAPS taps */
+typedef struct {
+	const int16_t *pCoef;
+	int16_t buf[DSP_FIR_TAPS - 1 + DSP_FILTER_MAX_BLOCK];	/*!< History followed by the input */
+} DSP_FIR_T;
+
+/** Filter chain: DC removal, mains notch and anti-aliasing low-pass */
+typedef struct {
+	DSP_DCBLOCK_T dc;
+	DSP_BIQUAD_T notch;
+	DSP_FIR_T lpf;
+	bool dcEnabled;
+	bool notchEnabled;
+	bool lpfEnabled;
+} DSP_FILTER_CHAIN_T;
+
+/**
+ * @brief	Initialize a DC blocker
+ * @param	pDc	: DC blocker
+ * @param	a	: Pole in Q30 (DSP_DCBLOCK_COEF)
+ * @return	Nothing
+ */
+void DSP_DcBlock_Init(DSP_DCBLOCK_T *pDc, int32_t a);
+
+/**
+ * @brief	Run a DC blocker over a block, in place allowed
+ * @param	pDc		: DC blocker
+ * @param	pIn		: Input samples
+ * @param	pOut	: Output samples
+ * @param	count	: Number of samples
+ * @return	Nothing
+ */
+void DSP_DcBlock_Process(DSP_DCBLOCK_T *pDc, const int16_t *pIn, int16_t *pOut, uint32_t count);
+
+/**
+ * @brief	Initialize a biquad section
+ * @param	pBq		: Biquad
+ * @param	pCoef	: Coefficients, must stay valid
+ * @return	Nothing
+ */
+void DSP_Biquad_Init(DSP_BIQUAD_T *pBq, const DSP_BIQUAD_COEF_T *pCoef);
+
+/**
+ * @brief	Run a biquad section over a block, in place allowed
+ * @param	pBq		: Biquad
+ * @param	pIn		: Input samples
+ * @param	pOut	: Output samples
+ * @param	count	: Number of samples
+ * @return	Nothing
+ */
+void DSP_Biquad_Process(DSP_BIQUAD_T *pBq, const int16_t *pIn, int16_t *pOut, uint32_t count);
+
+/**
+ * @brief	Initialize a FIR filter
+ * @param	pFir	: FIR filter
+ * @param	pCoef	: DSP_FIR_TAPS symmetric Q15 taps, must stay valid
+ * @return	Nothing
+ * @note	The sum of the absolute tap values must stay below 2.0 so that
+ *			the 32-bit accumulator cannot overflow.
+ */
+void DSP_Fir_Init(DSP_FIR_T *pFir, const int16_t *pCoef);
+
+/**
+ * @brief	Run a FIR filter over a block, in place allowed
+ * @param	pFir	: FIR filter
+ * @param	pIn		: Input samples
+ * @param	pOut	: Output samples
+ * @param	count	: Number of samples
+ * @return	Nothing
+ */
+void DSP_Fir_Process(DSP_FIR_T *pFir, const int16_t *pIn, int16_t *pOut, uint32_t count);
+
+/**
+ * @brief	Initialize a filter chain with all stages enabled
+ * @param	pChain		: Filter chain
+ * @param	dcCoef		: DC blocker pole (DSP_DCBLOCK_COEF)
+ * @param	pNotchCoef	: Notch coefficients (DSP_NOTCH_COEF)
+ * @param	pLpfCoef	: Low-pass taps (DSP_LPF_COEF)
+ * @return	Nothing
+ */
+void DSP_Chain_Init(DSP_FILTER_CHAIN_T *pChain, int32_t dcCoef,
+					const DSP_BIQUAD_COEF_T *pNotchCoef, const int16_t *pLpfCoef);
+
+/**
+ * @brief	Run the enabled stages of a filter chain over a block in place
+ * @param	pChain		: Filter chain
+ * @param	pSamples	: Samples to filter
+ * @param	count		: Number of samples
+ * @return	Nothing
+ */
+void DSP_Chain_Process(DSP_FILTER_CHAIN_T *pChain, int16_t *pSamples, uint32_t count);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_FILTER_H_ */
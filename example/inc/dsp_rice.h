@@ -0,0 +1,113 @@
+/*
+ * @brief Lossless block coding of 12-bit samples
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __DSP_RICE_H_
+#define __DSP_RICE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Lossless block coding of 12-bit samples. Each block is predicted with
+   the fixed predictor of order 1 (delta) or 2 (linear) that fits it best,
+   and the residuals are Rice coded in partitions that each pick their
+   own parameter. A partition that would not shrink is stored raw. This
+   module has no chip dependencies and also builds on the host.
+
+   Block layout: sample count (16 bits, little endian), predictor order
+   (1 byte), then a bit stream, most significant bit first: order warm-up
+   samples of 12 bits, and for every partition a 4-bit parameter k
+   followed by its residuals. Residuals are zigzag mapped, then coded as
+   (u >> k) one bits, a zero bit and the k low bits of u; k = 15 marks a
+   raw partition holding the 12-bit samples themselves. The stream is
+   padded to a byte. */
+
+/** Residuals per partition */
+#define DSP_RICE_PARTITION          16
+
+/** Most samples in one block */
+#define DSP_RICE_MAX_COUNT          0xFFFF
+
+/** Parameter marking a raw partition */
+#define DSP_RICE_RAW_K              15
+
+/** Bits of a raw sample */
+#define DSP_RICE_RAW_BITS           12
+
+/** Bytes before the bit stream */
+#define DSP_RICE_HEADER_BYTES       3
+
+/** Largest encoded size of a block of n samples */
+#define DSP_RICE_MAX_BYTES(n)       (DSP_RICE_HEADER_BYTES + (((2 * DSP_RICE_RAW_BITS) + ((((n) + DSP_RICE_PARTITION - 1) / \
+									 DSP_RICE_PARTITION) * 4) + ((n) * DSP_RICE_RAW_BITS) + 7) / 8))
+
+/**
+ * @brief	Encode one block of samples
+ * @param	pIn		: 12-bit samples
+ * @param	count	: Number of samples, 1 to DSP_RICE_MAX_COUNT
+ * @param	pOut	: Room for DSP_RICE_MAX_BYTES(count) bytes
+ * @return	Encoded size in bytes
+ */
+uint32_t DSP_Rice_Encode(const uint16_t *pIn, uint32_t count, uint8_t *pOut);
+
+/**
+ * @brief	Return the sample count of an encoded block
+ * @param	pIn	: Encoded block, at least DSP_RICE_HEADER_BYTES long
+ * @return	Number of samples the block decodes to
+ */
+uint32_t DSP_Rice_GetCount(const uint8_t *pIn);
+
+/**
+ * @brief	Decode one block of samples
+ * @param	pIn			: Encoded block
+ * @param	len			: Bytes available at pIn
+ * @param	pOut		: Decoded samples
+ * @param	maxCount	: Room at pOut in samples
+ * @return	Number of samples decoded, 0 for a truncated or corrupt block
+ */
+uint32_t DSP_Rice_Decode(const uint8_t *pIn, uint32_t len, uint16_t *pOut, uint32_t maxCount);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_RICE_H_ */
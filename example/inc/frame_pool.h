@@ -0,0 +1,112 @@
+/*
+ * @brief Pool of frame blocks sent in place
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "host_frame.h"
+
+#ifndef __FRAME_POOL_H_
+#define __FRAME_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Fixed pool of frame blocks that are sent in place. The main loop takes
+   a block, builds the frame header, payload and CRC straight into it and
+   queues it on the USB IN endpoint by pointer; the USB interrupt gives it
+   back once its last packet is out. Alloc and Free are the two ends of a
+   single-producer/single-consumer index ring, so neither takes a lock.
+   This module has no chip dependencies. */
+
+/** Largest frame a block holds, in samples */
+#define FRAME_POOL_SAMPLES          256
+
+/** Blocks in the pool, power of 2 */
+#define FRAME_POOL_BLOCKS           8
+
+/** Bytes per block, whole 64-byte endpoint buffers so that every block
+    is sent in place from a boundary */
+#define FRAME_POOL_BLOCK_BYTES      ((FRAME_BYTES(FRAME_POOL_SAMPLES) + 63) & ~63)
+
+#if (FRAME_POOL_BLOCKS & (FRAME_POOL_BLOCKS - 1)) != 0
+#error "FRAME_POOL_BLOCKS must be a power of 2"
+#endif
+
+/**
+ * @brief	Put every block back into the pool
+ * @return	Nothing
+ * @note	Only while no block is in use.
+ */
+void FramePool_Init(void);
+
+/**
+ * @brief	Take a block
+ * @return	FRAME_POOL_BLOCK_BYTES bytes, or NULL when all blocks are in use
+ * @note	One context only, the main loop.
+ */
+uint8_t *FramePool_Alloc(void);
+
+/**
+ * @brief	Give a block back
+ * @param	pBlock	: Block returned by FramePool_Alloc()
+ * @return	Nothing
+ * @note	One context only, may be an interrupt other than the one of
+ * FramePool_Alloc().
+ */
+void FramePool_Free(uint8_t *pBlock);
+
+/**
+ * @brief	Return the number of free blocks
+ * @return	Blocks FramePool_Alloc() can hand out now
+ */
+uint32_t FramePool_GetFree(void);
+
+/**
+ * @brief	Return the fewest free blocks seen since FramePool_Init()
+ * @return	Low-water mark of the free count
+ */
+uint32_t FramePool_GetLowWater(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FRAME_POOL_H_ */
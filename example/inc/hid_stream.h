@@ -0,0 +1,110 @@
+/*
+ * @brief Raw samples in vendor HID reports
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __HID_STREAM_H_
+#define __HID_STREAM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Raw samples in vendor HID input reports, for hosts without a driver.
+   Samples are queued as blocks arrive and every interrupt IN report takes
+   as many as it can hold. This module has no chip dependencies.
+
+   Report layout, little endian:
+	 0	count			samples in this report, 0 to HID_STREAM_MAX_SAMPLES
+	 1	flags			HID_STREAM_FLAG_xxx
+	 2	sequence		16 bits, report number
+	 4	index			32 bits, index of the first sample on the sample clock
+	 8	samples			packed two in three bytes as in host_frame.h,
+						unused bytes are 0 */
+
+/** Input report size, one full-speed interrupt packet */
+#define HID_STREAM_REPORT_SIZE      64
+
+/** Header bytes before the samples */
+#define HID_STREAM_HEADER_BYTES     8
+
+/** Samples per report, 37 packed samples fill the 56 bytes left */
+#define HID_STREAM_MAX_SAMPLES      ((((HID_STREAM_REPORT_SIZE - HID_STREAM_HEADER_BYTES) * 2) - 1) / 3)
+
+/** Samples queued between reports, power of 2 */
+#define HID_STREAM_FIFO_SZ          1024
+
+/** Flags */
+#define HID_STREAM_FLAG_GAP         (1 << 0)	/*!< Samples were dropped before this report */
+
+#if (HID_STREAM_FIFO_SZ & (HID_STREAM_FIFO_SZ - 1)) != 0
+#error "HID_STREAM_FIFO_SZ must be a power of 2"
+#endif
+
+/**
+ * @brief	Empty the queue and restart the sequence
+ * @return	Nothing
+ */
+void HID_Stream_Init(void);
+
+/**
+ * @brief	Queue a block of 12-bit samples
+ * @param	pSamples	: Samples
+ * @param	count		: Number of samples
+ * @return	Samples dropped, the block when it does not fit
+ * @note	The sample index advances by count either way, so a report after
+ * a drop shows the jump and carries HID_STREAM_FLAG_GAP.
+ */
+uint32_t HID_Stream_Write(const uint16_t *pSamples, uint32_t count);
+
+/**
+ * @brief	Fill the next input report from the queue
+ * @param	pReport	: HID_STREAM_REPORT_SIZE bytes
+ * @return	Samples in the report
+ * @note	Call from the context of HID_Stream_Write(). An empty queue
+ * gives a report with no samples.
+ */
+uint32_t HID_Stream_FillReport(uint8_t *pReport);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HID_STREAM_H_ */
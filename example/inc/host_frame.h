@@ -0,0 +1,155 @@
+/*
+ * @brief Binary sample frames for the host
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __HOST_FRAME_H_
+#define __HOST_FRAME_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Binary sample frames for the host. A frame is a fixed header, a
+   payload of 12-bit samples packed two in three bytes and a CRC. Frames
+   share the CDC IN stream with the text records; they start with a sync
+   byte that never appears in text, so a reader can tell them apart and
+   resynchronize after an error. This module has no chip dependencies and
+   also builds on the host.
+
+   All fields are little endian:
+	 0	sync			FRAME_SYNC0, FRAME_SYNC1
+	 2	type			FRAME_TYPE_SAMPLES12
+	 3	flags			FRAME_FLAG_xxx
+	 4	payload bytes	16 bits
+	 6	sample count	16 bits, all channels
+	 8	sequence		32 bits, frame number of the stream
+	12	timestamp		32 bits, index of the first sample on the sample clock
+	16	channel mask	32 bits, FRAME_CHAN_ADC0() / FRAME_CHAN_ADC1() bits
+	20	payload			samples in time order, the channels of one instant in
+						mask order, ADC0 before ADC1; with FRAME_FLAG_INTERLEAVED
+						one input sampled by the mask channels in turn
+	 n	CRC				16 bits, CRC-16/CCITT-FALSE over header and payload
+
+   Samples a and b of a pair take bytes a[7:0], b[3:0]:a[11:8], b[11:4].
+   An odd last sample takes two bytes, the upper nibble of the second is 0.
+
+   The time fields tie the sample clock to the USB frame clock of the
+   host: sample n was taken (n - time index) sample periods after the
+   time cycles, and the SOF fields are valid with FRAME_FLAG_SOF. Frames
+   of the same capture block share the reference. */
+
+/** Sync bytes, outside the 7-bit text range */
+#define FRAME_SYNC0                 0xA5
+#define FRAME_SYNC1                 0xC3
+
+/** Frame types */
+#define FRAME_TYPE_SAMPLES12        1
+
+/** Flags */
+#define FRAME_FLAG_GAP              (1 << 0)	/*!< Samples were lost before this frame */
+#define FRAME_FLAG_INTERLEAVED      (1 << 1)	/*!< The mask channels sample one input in turn */
+#define FRAME_FLAG_SOF              (1 << 2)	/*!< The SOF time fields are valid */
+
+/** Header and CRC bytes */
+#define FRAME_HEADER_BYTES          36
+#define FRAME_CRC_BYTES             2
+
+/** Channel mask bits */
+#define FRAME_CHAN_ADC0(ch)         (1UL << (ch))
+#define FRAME_CHAN_ADC1(ch)         (1UL << (16 + (ch)))
+
+/** Payload bytes of n packed samples */
+#define FRAME_PAYLOAD_BYTES(n)      ((((n) * 3) + 1) / 2)
+
+/** Frame bytes for n samples */
+#define FRAME_BYTES(n)              (FRAME_HEADER_BYTES + FRAME_PAYLOAD_BYTES(n) + FRAME_CRC_BYTES)
+
+/** Time reference of a frame */
+typedef struct {
+	uint32_t index;				/*!< Sample index of the reference, same count as the timestamp */
+	uint32_t cycles;			/*!< Device cycle count at that sample */
+	uint32_t sofFrame;			/*!< Start of frames counted, the low 11 bits are the frame number */
+	uint32_t sofCycles;			/*!< Device cycle count at that start of frame */
+} FRAME_TIME_T;
+
+/** Fields of a frame besides its samples */
+typedef struct {
+	uint8_t type;				/*!< FRAME_TYPE_xxx */
+	uint8_t flags;				/*!< FRAME_FLAG_xxx */
+	uint32_t seq;				/*!< Frame number */
+	uint32_t timestamp;			/*!< Index of the first sample */
+	uint32_t chanMask;			/*!< Channels in the payload */
+	FRAME_TIME_T time;			/*!< Time reference */
+} FRAME_INFO_T;
+
+/**
+ * @brief	Pack 12-bit samples two in three bytes
+ * @param	pIn		: Samples
+ * @param	count	: Number of samples
+ * @param	pOut	: Room for FRAME_PAYLOAD_BYTES(count) bytes
+ * @return	Nothing
+ */
+void Frame_Pack12(const uint16_t *pIn, uint32_t count, uint8_t *pOut);
+
+/**
+ * @brief	Continue a CRC-16/CCITT-FALSE
+ * @param	crc		: 0xFFFF to start, or the result of the previous call
+ * @param	pData	: Bytes to add
+ * @param	len		: Number of bytes
+ * @return	Updated CRC
+ */
+uint16_t Frame_Crc16(uint16_t crc, const uint8_t *pData, uint32_t len);
+
+/**
+ * @brief	Build one frame of samples
+ * @param	pOut		: Room for FRAME_BYTES(count) bytes
+ * @param	pInfo		: Header fields
+ * @param	pSamples	: 12-bit samples
+ * @param	count		: Number of samples, up to 0xFFFF
+ * @return	Frame size in bytes
+ */
+uint32_t Frame_Build(uint8_t *pOut, const FRAME_INFO_T *pInfo, const uint16_t *pSamples, uint32_t count);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_FRAME_H_ */
@@ -0,0 +1,135 @@
+/*
+ * @brief Command and record link to the host over the virtual COM port
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include "board.h"
+#include "cdc_vcom.h"
+
+#ifndef __HOST_LINK_H_
+#define __HOST_LINK_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Text link to the host over the CDC virtual COM port. The host sends one
+   command per line, the device answers with lines and sends its records
+   unsolicited. Records are queued whole or not at all, straight into the
+   CDC TX ring (cdc_vcom.c). */
+
+/** Bytes queued towards the host, the CDC TX ring */
+#define LINK_TX_FIFO_SZ             VCOM_TX_RING_SZ
+
+/** Longest command line accepted from the host */
+#define LINK_CMD_LINE_MAX           64
+
+/** Longest record built by Link_Printf() */
+#define LINK_RECORD_MAX             96
+
+/**
+ * Command handler
+ * @param	pArgs	: Rest of the command line after the name, leading blanks removed
+ */
+typedef void (*LINK_CMD_HANDLER_T)(const char *pArgs);
+
+/** One host command */
+typedef struct {
+	const char *pName;			/*!< First word of the command line */
+	LINK_CMD_HANDLER_T handler;	/*!< Called with the arguments */
+	const char *pHelp;			/*!< One line description listed by "help" */
+} LINK_CMD_T;
+
+/**
+ * @brief	Initialize the host link
+ * @param	pCmds	: Command table, must stay valid
+ * @param	count	: Number of commands in the table
+ * @return	Nothing
+ * @note	The table is searched in order, "help" is always available.
+ */
+void Link_Init(const LINK_CMD_T *pCmds, uint32_t count);
+
+/**
+ * @brief	Run received commands
+ * @return	Nothing
+ * @note	Call from the main loop. Queued data goes out from the USB
+ * interrupt and needs no polling.
+ */
+void Link_Poll(void);
+
+/**
+ * @brief	Queue data for the host
+ * @param	pData	: Data to send
+ * @param	len		: Number of bytes
+ * @return	true if queued, false if the FIFO has no room for all of it
+ */
+bool Link_Write(const void *pData, uint32_t len);
+
+/**
+ * @brief	Queue a formatted record for the host
+ * @param	pFmt	: printf() format
+ * @return	true if queued, false if the FIFO has no room for it
+ * @note	Records longer than LINK_RECORD_MAX are truncated, keeping
+ *			their "\r\n" terminator.
+ */
+bool Link_Printf(const char *pFmt, ...);
+
+/**
+ * @brief	Tell the host that data was dropped for lack of TX room
+ * @return	Nothing
+ * @note	Call once per record, frame or block given up. The host sees
+ * an overrun on the CDC interrupt endpoint, see cdc_vcom.h.
+ */
+void Link_Dropped(void);
+
+/**
+ * @brief	Return the room left in the TX FIFO
+ * @return	Free bytes
+ */
+uint32_t Link_GetFree(void);
+
+/**
+ * @brief	Check if the host has opened the port
+ * @return	true when connected
+ */
+bool Link_IsConnected(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HOST_LINK_H_ */
@@ -0,0 +1,150 @@
+/*
+ * @brief Sample stream and clock loop of the USB audio personality
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef __UAC_STREAM_H_
+#define __UAC_STREAM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* Sample stream of the USB audio personality. Blocks of 12-bit samples
+   are queued as 16-bit PCM and every USB frame (1 ms, start of frame)
+   takes the samples due in that frame for the isochronous IN packet.
+
+   The packets carry the nominal rate exactly, so the sample clock must
+   follow the host's frame clock. Every frame the samples converted so
+   far are compared with the samples sent plus the latency; the
+   difference drives a PI loop whose output is the trim of the sample
+   clock period, see UAC_Stream_GetTrim(). Samples are read a fixed
+   latency behind the converter, enough for a block to be handed over
+   from the main loop. While the sample clock is stopped, e.g. for a
+   recalibration, the packets carry silence and the read position waits
+   for it. This module has no chip dependencies and also
+   builds on the host. */
+
+/** Samples queued, power of 2. Samples are valid for half of it. */
+#define UAC_STREAM_FIFO_SZ          2048
+
+/** Largest packet for a rate in Hz, in samples */
+#define UAC_STREAM_FRAME_MAX(rate)  (((rate) + 999) / 1000)
+
+/** Frames the loop takes to settle a step of the sample clock */
+#define UAC_STREAM_LOOP_FRAMES      128
+
+/** Trim limit in 2^-24, about 1000 ppm */
+#define UAC_STREAM_TRIM_MAX         (1 << 14)
+
+#if (UAC_STREAM_FIFO_SZ & (UAC_STREAM_FIFO_SZ - 1)) != 0
+#error "UAC_STREAM_FIFO_SZ must be a power of 2"
+#endif
+
+/** Stream counters */
+typedef struct {
+	uint32_t frames;			/*!< Start of frames seen */
+	uint32_t samples;			/*!< Samples sent */
+	uint32_t underruns;			/*!< Samples sent as silence, not queued in time */
+	uint32_t inserted;			/*!< Silence sent while the sample clock was stopped */
+	uint32_t resyncs;			/*!< Read position moved back to the latency */
+	int32_t error;				/*!< Last distance from the latency in samples */
+	int32_t errorMax;			/*!< Largest distance since the last resync */
+} UAC_STREAM_STATS_T;
+
+/**
+ * @brief	Set up the stream, stopped
+ * @param	rateHz	: Sample rate, as in the descriptors
+ * @param	latency	: Samples between the converter and the packets
+ * @return	Nothing
+ * @note	latency must cover a block and the time the main loop takes
+ * to hand it over, and stay below UAC_STREAM_FIFO_SZ / 2.
+ */
+void UAC_Stream_Init(uint32_t rateHz, uint32_t latency);
+
+/**
+ * @brief	Queue a block of 12-bit samples
+ * @param	pSamples	: Samples, in stream order without gaps
+ * @param	count		: Number of samples
+ * @return	Nothing
+ * @note	Sample n of the stream is the n-th sample queued since
+ * UAC_Stream_Init(), the numbering used by UAC_Stream_Frame().
+ */
+void UAC_Stream_Write(const uint16_t *pSamples, uint32_t count);
+
+/**
+ * @brief	Start filling packets, the host selected the streaming setting
+ * @return	Nothing
+ */
+void UAC_Stream_Start(void);
+
+/**
+ * @brief	Stop filling packets
+ * @return	Nothing
+ */
+void UAC_Stream_Stop(void);
+
+/**
+ * @brief	Run the loop for one USB frame and fill its packet
+ * @param	converted	: Samples converted so far, on the numbering of the queue
+ * @param	pPacket		: Room for UAC_STREAM_FRAME_MAX() samples
+ * @return	Samples in the packet, 0 when stopped
+ * @note	Call from the start of frame interrupt. The loop runs whether
+ * the stream is started or not, so it is locked when the host starts it.
+ */
+uint32_t UAC_Stream_Frame(uint32_t converted, int16_t *pPacket);
+
+/**
+ * @brief	Return the output of the loop
+ * @return	Amount to lengthen the sample period by, in 2^-24 of the period
+ */
+int32_t UAC_Stream_GetTrim(void);
+
+/**
+ * @brief	Return the stream counters
+ * @return	Pointer to the counters
+ */
+const UAC_STREAM_STATS_T *UAC_Stream_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UAC_STREAM_H_ */
@@ -0,0 +1,101 @@
+/*
+ * @brief USB audio streaming of the ADC samples
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#ifndef __USB_AUDIO_H_
+#define __USB_AUDIO_H_
+
+#include "app_usbd_cfg.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/** @ingroup EXAMPLES_PERIPH_15XX_ADC
+ * @{
+ */
+
+/* USB audio class 1.0 personality (audio_desc.c): the ADC1 stream as a
+   mono 16-bit microphone on an isochronous IN endpoint. The start of
+   frame handler sends one packet per frame from uac_stream.c and trims
+   the SCT sample clock so that it follows the host's frame clock. */
+
+/**
+ * Returns the samples converted so far, on the numbering of the samples
+ * given to UAC_Stream_Write()
+ */
+typedef uint32_t (*USB_AUDIO_CONVERTED_T)(void);
+
+/**
+ * @brief	Audio streaming init routine
+ * @param	hUsb		: Handle to USBD stack instance
+ * @param	pDesc		: Pointer to configuration descriptor
+ * @param	pUsbParam	: Pointer USB param structure returned by previous init call
+ * @param	converted	: Sample count of the converter, called every start of frame
+ * @return	LPC_OK on success
+ * @note	UAC_Stream_Init() must have been called. usb_audio_sof_event(),
+ * usb_audio_interface_event() and usb_audio_reset_event() must be set
+ * in pUsbParam before USBD_API->hw->Init().
+ */
+ErrorCode_t usb_audio_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT_PARAM_T *pUsbParam,
+						   USB_AUDIO_CONVERTED_T converted);
+
+/**
+ * @brief	Start of frame callback, USB_SOF_Event of the init parameters
+ * @param	hUsb	: Handle to USBD stack instance
+ * @return	LPC_OK
+ */
+ErrorCode_t usb_audio_sof_event(USBD_HANDLE_T hUsb);
+
+/**
+ * @brief	Set interface callback, USB_Interface_Event of the init parameters
+ * @param	hUsb	: Handle to USBD stack instance
+ * @return	LPC_OK
+ * @note	Alternate setting 1 of the streaming interface starts the stream,
+ * setting 0 stops it.
+ */
+ErrorCode_t usb_audio_interface_event(USBD_HANDLE_T hUsb);
+
+/**
+ * @brief	Bus reset callback, USB_Reset_Event of the init parameters
+ * @param	hUsb	: Handle to USBD stack instance
+ * @return	LPC_OK
+ */
+ErrorCode_t usb_audio_reset_event(USBD_HANDLE_T hUsb);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USB_AUDIO_H_ */
@@ -31,8 +31,37 @@
 
 #include "board.h"
 #include <stdio.h>
+#include <string.h>
 #include "app_usbd_cfg.h"
+#if defined(APP_USB_VCOM)
+#include "cdc_vcom.h"
+#include "host_link.h"
+#elif defined(APP_USB_AUDIO)
+#include "usb_audio.h"
+#include "uac_stream.h"
+#else
 #include "hid_mouse.h"
+#include "hid_stream.h"
+#endif
+#include "adc_trig.h"
+#include "adc_time.h"
+#include "adc_dma.h"
+#include "adc_dual.h"
+#include "adc_decim.h"
+#include "dsp_filter.h"
+#include "cycle_count.h"
+#include "adc_event.h"
+#include "diag_stats.h"
+#include "adc_readout.h"
+#include "adc_cal.h"
+#include "adc_capture.h"
+#include "adc_sched.h"
+#include "adc_ctrl.h"
+#include "adc_spectrum.h"
+#include "adc_summary.h"
+#include "dsp_rice.h"
+#include "host_frame.h"
+#include "frame_pool.h"
 /*****************************************************************************
  * Private types/enumerations/variables
  ****************************************************************************/
@@ -40,98 +69,1706 @@
 static volatile int ticks;
 bool sequence0Complete, sequence1Complete, threshold1Crossed;
 
-#define TICKRATE_HZ (100)	/* 100 ticks per second */
+#define TICKRATE_HZ (100)	/* 100 ticks per second */
+
+/* Start ADC1 sequence A from the SCT (hardware trigger). Undefine to use
+   the original manual start from the sysTick interrupt. */
+#define ADC_USE_HW_TRIGGER
+
+/* Hardware trigger rate, clamped to what the ADC can sustain */
+#define ADC_SAMPLE_RATE_HZ (16000)
+
+/* Move ADC1 sequence A results into ping-pong blocks by DMA and take one
+   interrupt per block. Undefine to take one ADC1A interrupt per sequence. */
+#define ADC_USE_DMA
+
+/* ADC acquisition modes */
+#define ADC_MODE_SINGLE         0	/* ADC1 only */
+#define ADC_MODE_INTERLEAVED    1	/* ADC0 and ADC1 on one input, half a period apart */
+#define ADC_MODE_SIMULTANEOUS   2	/* ADC0/ADC1 channel pairs sampled together */
+
+#define ADC_MODE                ADC_MODE_SINGLE
+
+#if (ADC_MODE != ADC_MODE_SINGLE) && (!defined(ADC_USE_HW_TRIGGER) || !defined(ADC_USE_DMA))
+#error "Dual ADC modes need ADC_USE_HW_TRIGGER and ADC_USE_DMA"
+#endif
+
+#if defined(ADC_USE_DMA)
+/* DMA is requested after every conversion, the sequence end is not used */
+#define ADC1_SEQA_MODE      0
+#define ADC1_SEQA_DMA_CH    DMA_CH0
+#else
+#define ADC1_SEQA_MODE      ADC_SEQ_CTRL_MODE_EOS
+#endif
+
+/* Oversampling ratio of the decimation stage at boot. It can be changed
+   at run time with ADC_Decim_SetRatio(). */
+#define ADC_DECIM_RATIO         (8)
+
+/* Rate of the merged sample stream and of the decimator output. The filter
+   coefficients below are computed for the boot decimation ratio. */
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+#define ADC_STREAM_RATE_HZ      (2 * ADC_SAMPLE_RATE_HZ)
+#else
+#define ADC_STREAM_RATE_HZ      (ADC_SAMPLE_RATE_HZ)
+#endif
+#define ADC_FILTER_FS_HZ        (ADC_STREAM_RATE_HZ / ADC_DECIM_RATIO)
+
+/* Filter chain after decimation: DC blocker corner, mains notch and
+   low-pass cut-off in Hz */
+#define ADC_FILTER_DC_HZ        (1)
+#define ADC_FILTER_MAINS_HZ     (50)
+#define ADC_FILTER_NOTCH_Q      (5)
+#define ADC_FILTER_LPF_HZ       (400)
+
+/* Recalibrate the ADCs in the gap after a block once this much
+   acquisition time has passed since the last calibration */
+#define ADC_RECAL_INTERVAL_S    (60)
+
+/* Blocks between two cycle count reports */
+#define ADC_PERF_REPORT_BLOCKS  (16)
+
+/* Threshold 0 of the ADC1 input, about 25% and 75% of full scale */
+#define ADC_EVENT_THR_LOW       ((1 * 0xFFF) / 4)
+#define ADC_EVENT_THR_HIGH      ((3 * 0xFFF) / 4)
+
+#if defined(APP_USB_VCOM)
+/* What is sent to the host besides command replies */
+typedef enum {
+	HOST_MODE_EVENTS,			/* Threshold events only */
+	HOST_MODE_STREAM,			/* Filtered samples and threshold events */
+	HOST_MODE_SPECTRUM,			/* Magnitude spectra and threshold events */
+	HOST_MODE_SUMMARY,			/* Window statistics and threshold events */
+	HOST_MODE_PACKED,			/* Losslessly packed raw blocks and threshold events */
+	HOST_MODE_BINARY,			/* Raw samples in binary frames and threshold events */
+} HOST_MODE_T;
+
+/* TX FIFO room kept free of samples so that events are never held back */
+#define HOST_EVENT_HEADROOM     (2 * LINK_RECORD_MAX)
+
+/* Filtered samples per stream record */
+#define HOST_SAMPLES_PER_RECORD 8
+
+#if (ADC_MODE != ADC_MODE_SIMULTANEOUS) && defined(ADC_USE_DMA)
+/* Pre/post-trigger capture of the raw sample stream ("cap" command) */
+#define HOST_CAPTURE
+
+/* Capture window used when "cap" gives none, in ms around the trigger */
+#define HOST_CAPTURE_PRE_MS     (2)
+#define HOST_CAPTURE_POST_MS    (6)
+
+/* Capture samples per record, 3 hex digits each */
+#define HOST_CAPTURE_PER_RECORD 24
+
+/* Magnitude spectra of the raw sample stream ("mode spectrum", "fft") */
+#define HOST_SPECTRUM
+
+/* Spectrum set up until "fft" changes it */
+#define HOST_SPECTRUM_SIZE      (256)
+#define HOST_SPECTRUM_WINDOW    DSP_FFT_WIN_HANN
+#define HOST_SPECTRUM_AVERAGE   (4)
+
+/* Spectrum bins per record, 4 hex digits each */
+#define HOST_SPECTRUM_PER_RECORD 20
+
+/* Raw blocks sent delta/Rice packed ("mode packed", "pack") */
+#define HOST_PACK
+
+/* Largest block accepted by the encoder, a merged or readout block */
+#define HOST_PACK_MAX_SAMPLES   ADC_DUAL_BLOCK_SAMPLES
+
+/* Encoder budget, share of the core at the stream rate in percent */
+#define HOST_PACK_BUDGET_PCT    (10)
+
+/* Packed bytes per record, 2 hex digits each */
+#define HOST_PACK_PER_RECORD    32
+
+/* Raw samples in binary frames between the text records ("mode binary") */
+#define HOST_FRAMES
+
+/* Samples per frame, a frame is sent whole or dropped */
+#define HOST_FRAME_SAMPLES      FRAME_POOL_SAMPLES
+
+/* Frames are built in pool blocks and sent from there by pointer. Without
+   it they are built in one buffer and copied into the TX ring, the path to
+   compare the cycles per KB of "frames" against. */
+#define HOST_FRAME_ZERO_COPY
+#endif
+
+#if defined(ADC_USE_DMA)
+/* Min/max/mean/RMS of every channel per window ("mode summary", "win") */
+#define HOST_SUMMARY
+
+/* Window used until "win" changes it */
+#define HOST_SUMMARY_WINDOW_MS  (100)
+#endif
+#endif
+
+#if defined(APP_USB_HID) && defined(HID_VENDOR_STREAM)
+/* Raw sample stream in the vendor HID reports filled by showValudeADC() */
+#if (ADC_MODE == ADC_MODE_SIMULTANEOUS) || !defined(ADC_USE_DMA)
+#error "HID_VENDOR_STREAM needs the single or interleaved mode with DMA"
+#endif
+#define HID_STREAM
+#endif
+
+#if defined(APP_USB_AUDIO)
+/* The audio packets take the raw single or interleaved stream, and the
+   start of frames trim the SCT sample clock */
+#if (ADC_MODE == ADC_MODE_SIMULTANEOUS) || !defined(ADC_USE_DMA) || !defined(ADC_USE_HW_TRIGGER)
+#error "APP_USB_AUDIO needs the single or interleaved mode with DMA and the hardware trigger"
+#endif
+#if (ADC_STREAM_RATE_HZ != USB_AUDIO_RATE_HZ)
+#error "USB_AUDIO_RATE_HZ must be the rate of the ADC stream"
+#endif
+
+/* Samples between the converter and the audio packets: a block and 8 ms
+   for the main loop to queue it */
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+#define AUDIO_LATENCY_SAMPLES   (ADC_DUAL_BLOCK_SAMPLES + (8 * (ADC_STREAM_RATE_HZ / 1000)))
+#else
+#define AUDIO_LATENCY_SAMPLES   (ADC_DMA_BLOCK_SAMPLES + (8 * (ADC_STREAM_RATE_HZ / 1000)))
+#endif
+#endif
+
+#if defined(BOARD_KEIL_MCB1500)
+/* ADC is connected to the pot */
+#define BOARD_ADC_CH 0
+#define ANALOG_INPUT_PORT   1
+#define ANALOG_INPUT_BIT    1
+#define ANALOG_FIXED_PIN    SWM_FIXED_ADC1_0
+/* ADC0 input wired to the same source for the interleaved mode */
+#define BOARD_ADC0_CH 0
+#define ANALOG0_INPUT_PORT  0
+#define ANALOG0_INPUT_BIT   8
+#define ANALOG0_FIXED_PIN   SWM_FIXED_ADC0_0
+
+/* Channel pairs {ADC0, ADC1} for the simultaneous mode and their pins
+   {port, bit, fixed pin} */
+#define BOARD_ADC_PAIRS         {{BOARD_ADC0_CH, BOARD_ADC_CH}}
+#define BOARD_ADC_PAIR_PINS     {{ANALOG0_INPUT_PORT, ANALOG0_INPUT_BIT, ANALOG0_FIXED_PIN}, \
+								 {ANALOG_INPUT_PORT, ANALOG_INPUT_BIT, ANALOG_FIXED_PIN}}
+
+#elif defined(BOARD_NXP_LPCXPRESSO_1549)
+/* ADC is connected to the pot on LPCXPresso base boards */
+#define BOARD_ADC_CH 1
+#define ANALOG_INPUT_PORT   0
+#define ANALOG_INPUT_BIT    9
+#define ANALOG_FIXED_PIN    SWM_FIXED_ADC1_1
+/* ADC0 input wired to the same source for the interleaved mode */
+#define BOARD_ADC0_CH 3
+#define ANALOG0_INPUT_PORT  0
+#define ANALOG0_INPUT_BIT   5
+#define ANALOG0_FIXED_PIN   SWM_FIXED_ADC0_3
+
+/* Channel pairs {ADC0, ADC1} for the simultaneous mode and their pins
+   {port, bit, fixed pin} */
+#define BOARD_ADC_PAIRS         {{BOARD_ADC0_CH, BOARD_ADC_CH}}
+#define BOARD_ADC_PAIR_PINS     {{ANALOG0_INPUT_PORT, ANALOG0_INPUT_BIT, ANALOG0_FIXED_PIN}, \
+								 {ANALOG_INPUT_PORT, ANALOG_INPUT_BIT, ANALOG_FIXED_PIN}}
+
+#else
+#warning "Using ADC channel 8 for this example, please select for your board"
+#define BOARD_ADC_CH 8
+#endif
+
+/* ADC1 sequence A inputs in the single mode, BOARD_ADC_CH must be one of
+   them. It feeds the decimator and filters, the others are read out into
+   their own slots. */
+#define ADC1_SEQA_CHANNELS      (ADC_SEQ_CTRL_CHANSEL(BOARD_ADC_CH))
+
+/* ADC0 channel 0 is switched to the internal temperature sensor when it
+   is a slow channel */
+#define ADC_TEMP_CH             0
+
+/* Slow channels {ADC, channel, rate in Hz}, converted by sequencer B of
+   their ADC at their own rate. They must not be sampled by sequencer A. */
+#if (ADC_MODE != ADC_MODE_SINGLE) && (BOARD_ADC0_CH == ADC_TEMP_CH)
+#define BOARD_SLOW_CHANNELS     {{0, 1, 10}}
+#else
+#define BOARD_SLOW_CHANNELS     {{0, ADC_TEMP_CH, 10}}
+#endif
+
+/* ADC1 channels converted by sequencer B on every edge of the SCT1
+   control trigger, 0 for none. Sequence B then preempts sequence A and
+   ADC1 can have no slow channels. */
+#define ADC1_CTRL_CHANNELS      (0)
+#define ADC_CTRL_RATE_HZ        (10000)
+
+#if (ADC1_CTRL_CHANNELS & ADC1_SEQA_CHANNELS) != 0
+#error "ADC1_CTRL_CHANNELS must not be converted by sequence A"
+#endif
+
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+static USBD_HANDLE_T g_hUsb;
+const  USBD_API_T *g_pUsbApi;
+
+#if (ADC_MODE == ADC_MODE_SINGLE) && defined(ADC_USE_DMA)
+static ADC_DMA_STREAM_T adc1Stream;
+#endif
+
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+/* ADC0 correction, refined from every merged block */
+static ADC_DUAL_MATCH_T adc0Match = {0, ADC_DUAL_GAIN_ONE};
+#endif
+
+#if (ADC_MODE != ADC_MODE_SIMULTANEOUS) && defined(ADC_USE_DMA)
+/* Decimation of the single or interleaved sample stream */
+static ADC_DECIM_T adcDecim;
+static int16_t decimOut[(ADC_DUAL_BLOCK_SAMPLES / ADC_DECIM_MIN_RATIO) + 1];
+static CYCLE_STAT_T decimCycles;
+static uint32_t perfBlocks;
+
+/* Filter chain run on the decimator output */
+static DSP_FILTER_CHAIN_T adcFilter;
+static const DSP_BIQUAD_COEF_T notchCoef = DSP_NOTCH_COEF(ADC_FILTER_FS_HZ, ADC_FILTER_MAINS_HZ,
+															ADC_FILTER_NOTCH_Q);
+static const int16_t lpfCoef[DSP_FIR_TAPS] = DSP_LPF_COEF(ADC_FILTER_FS_HZ, ADC_FILTER_LPF_HZ);
+static CYCLE_STAT_T dcCycles, notchCycles, lpfCycles;
+#endif
+
+/* Readout of the ADC1 sequence A channels */
+static ADC_READOUT_T adc1Readout;
+
+/* Slow channels of the multi-rate scheduler */
+static const ADC_SCHED_CHAN_T slowChans[] = BOARD_SLOW_CHANNELS;
+
+#define SLOW_CHAN_COUNT     (sizeof(slowChans) / sizeof(slowChans[0]))
+
+#if (ADC1_CTRL_CHANNELS != 0)
+/* Interrupts kept below the control sequence so they cannot delay it */
+static const IRQn_Type ctrlLowerIrqs[] = {
+	USB0_IRQn, DMA_IRQn, MRT_IRQn, ADC0_SEQA_IRQn, ADC0_SEQB_IRQn, ADC0_OVR_IRQn,
+	ADC1_SEQA_IRQn, ADC1_THCMP_IRQn, ADC1_OVR_IRQn
+};
+#endif
+
+#if (ADC_MODE == ADC_MODE_SINGLE) && defined(ADC_USE_DMA)
+static ADC_SOA_BLOCK_T adc1Soa;
+#endif
+
+#if (ADC_MODE == ADC_MODE_SINGLE) && !defined(ADC_USE_DMA)
+/* ADC1 sequences completed, the sample index without DMA */
+static volatile uint32_t adc1SeqCount;
+#endif
+
+#if defined(APP_USB_VCOM)
+static HOST_MODE_T hostMode = HOST_MODE_EVENTS;
+
+/* USB interrupt load reported by "usb": cycles in USB_IRQHandler() and
+   cycles elapsed since the last report, the latter summed by the main
+   loop so that it does not wrap */
+static volatile uint32_t usbIrqCycles, usbIrqCount;
+static uint64_t usbPerfElapsed;
+static uint32_t usbPerfLast;
+#if (ADC_MODE != ADC_MODE_SIMULTANEOUS) && defined(ADC_USE_DMA)
+/* Index of the next filtered sample sent to the host */
+static uint32_t streamIndex;
+#endif
+
+#if defined(HOST_CAPTURE)
+static ADC_CAPTURE_CFG_T captureCfg;
+static uint32_t captureSeq;		/* Windows sent */
+static uint32_t captureSent;	/* Samples of the current window sent */
+static bool captureHeaderSent;
+#endif
+
+#if defined(HOST_SPECTRUM)
+static const ADC_SPECTRUM_CFG_T spectrumDefault = {HOST_SPECTRUM_SIZE, HOST_SPECTRUM_WINDOW, HOST_SPECTRUM_AVERAGE};
+static const char *const windowNames[DSP_FFT_WIN_COUNT] = {"rect", "hann", "hamming", "blackman"};
+static uint32_t spectrumSent;	/* Bins of the current spectrum sent */
+static bool spectrumHeaderSent;
+#endif
+
+#if defined(HOST_SUMMARY)
+static CYCLE_STAT_T summaryCycles;
+#endif
+
+#if defined(HOST_PACK)
+static uint8_t packBuf[DSP_RICE_MAX_BYTES(HOST_PACK_MAX_SAMPLES)];
+static uint32_t packLen;		/* Bytes of the block being sent, 0 once sent */
+static uint32_t packSent;		/* Bytes of that block sent */
+static uint32_t packSamples;	/* Samples of that block */
+static uint32_t packStart;		/* Raw index of its first sample */
+static uint32_t packIndex;		/* Raw index of the next block */
+static bool packHeaderSent;
+
+/* Encoder counters, reported by "pack" */
+static CYCLE_STAT_T packCycles;
+static uint32_t packWorst;		/* Worst block, 1/100 cycle per sample */
+static uint32_t packOverBudget;	/* Blocks over the budget */
+static uint32_t packBlocks, packDropped;
+static uint64_t packInBytes, packOutBytes;
+#endif
+
+#if defined(HOST_FRAMES)
+#if defined(HOST_FRAME_ZERO_COPY)
+static uint8_t *pFrameSpare;	/* Block refused by the endpoint queue, used for the next frame */
+#else
+static uint8_t frameBuf[FRAME_BYTES(HOST_FRAME_SAMPLES)];
+#endif
+static uint32_t frameSeq;		/* Number of the next frame */
+static uint32_t frameIndex;		/* Raw index of its first sample */
+static bool frameGap;			/* A frame was dropped since the last one sent */
+static FRAME_TIME_T frameTime;	/* Time reference of the block being sent */
+static bool frameTimeSof;		/* frameTime holds a start of frame */
+
+/* Counters reported by "frames", cycles are counted per byte sent */
+static CYCLE_STAT_T frameCycles;
+static uint32_t frameCount, frameDropped;
+#endif
+#endif
+
+/* Boot milestones in core cycles from the start of main() */
+typedef struct {
+	uint32_t calStart;			/* Boot calibration started */
+	uint32_t calDone;			/* First calibration completed */
+	uint32_t usbConnect;		/* USB connected, enumeration can start */
+	uint32_t acqStart;			/* Sample clock started */
+	uint32_t firstBlock;		/* First samples handed to the processing */
+} BOOT_TIMES_T;
+
+static BOOT_TIMES_T bootTimes;
+static bool warmBoot;
+
+/* Acquisition state, only changed from the main loop */
+typedef enum {
+	ACQ_IDLE,					/* Waiting for the boot calibration */
+	ACQ_RUNNING,
+	ACQ_PAUSED,					/* Stopped for a recalibration */
+} ACQ_STATE_T;
+
+static volatile ACQ_STATE_T acqState;
+static uint32_t recalIndex;		/* adc1SampleIndex() at the last calibration */
+static uint32_t pauseStart;
+
+#if (ADC_MODE == ADC_MODE_SIMULTANEOUS)
+typedef struct {
+	uint8_t port;
+	uint8_t bit;
+	CHIP_SWM_PIN_FIXED_T fixedPin;
+} ANALOG_PIN_T;
+
+static const ADC_DUAL_PAIR_T adcPairs[] = BOARD_ADC_PAIRS;
+static const ANALOG_PIN_T adcPairPins[] = BOARD_ADC_PAIR_PINS;
+
+#define ADC_PAIR_COUNT      (sizeof(adcPairs) / sizeof(adcPairs[0]))
+#endif
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+void USB_IRQHandler(void)
+{
+#if defined(APP_USB_VCOM)
+	uint32_t start = CycleCount_Get();
+
+	ADC_Time_SofIrq();
+	USBD_API->hw->ISR(g_hUsb);
+	/* Data queued while the IN endpoint was idle */
+	vcom_tx_irq();
+
+	usbIrqCycles += CycleCount_Get() - start;
+	usbIrqCount++;
+#else
+	ADC_Time_SofIrq();
+	USBD_API->hw->ISR(g_hUsb);
+#endif
+}
+
+/* Find the address of interface descriptor for given class type. */
+USB_INTERFACE_DESCRIPTOR *find_IntfDesc(const uint8_t *pDesc, uint32_t intfClass)
+{
+	USB_COMMON_DESCRIPTOR *pD;
+	USB_INTERFACE_DESCRIPTOR *pIntfDesc = 0;
+	uint32_t next_desc_adr;
+
+	pD = (USB_COMMON_DESCRIPTOR *) pDesc;
+	next_desc_adr = (uint32_t) pDesc;
+
+	while (pD->bLength) {
+		/* is it interface descriptor */
+		if (pD->bDescriptorType == USB_INTERFACE_DESCRIPTOR_TYPE) {
+
+			pIntfDesc = (USB_INTERFACE_DESCRIPTOR *) pD;
+			/* did we find the right interface descriptor */
+			if (pIntfDesc->bInterfaceClass == intfClass) {
+				break;
+			}
+		}
+		pIntfDesc = 0;
+		next_desc_adr = (uint32_t) pD + pD->bLength;
+		pD = (USB_COMMON_DESCRIPTOR *) next_desc_adr;
+	}
+
+	return pIntfDesc;
+}
+
+/* Upper 8 bits of a 12-bit result */
+#define ADC_MY_RESULT(n)           (((n) >> 4) & 0xFF)
+
+#if defined(HID_STREAM)
+/* Fill the next vendor HID report, called by Mouse_Tasks() every interval */
+void showValudeADC( uint8_t *report)
+{
+	HID_Stream_FillReport(report);
+}
+
+#else
+void showValudeADC( uint8_t *report)
+{
+	int index = 1;
+	uint16_t values[ADC_READOUT_CHANNELS];
+	uint32_t valid, ovr, fresh, slot;
+
+	/* Only the channels of the sequence are read */
+	ADC_Readout_Regs(&adc1Readout, LPC_ADC1, values, &valid, &ovr);
+
+	fresh = valid | ovr;
+	while (fresh) {
+		slot = __CLZ(__RBIT(fresh));
+		fresh &= fresh - 1;
+
+		if (ovr & (1 << slot)) {
+			g_diag.adcChanOvr[1][adc1Readout.chans[slot]]++;
+		}
+
+		/* Show some ADC data */
+		DEBUGOUT("ADC%d_%d: Sample value = 0x%x (Data sample %d)\r\n", index, adc1Readout.chans[slot],
+				 values[slot], adc1Readout.chans[slot]);
+		report[0] = ADC_MY_RESULT(values[slot]) - 128;
+	}
+}
+
+#endif
+
+/* Index of the latest ADC1 conversion, used to place threshold events */
+static uint32_t adc1SampleIndex(void)
+{
+#if (ADC_MODE != ADC_MODE_SINGLE)
+	return ADC_Dual_GetSampleIndex(ADC_DUAL_ADC1);
+#elif defined(ADC_USE_DMA)
+	return ADC_DMA_GetSampleIndex(&adc1Stream);
+#else
+	return adc1SeqCount;
+#endif
+}
+
+#if defined(APP_USB_AUDIO)
+/* Stream samples converted so far, the audio clock loop compares them
+   with the samples sent */
+static uint32_t streamConverted(void)
+{
+	if (acqState == ACQ_IDLE) {
+		return 0;
+	}
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+	/* ADC1 converts every other sample of the merged stream */
+	return 2 * (adc1SampleIndex() + 1);
+#else
+	return (adc1SampleIndex() + 1) / adc1Readout.numChans;
+#endif
+}
+
+#endif
+
+/* Core cycles to microseconds */
+static uint32_t cyclesToUs(uint32_t cycles)
+{
+	return cycles / (SystemCoreClock / 1000000);
+}
+
+/* First conversion, one trigger period after the sample clock started.
+   The sysTick start is not synchronized to the sample clock start. */
+static uint32_t firstSampleCycles(void)
+{
+#if defined(ADC_USE_HW_TRIGGER)
+	return bootTimes.acqStart + (Chip_Clock_GetSystemClockRate() / ADC_Trig_GetRate());
+#else
+	return bootTimes.acqStart;
+#endif
+}
+
+#if defined(HOST_CAPTURE)
+/* Fire the capture from an ADC1 threshold event */
+static void captureEvent(const ADC_EVENT_T *pEvent)
+{
+	uint32_t index;
+
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+	/* ADC1 comes first in every merged pair */
+	index = 2 * pEvent->sampleIndex;
+#else
+	index = pEvent->sampleIndex / adc1Readout.numChans;
+#endif
+	ADC_Capture_Trigger(index, (pEvent->dir == ADC_EVENT_UP) ? ADC_CAPTURE_RISING : ADC_CAPTURE_FALLING);
+}
+
+#endif
+
+/* Forward queued threshold events, oldest first */
+static void sendEvents(void)
+{
+	ADC_EVENT_T ev;
+
+	while (ADC_Event_Peek(&ev)) {
+#if defined(APP_USB_VCOM)
+		/* Events wait in their queue until the link has room */
+		if (Link_IsConnected() &&
+			!Link_Printf("E %d %d %c %u %u %d\r\n", ev.adcNum, ev.channel,
+						 (ev.dir == ADC_EVENT_UP) ? 'U' : 'D', ev.sampleIndex, ev.timestamp, ev.value)) {
+			break;
+		}
+#else
+		DEBUGOUT("ADC%d_%d crossed %s at sample %u: 0x%x\r\n", ev.adcNum, ev.channel,
+				 (ev.dir == ADC_EVENT_UP) ? "up" : "down", ev.sampleIndex, ev.value);
+#endif
+		ADC_Event_Get(&ev);
+#if defined(HOST_CAPTURE)
+		captureEvent(&ev);
+#endif
+	}
+}
+
+/* Forward slow channel results, oldest first */
+static void sendSlowRecords(void)
+{
+	ADC_SCHED_REC_T rec;
+
+	while (ADC_Sched_Peek(&rec)) {
+#if defined(APP_USB_VCOM)
+		if (Link_IsConnected() &&
+			!Link_Printf("R %d %d %u %d\r\n", rec.adcNum, rec.channel, rec.timestamp, rec.value)) {
+			break;
+		}
+#else
+		DEBUGOUT("ADC%d_%d: 0x%x at cycle %u\r\n", rec.adcNum, rec.channel, rec.value, rec.timestamp);
+#endif
+		ADC_Sched_Get(&rec);
+	}
+}
+
+#if defined(HOST_SUMMARY)
+/* Samples per second of every summarized channel */
+static uint32_t summaryRateHz(void)
+{
+	return (ADC_MODE == ADC_MODE_INTERLEAVED) ? ADC_STREAM_RATE_HZ : ADC_SAMPLE_RATE_HZ;
+}
+
+/* Summarize the channels of the selected mode */
+static void summaryInit(void)
+{
+	ADC_SUMMARY_CHAN_T chans[ADC_SUMMARY_MAX_CHANNELS];
+	uint32_t num = 0;
+#if (ADC_MODE == ADC_MODE_SIMULTANEOUS)
+	uint32_t i;
+
+	/* Same order as the {ADC1, ADC0} pair records */
+	for (i = 0; i < ADC_PAIR_COUNT; i++) {
+		chans[num].adcNum = 1;
+		chans[num++].channel = adcPairs[i].adc1Ch;
+		chans[num].adcNum = 0;
+		chans[num++].channel = adcPairs[i].adc0Ch;
+	}
+#elif (ADC_MODE == ADC_MODE_INTERLEAVED)
+	/* One merged stream, named after its ADC1 input */
+	chans[num].adcNum = 1;
+	chans[num++].channel = BOARD_ADC_CH;
+#else
+	uint32_t mask = ADC1_SEQA_CHANNELS, ch;
+
+	/* Same order as the readout slots */
+	while (mask) {
+		ch = __CLZ(__RBIT(mask));
+		mask &= mask - 1;
+		chans[num].adcNum = 1;
+		chans[num++].channel = ch;
+	}
+#endif
+	ADC_Summary_Init(chans, num, (HOST_SUMMARY_WINDOW_MS * summaryRateHz()) / 1000);
+}
+
+/* Forward window summaries, oldest first */
+static void sendSummaries(void)
+{
+	ADC_SUMMARY_REC_T rec;
+
+	while (ADC_Summary_Peek(&rec)) {
+		if (Link_IsConnected() &&
+			!Link_Printf("W %d %d %u %u %u %u %u %u\r\n", rec.adcNum, rec.channel, rec.seq, rec.count,
+						 rec.min, rec.max, rec.mean, rec.rms)) {
+			break;
+		}
+		ADC_Summary_Get(&rec);
+	}
+}
+
+#endif
+
+#if defined(HOST_PACK)
+/* Encoder budget in cycles per sample */
+static uint32_t packBudget(void)
+{
+	return ((SystemCoreClock / ADC_STREAM_RATE_HZ) * HOST_PACK_BUDGET_PCT) / 100;
+}
+
+/* Pack one raw block for the host, a block still being sent drops it */
+static void packBlock(const uint16_t *pSamples, uint32_t count)
+{
+	uint32_t start, perSample;
+
+	if ((packLen != 0) || (count == 0) || (count > HOST_PACK_MAX_SAMPLES)) {
+		packDropped++;
+		g_diag.streamDrops += count;
+		Link_Dropped();
+	}
+	else {
+		start = CycleCount_Get();
+		packLen = DSP_Rice_Encode(pSamples, count, packBuf);
+		perSample = ((CycleCount_Get() - start) * 100) / count;
+		CycleStat_Add(&packCycles, start, count);
+
+		Diag_HighWater(&packWorst, perSample);
+		if (perSample > (packBudget() * 100)) {
+			packOverBudget++;
+		}
+		packBlocks++;
+		packInBytes += 2 * count;
+		packOutBytes += packLen;
+
+		packSamples = count;
+		packStart = packIndex;
+		packSent = 0;
+		packHeaderSent = false;
+	}
+	packIndex += count;
+}
+
+/* Send the packed block, ahead of the sample stream */
+static void sendPacked(void)
+{
+	static const char hexDigit[] = "0123456789ABCDEF";
+	char record[LINK_RECORD_MAX];
+	uint32_t i, n, len;
+
+	while (packLen != 0) {
+		if (!packHeaderSent) {
+			if (!Link_Printf("K %u %u %u\r\n", packStart, packSamples, packLen)) {
+				return;
+			}
+			packHeaderSent = true;
+		}
+		if (Link_GetFree() < (LINK_RECORD_MAX + HOST_EVENT_HEADROOM)) {
+			return;
+		}
+
+		n = packLen - packSent;
+		if (n > HOST_PACK_PER_RECORD) {
+			n = HOST_PACK_PER_RECORD;
+		}
+		len = sprintf(record, "Z %u ", packSent);
+		for (i = 0; i < n; i++) {
+			record[len++] = hexDigit[packBuf[packSent + i] >> 4];
+			record[len++] = hexDigit[packBuf[packSent + i] & 0xF];
+		}
+		record[len++] = '\r';
+		record[len++] = '\n';
+		Link_Write(record, len);
+		packSent += n;
+
+		if (packSent == packLen) {
+			packLen = 0;
+		}
+	}
+}
+
+#endif
+
+#if defined(HOST_FRAMES)
+#if defined(HOST_FRAME_ZERO_COPY)
+/* A frame block is sent, back to the pool from the USB interrupt */
+static void frameDone(uint8_t *pBlock)
+{
+	FramePool_Free(pBlock);
+}
+
+/* Build a frame in a pool block and queue it in place */
+static bool queueFrame(const FRAME_INFO_T *pInfo, const uint16_t *pSamples, uint32_t count)
+{
+	uint8_t *pFrame = (pFrameSpare != NULL) ? pFrameSpare : FramePool_Alloc();
+	uint32_t len;
+
+	if (pFrame == NULL) {
+		return false;
+	}
+	len = Frame_Build(pFrame, pInfo, pSamples, count);
+	if (vcom_write_block(pFrame, len, frameDone) != LPC_OK) {
+		/* Only the interrupt frees blocks, this one waits for the next frame */
+		pFrameSpare = pFrame;
+		return false;
+	}
+	pFrameSpare = NULL;
+	return true;
+}
+
+#else
+/* Build a frame and copy it into the TX ring */
+static bool queueFrame(const FRAME_INFO_T *pInfo, const uint16_t *pSamples, uint32_t count)
+{
+	uint32_t len;
+
+	if (Link_GetFree() < (FRAME_BYTES(count) + HOST_EVENT_HEADROOM)) {
+		return false;
+	}
+	len = Frame_Build(frameBuf, pInfo, pSamples, count);
+	return Link_Write(frameBuf, len);
+}
+
+#endif
+
+/* Send raw samples as binary frames, frames that do not fit are dropped */
+static void sendFrames(const uint16_t *pSamples, uint32_t count)
+{
+	FRAME_INFO_T info;
+	uint32_t start, n;
+
+	info.type = FRAME_TYPE_SAMPLES12;
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+	info.chanMask = FRAME_CHAN_ADC0(BOARD_ADC_CH) | FRAME_CHAN_ADC1(BOARD_ADC_CH);
+#else
+	info.chanMask = FRAME_CHAN_ADC1(BOARD_ADC_CH);
+#endif
+
+	while (count) {
+		n = (count < HOST_FRAME_SAMPLES) ? count : HOST_FRAME_SAMPLES;
+		info.flags = frameGap ? FRAME_FLAG_GAP : 0;
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+		info.flags |= FRAME_FLAG_INTERLEAVED;
+#endif
+		if (frameTimeSof) {
+			info.flags |= FRAME_FLAG_SOF;
+		}
+		info.seq = frameSeq;
+		info.timestamp = frameIndex;
+		info.time = frameTime;
+
+		start = CycleCount_Get();
+		if (queueFrame(&info, pSamples, n)) {
+			CycleStat_Add(&frameCycles, start, FRAME_BYTES(n));
+			frameCount++;
+			frameGap = false;
+		}
+		else {
+			/* The sequence number still counts, the host sees the gap */
+			frameDropped++;
+			g_diag.streamDrops += n;
+			Link_Dropped();
+			frameGap = true;
+		}
+		frameSeq++;
+		frameIndex += n;
+		pSamples += n;
+		count -= n;
+	}
+}
+
+/* Take the time reference of the next count samples sent, lag is the
+   number of samples from the last of them to the reference */
+static void setFrameTime(const ADC_TIME_MARK_T *pMark, uint32_t count, int32_t lag)
+{
+	frameTime.index = frameIndex + count - 1 + lag;
+	frameTime.cycles = pMark->cycles;
+	frameTime.sofFrame = pMark->sofFrame;
+	frameTime.sofCycles = pMark->sofCycles;
+	frameTimeSof = pMark->sofValid;
+}
+
+#endif
+
+#if defined(APP_USB_VCOM)
+#if (ADC_MODE != ADC_MODE_SIMULTANEOUS) && defined(ADC_USE_DMA)
+/* Stream filtered samples, records that do not fit are dropped */
+static void sendSamples(const int16_t *pSamples, uint32_t count)
+{
+	char record[LINK_RECORD_MAX];
+	uint32_t i, n, len;
+
+	while (count) {
+		n = (count < HOST_SAMPLES_PER_RECORD) ? count : HOST_SAMPLES_PER_RECORD;
+		len = sprintf(record, "S %u", streamIndex);
+		for (i = 0; i < n; i++) {
+			len += sprintf(&record[len], " %d", pSamples[i]);
+		}
+		record[len++] = '\r';
+		record[len++] = '\n';
+
+		if (Link_GetFree() >= (len + HOST_EVENT_HEADROOM)) {
+			Link_Write(record, len);
+		}
+		else {
+			g_diag.streamDrops += n;
+			Link_Dropped();
+		}
+		streamIndex += n;
+		pSamples += n;
+		count -= n;
+	}
+}
+
+/* Burst a completed capture window, ahead of the sample stream */
+static void sendCapture(void)
+{
+	static const char hexDigit[] = "0123456789ABCDEF";
+	uint16_t samples[HOST_CAPTURE_PER_RECORD];
+	char record[LINK_RECORD_MAX];
+	uint32_t i, n, len;
+
+	while (ADC_Capture_GetState() == ADC_CAPTURE_READY) {
+		if (!captureHeaderSent) {
+			if (!Link_Printf("T %u %u %u %u\r\n", captureSeq, ADC_Capture_GetTriggerIndex(),
+							 captureCfg.pre, captureCfg.post)) {
+				return;
+			}
+			captureHeaderSent = true;
+			captureSent = 0;
+		}
+		if (Link_GetFree() < (LINK_RECORD_MAX + HOST_EVENT_HEADROOM)) {
+			return;
+		}
+
+		n = ADC_Capture_Read(samples, HOST_CAPTURE_PER_RECORD);
+		len = sprintf(record, "X %u ", captureSent);
+		for (i = 0; i < n; i++) {
+			record[len++] = hexDigit[(samples[i] >> 8) & 0xF];
+			record[len++] = hexDigit[(samples[i] >> 4) & 0xF];
+			record[len++] = hexDigit[samples[i] & 0xF];
+		}
+		record[len++] = '\r';
+		record[len++] = '\n';
+		Link_Write(record, len);
+		captureSent += n;
+
+		/* Read out, the capture is already armed again if asked to */
+		if (ADC_Capture_GetState() != ADC_CAPTURE_READY) {
+			captureSeq++;
+			captureHeaderSent = false;
+		}
+	}
+}
+
+#if defined(HOST_SPECTRUM)
+/* Send a completed spectrum, ahead of the sample stream */
+static void sendSpectrum(void)
+{
+	static const char hexDigit[] = "0123456789ABCDEF";
+	const ADC_SPECTRUM_CFG_T *pCfg = ADC_Spectrum_GetConfig();
+	const uint16_t *pBins;
+	char record[LINK_RECORD_MAX];
+	uint32_t i, n, len, seq, numBins = pCfg->size / 2;
+
+	while ((pBins = ADC_Spectrum_GetBins(&seq)) != NULL) {
+		if (!spectrumHeaderSent) {
+			if (!Link_Printf("P %u %u %s %u %u\r\n", seq, pCfg->size, windowNames[pCfg->window],
+							 pCfg->average, (ADC_STREAM_RATE_HZ * 1000) / pCfg->size)) {
+				return;
+			}
+			spectrumHeaderSent = true;
+			spectrumSent = 0;
+		}
+		if (Link_GetFree() < (LINK_RECORD_MAX + HOST_EVENT_HEADROOM)) {
+			return;
+		}
+
+		n = numBins - spectrumSent;
+		if (n > HOST_SPECTRUM_PER_RECORD) {
+			n = HOST_SPECTRUM_PER_RECORD;
+		}
+		len = sprintf(record, "F %u ", spectrumSent);
+		for (i = 0; i < n; i++) {
+			record[len++] = hexDigit[(pBins[spectrumSent + i] >> 12) & 0xF];
+			record[len++] = hexDigit[(pBins[spectrumSent + i] >> 8) & 0xF];
+			record[len++] = hexDigit[(pBins[spectrumSent + i] >> 4) & 0xF];
+			record[len++] = hexDigit[pBins[spectrumSent + i] & 0xF];
+		}
+		record[len++] = '\r';
+		record[len++] = '\n';
+		Link_Write(record, len);
+		spectrumSent += n;
+
+		if (spectrumSent == numBins) {
+			ADC_Spectrum_Release();
+			spectrumHeaderSent = false;
+		}
+	}
+}
+
+#endif
+
+#endif
+
+/* mode events|stream|spectrum|summary|packed|binary */
+static void cmdMode(const char *pArgs)
+{
+	if (strcmp(pArgs, "events") == 0) {
+		hostMode = HOST_MODE_EVENTS;
+	}
+#if (ADC_MODE != ADC_MODE_SIMULTANEOUS) && defined(ADC_USE_DMA)
+	else if (strcmp(pArgs, "stream") == 0) {
+		hostMode = HOST_MODE_STREAM;
+	}
+#endif
+#if defined(HOST_SPECTRUM)
+	else if (strcmp(pArgs, "spectrum") == 0) {
+		/* Start on a fresh frame, samples seen before are not contiguous */
+		ADC_Spectrum_Config(ADC_Spectrum_GetConfig());
+		spectrumHeaderSent = false;
+		hostMode = HOST_MODE_SPECTRUM;
+	}
+#endif
+#if defined(HOST_SUMMARY)
+	else if (strcmp(pArgs, "summary") == 0) {
+		/* Windows start with the mode */
+		ADC_Summary_SetWindow(ADC_Summary_GetWindow());
+		hostMode = HOST_MODE_SUMMARY;
+	}
+#endif
+#if defined(HOST_PACK)
+	else if (strcmp(pArgs, "packed") == 0) {
+		hostMode = HOST_MODE_PACKED;
+	}
+#endif
+#if defined(HOST_FRAMES)
+	else if (strcmp(pArgs, "binary") == 0) {
+		hostMode = HOST_MODE_BINARY;
+	}
+#endif
+	else {
+		Link_Printf("ERR mode %s\r\n", pArgs);
+		return;
+	}
+	Link_Printf("OK\r\n");
+}
+
+/* thr <low> <high> */
+static void cmdThreshold(const char *pArgs)
+{
+	unsigned int low, high;
+
+	if ((sscanf(pArgs, "%u %u", &low, &high) != 2) || (low > high) || (high > 0xFFF)) {
+		Link_Printf("ERR thr <low> <high>, 0..4095\r\n");
+		return;
+	}
+	ADC_Event_SetThresholds(LPC_ADC1, low, high);
+	Link_Printf("OK\r\n");
+}
+
+#if defined(HOST_CAPTURE)
+/* cap level|slope|thr <r|f|b> <value> [pre] [post] [auto], cap off */
+static void cmdCapture(const char *pArgs)
+{
+	ADC_CAPTURE_CFG_T cfg;
+	char src[8], edge, opt[8] = "";
+	int value;
+	unsigned int pre = (HOST_CAPTURE_PRE_MS * ADC_STREAM_RATE_HZ) / 1000;
+	unsigned int post = (HOST_CAPTURE_POST_MS * ADC_STREAM_RATE_HZ) / 1000;
+
+	if (strcmp(pArgs, "off") == 0) {
+		ADC_Capture_Disarm();
+		captureHeaderSent = false;
+		Link_Printf("OK\r\n");
+		return;
+	}
+
+	if (sscanf(pArgs, "%7s %c %d %u %u %7s", src, &edge, &value, &pre, &post, opt) < 3) {
+		Link_Printf("ERR cap level|slope|thr <r|f|b> <value> [pre] [post] [auto]\r\n");
+		return;
+	}
+
+	if (strcmp(src, "level") == 0) {
+		cfg.source = ADC_CAPTURE_LEVEL;
+	}
+	else if (strcmp(src, "slope") == 0) {
+		cfg.source = ADC_CAPTURE_SLOPE;
+	}
+	else if (strcmp(src, "thr") == 0) {
+		cfg.source = ADC_CAPTURE_EXTERNAL;
+	}
+	else {
+		Link_Printf("ERR cap %s\r\n", src);
+		return;
+	}
+
+	cfg.edge = (edge == 'r') ? ADC_CAPTURE_RISING : (edge == 'f') ? ADC_CAPTURE_FALLING : ADC_CAPTURE_BOTH;
+	cfg.level = value;
+	cfg.pre = pre;
+	cfg.post = post;
+	cfg.autoArm = (strcmp(opt, "auto") == 0);
+
+	/* A window being sent is dropped */
+	captureHeaderSent = false;
+	if (!ADC_Capture_Arm(&cfg)) {
+		Link_Printf("ERR cap window over %u samples\r\n", ADC_CAPTURE_HISTORY);
+		return;
+	}
+	captureCfg = cfg;
+	Link_Printf("OK\r\n");
+}
+
+#endif
+
+/* info */
+static void cmdInfo(const char *pArgs)
+{
+	static const char *const modeNames[] = {"events", "stream", "spectrum", "summary", "packed", "binary"};
+
+	Link_Printf("I core %u Hz, sample %u Hz, mode %s\r\n", SystemCoreClock, ADC_SAMPLE_RATE_HZ,
+				modeNames[hostMode]);
+}
+
+/* Per-channel overrun counts of a stats snapshot, 6 channels per record
+   after the first channel */
+static void printChanOverruns(const DIAG_STATS_T *pSnap, uint32_t num)
+{
+	const uint32_t *pOvr = pSnap->adcChanOvr[num];
+	uint32_t first;
+
+	for (first = 0; first < DIAG_ADC_CHANNELS; first += 6) {
+		Link_Printf("C adc%u_ovr %u %u %u %u %u %u %u\r\n", num, first,
+					pOvr[first], pOvr[first + 1], pOvr[first + 2],
+					pOvr[first + 3], pOvr[first + 4], pOvr[first + 5]);
+	}
+}
+
+/* stats [reset] */
+static void cmdStats(const char *pArgs)
+{
+	/* Snapshot first so that the lines are consistent with each other */
+	DIAG_STATS_T snap = g_diag;
+
+	if (strcmp(pArgs, "reset") == 0) {
+		Diag_Reset();
+		Link_Printf("OK\r\n");
+		return;
+	}
+	if (*pArgs != 0) {
+		Link_Printf("ERR stats [reset]\r\n");
+		return;
+	}
+
+	printChanOverruns(&snap, 0);
+	printChanOverruns(&snap, 1);
+	Link_Printf("C seq_ovr %u %u %u %u\r\n", snap.adcSeqOvr[0][ADC_SEQA_IDX], snap.adcSeqOvr[0][ADC_SEQB_IDX],
+				snap.adcSeqOvr[1][ADC_SEQA_IDX], snap.adcSeqOvr[1][ADC_SEQB_IDX]);
+	Link_Printf("C dma_blocks_lost %u\r\n", snap.dmaBlocksLost);
+	Link_Printf("C events_lost %u\r\n", snap.eventsLost);
+	Link_Printf("C usb_tx_full %u\r\n", snap.usbTxFull);
+	Link_Printf("C stream_drops %u\r\n", snap.streamDrops);
+	Link_Printf("C hwm dma_backlog %u event_queue %u/%u link_fifo %u/%u\r\n", snap.dmaBacklogMax,
+				snap.eventQueueMax, ADC_EVENT_QUEUE_LEN, snap.linkFifoMax, LINK_TX_FIFO_SZ);
+	Link_Printf("C recal %u pause_max_us %u\r\n", snap.recalPauses, cyclesToUs(snap.recalPauseMax));
+	Link_Printf("C sched records_lost %u retries %u\r\n", snap.schedRecordsLost, snap.schedRetries);
+	Link_Printf("C summary records_lost %u\r\n", snap.summaryRecordsLost);
+#if defined(HOST_CAPTURE)
+	Link_Printf("C capture %u late %u skipped %u\r\n", ADC_Capture_GetStats()->captures,
+				ADC_Capture_GetStats()->lateTriggers, ADC_Capture_GetStats()->skipped);
+#endif
+}
+
+/* Sum the cycles elapsed for "usb", called from the main loop */
+static void usbPerfPoll(void)
+{
+	uint32_t now = CycleCount_Get();
+
+	usbPerfElapsed += now - usbPerfLast;
+	usbPerfLast = now;
+}
+
+/* usb [reset] */
+static void cmdUsb(const char *pArgs)
+{
+	uint32_t bytes, xfers, irqCycles, rate, irqRate, perKb, load;
+	uint64_t elapsed;
+
+	usbPerfPoll();
+	if (strcmp(pArgs, "reset") == 0) {
+		g_vCOM.tx_bytes = 0;
+		g_vCOM.tx_xfers = 0;
+		g_vCOM.tx_zlps = 0;
+		g_vCOM.ntf_sent = 0;
+		usbIrqCycles = 0;
+		usbIrqCount = 0;
+		usbPerfElapsed = 0;
+		Link_Printf("OK\r\n");
+		return;
+	}
+	if (*pArgs != 0) {
+		Link_Printf("ERR usb [reset]\r\n");
+		return;
+	}
+
+	bytes = g_vCOM.tx_bytes;
+	xfers = g_vCOM.tx_xfers;
+	irqCycles = usbIrqCycles;
+	elapsed = usbPerfElapsed;
+	rate = elapsed ? (uint32_t) (((uint64_t) bytes * SystemCoreClock) / elapsed) : 0;
+	irqRate = elapsed ? (uint32_t) (((uint64_t) usbIrqCount * SystemCoreClock) / elapsed) : 0;
+	perKb = bytes ? (uint32_t) (((uint64_t) irqCycles * 1024) / bytes) : 0;
+	load = elapsed ? (uint32_t) (((uint64_t) irqCycles * 10000) / elapsed) : 0;
+
+	Link_Printf("I usb tx %u bytes in %u transfers, %u zlp, up to %u bytes each\r\n", bytes, xfers,
+				g_vCOM.tx_zlps, VCOM_TX_XFER_MAX);
+	Link_Printf("I usb tx %u B/s, %u irq/s, %u irq cycles per KB, load %u.%02u%%\r\n", rate, irqRate, perKb,
+				load / 100, load % 100);
+	Link_Printf("I usb notify %u sent, %u drops reported since boot\r\n", g_vCOM.ntf_sent, g_vCOM.tx_drops);
+}
+
+#if defined(HOST_SPECTRUM)
+/* fft [<size> [rect|hann|hamming|blackman] [average]] */
+static void cmdFft(const char *pArgs)
+{
+	ADC_SPECTRUM_CFG_T cfg = *ADC_Spectrum_GetConfig();
+	const ADC_SPECTRUM_STATS_T *pStats = ADC_Spectrum_GetStats();
+	char win[12];
+	unsigned int size, average;
+	uint32_t w;
+	int n;
+
+	if (*pArgs == 0) {
+		Link_Printf("I fft %u %s avg %u frames %u spectra %u dropped %u\r\n", cfg.size,
+					windowNames[cfg.window], cfg.average, pStats->frames, pStats->spectra, pStats->dropped);
+		Link_Printf("I fft cycles per frame last %u max %u (%u us)\r\n", pStats->cyclesLast,
+					pStats->cyclesMax, cyclesToUs(pStats->cyclesMax));
+		return;
+	}
+
+	n = sscanf(pArgs, "%u %11s %u", &size, win, &average);
+	cfg.size = size;
+	if (n >= 2) {
+		for (w = 0; (w < DSP_FFT_WIN_COUNT) && (strcmp(win, windowNames[w]) != 0); w++) {}
+		cfg.window = (DSP_FFT_WINDOW_T) w;
+	}
+	if (n >= 3) {
+		cfg.average = average;
+	}
+	if ((n < 1) || !ADC_Spectrum_Config(&cfg)) {
+		Link_Printf("ERR fft <%u..%u> [rect|hann|hamming|blackman] [1..%u]\r\n", DSP_FFT_MIN_SIZE,
+					DSP_FFT_MAX_SIZE, ADC_SPECTRUM_MAX_AVERAGE);
+		return;
+	}
+	spectrumHeaderSent = false;
+	Link_Printf("OK\r\n");
+}
+
+#endif
+
+#if defined(HOST_SUMMARY)
+/* win [<ms>] */
+static void cmdWindow(const char *pArgs)
+{
+	unsigned int ms;
+	uint32_t perSample;
+
+	if (*pArgs == 0) {
+		perSample = CycleStat_Take(&summaryCycles);
+		Link_Printf("I win %u ms, %u samples per channel, %u.%02u cycles per sample\r\n",
+					(ADC_Summary_GetWindow() * 1000) / summaryRateHz(), ADC_Summary_GetWindow(),
+					perSample / 100, perSample % 100);
+		return;
+	}
+	if ((sscanf(pArgs, "%u", &ms) != 1) || (ms == 0) ||
+		!ADC_Summary_SetWindow((ms * summaryRateHz()) / 1000)) {
+		Link_Printf("ERR win <1..%u ms>\r\n", (ADC_SUMMARY_MAX_WINDOW * 1000) / summaryRateHz());
+		return;
+	}
+	Link_Printf("OK\r\n");
+}
+
+#endif
+
+#if defined(HOST_PACK)
+/* pack [reset] */
+static void cmdPack(const char *pArgs)
+{
+	uint32_t perSample, ratio;
+
+	if (strcmp(pArgs, "reset") == 0) {
+		CycleStat_Take(&packCycles);
+		packWorst = 0;
+		packOverBudget = 0;
+		packBlocks = 0;
+		packDropped = 0;
+		packInBytes = 0;
+		packOutBytes = 0;
+		Link_Printf("OK\r\n");
+		return;
+	}
+	if (*pArgs != 0) {
+		Link_Printf("ERR pack [reset]\r\n");
+		return;
+	}
+
+	perSample = CycleStat_Take(&packCycles);
+	ratio = packOutBytes ? (uint32_t) ((packInBytes * 100) / packOutBytes) : 0;
+	Link_Printf("I pack blocks %u dropped %u ratio %u.%02u vs 16-bit\r\n", packBlocks, packDropped,
+				ratio / 100, ratio % 100);
+	Link_Printf("I pack cycles per sample %u.%02u worst %u.%02u budget %u over %u\r\n", perSample / 100,
+				perSample % 100, packWorst / 100, packWorst % 100, packBudget(), packOverBudget);
+}
+
+#endif
+
+#if defined(HOST_FRAMES)
+/* frames [reset] */
+static void cmdFrames(const char *pArgs)
+{
+	uint32_t perKb;
+
+	if (strcmp(pArgs, "reset") == 0) {
+		CycleStat_Take(&frameCycles);
+		frameCount = 0;
+		frameDropped = 0;
+		Link_Printf("OK\r\n");
+		return;
+	}
+	if (*pArgs != 0) {
+		Link_Printf("ERR frames [reset]\r\n");
+		return;
+	}
+
+	/* 1/100 cycle per byte to cycles per KB */
+	perKb = (CycleStat_Take(&frameCycles) * 1024) / 100;
+#if defined(HOST_FRAME_ZERO_COPY)
+	Link_Printf("I frames sent %u dropped %u pool low %u/%u\r\n", frameCount, frameDropped,
+				FramePool_GetLowWater(), FRAME_POOL_BLOCKS);
+	Link_Printf("I frames cycles per KB %u, in place\r\n", perKb);
+#else
+	Link_Printf("I frames sent %u dropped %u\r\n", frameCount, frameDropped);
+	Link_Printf("I frames cycles per KB %u, copied\r\n", perKb);
+#endif
+}
+
+#endif
+
+#if (ADC1_CTRL_CHANNELS != 0)
+/* ctrl [reset] */
+static void cmdCtrl(const char *pArgs)
+{
+	ADC_CTRL_STATS_T st;
+	uint32_t chans = ADC1_CTRL_CHANNELS, ch;
+
+	if (strcmp(pArgs, "reset") == 0) {
+		ADC_Ctrl_ResetStats();
+		Link_Printf("OK\r\n");
+		return;
+	}
+	if (*pArgs != 0) {
+		Link_Printf("ERR ctrl [reset]\r\n");
+		return;
+	}
+
+	ADC_Ctrl_GetStats(&st);
+	if (st.count == 0) {
+		Link_Printf("I ctrl no pass yet\r\n");
+		return;
+	}
+	Link_Printf("I ctrl passes %u overruns %u latency min %u mean %u max %u cycles, max %u ns\r\n",
+				st.count, st.overruns, st.latencyMin, (uint32_t) (st.latencySum / st.count), st.latencyMax,
+				(st.latencyMax * 1000) / (SystemCoreClock / 1000000));
+	while (chans) {
+		ch = 31 - __CLZ(chans);
+		chans &= ~(1 << ch);
+		Link_Printf("I ctrl ch %u value %u\r\n", ch, ADC_Ctrl_GetValue(ch));
+	}
+}
 
-#if defined(BOARD_KEIL_MCB1500)
-/* ADC is connected to the pot */
-#define BOARD_ADC_CH 0
-#define ANALOG_INPUT_PORT   1
-#define ANALOG_INPUT_BIT    1
-#define ANALOG_FIXED_PIN    SWM_FIXED_ADC1_0
+#endif
 
-#elif defined(BOARD_NXP_LPCXPRESSO_1549)
-/* ADC is connected to the pot on LPCXPresso base boards */
-#define BOARD_ADC_CH 1
-#define ANALOG_INPUT_PORT   0
-#define ANALOG_INPUT_BIT    9
-#define ANALOG_FIXED_PIN    SWM_FIXED_ADC1_1
+/* boot */
+static void cmdBoot(const char *pArgs)
+{
+	const ADC_CAL_CTX_T *pCal = ADC_Cal_GetContext();
+
+	Link_Printf("I boot %s cal_start %u cal_done %u usb %u acq %u sample %u block %u us\r\n",
+				warmBoot ? "warm" : "cold", cyclesToUs(bootTimes.calStart), cyclesToUs(bootTimes.calDone),
+				cyclesToUs(bootTimes.usbConnect), cyclesToUs(bootTimes.acqStart),
+				cyclesToUs(firstSampleCycles()), cyclesToUs(bootTimes.firstBlock));
+	Link_Printf("I cal %s count %u last %u us\r\n", ADC_Cal_IsValid() ? "valid" : "pending",
+				pCal->calCount, cyclesToUs(pCal->calCycles));
+}
 
-#else
-#warning "Using ADC channel 8 for this example, please select for your board"
-#define BOARD_ADC_CH 8
+static const LINK_CMD_T hostCmds[] = {
+	{"mode", cmdMode, "events|stream|spectrum|summary|packed|binary, what is sent besides replies"},
+	{"thr", cmdThreshold, "<low> <high>, ADC1 event thresholds"},
+	{"info", cmdInfo, "clock, sample rate and mode"},
+	{"stats", cmdStats, "[reset], data loss counters and high-water marks"},
+	{"boot", cmdBoot, "boot milestones and calibration state"},
+	{"usb", cmdUsb, "[reset], USB TX throughput and interrupt load"},
+#if defined(HOST_CAPTURE)
+	{"cap", cmdCapture, "level|slope|thr <r|f|b> <value> [pre] [post] [auto] | off, trigger capture"},
 #endif
+#if defined(HOST_SPECTRUM)
+	{"fft", cmdFft, "[<size> [rect|hann|hamming|blackman] [avg]], spectrum set up and cycles"},
+#endif
+#if defined(HOST_SUMMARY)
+	{"win", cmdWindow, "[<ms>], summary window and cycles"},
+#endif
+#if defined(HOST_PACK)
+	{"pack", cmdPack, "[reset], packed stream ratio and encoder cycles"},
+#endif
+#if defined(HOST_FRAMES)
+	{"frames", cmdFrames, "[reset], binary frames sent and cycles per KB"},
+#endif
+#if (ADC1_CTRL_CHANNELS != 0)
+	{"ctrl", cmdCtrl, "[reset], control channel latency and values"},
+#endif
+};
 
+#endif /* defined(APP_USB_VCOM) */
 
+#if (ADC_MODE != ADC_MODE_SIMULTANEOUS) && defined(ADC_USE_DMA)
+/* Print the cycles per sample of one processing stage */
+static void reportStage(const char *pName, CYCLE_STAT_T *pStat)
+{
+	uint32_t perSample = CycleStat_Take(pStat);
 
-/*****************************************************************************
- * Public types/enumerations/variables
- ****************************************************************************/
+	DEBUGOUT("%s: %d.%02d cycles per sample\r\n", pName, perSample / 100, perSample % 100);
+}
 
-static USBD_HANDLE_T g_hUsb;
-const  USBD_API_T *g_pUsbApi;
+/* Run the filter chain over the decimated samples, timing every kernel */
+static void filterSamples(int16_t *pSamples, uint32_t count)
+{
+	uint32_t start;
 
-/*****************************************************************************
- * Private functions
- ****************************************************************************/
+	if (adcFilter.dcEnabled) {
+		start = CycleCount_Get();
+		DSP_DcBlock_Process(&adcFilter.dc, pSamples, pSamples, count);
+		CycleStat_Add(&dcCycles, start, count);
+	}
+	if (adcFilter.notchEnabled) {
+		start = CycleCount_Get();
+		DSP_Biquad_Process(&adcFilter.notch, pSamples, pSamples, count);
+		CycleStat_Add(&notchCycles, start, count);
+	}
+	if (adcFilter.lpfEnabled) {
+		start = CycleCount_Get();
+		DSP_Fir_Process(&adcFilter.lpf, pSamples, pSamples, count);
+		CycleStat_Add(&lpfCycles, start, count);
+	}
+}
 
-void USB_IRQHandler(void)
+/* Decimate and filter one block of 12-bit samples */
+static void processSamples(const uint16_t *pSamples, uint32_t count)
 {
-	USBD_API->hw->ISR(g_hUsb);
+	uint32_t start, outCount;
+
+#if defined(HOST_CAPTURE)
+	/* Raw samples go into the capture history before decimation */
+	ADC_Capture_Write(pSamples, count);
+#endif
+#if defined(HOST_SPECTRUM)
+	/* Spectra are taken from the raw samples as well */
+	if (hostMode == HOST_MODE_SPECTRUM) {
+		ADC_Spectrum_Write(pSamples, count);
+	}
+#endif
+#if defined(HOST_PACK)
+	if (hostMode == HOST_MODE_PACKED) {
+		packBlock(pSamples, count);
+	}
+#endif
+#if defined(HOST_FRAMES)
+	if (hostMode == HOST_MODE_BINARY) {
+		sendFrames(pSamples, count);
+	}
+#endif
+#if defined(HID_STREAM)
+	g_diag.streamDrops += HID_Stream_Write(pSamples, count);
+#endif
+#if defined(APP_USB_AUDIO)
+	UAC_Stream_Write(pSamples, count);
+#endif
+
+	start = CycleCount_Get();
+	outCount = ADC_Decim_Process(&adcDecim, pSamples, count, decimOut);
+	CycleStat_Add(&decimCycles, start, count);
+
+	if (outCount) {
+		filterSamples(decimOut, outCount);
+#if defined(APP_USB_VCOM)
+		if (hostMode == HOST_MODE_STREAM) {
+			sendSamples(decimOut, outCount);
+		}
+#endif
+	}
+
+	if (++perfBlocks >= ADC_PERF_REPORT_BLOCKS) {
+		perfBlocks = 0;
+		DEBUGOUT("Decimation x%d, filter at %d Hz, last value = %d\r\n",
+				 ADC_Decim_GetRatio(&adcDecim), ADC_FILTER_FS_HZ, outCount ? decimOut[outCount - 1] : 0);
+		reportStage("CIC decimator (per input)", &decimCycles);
+		reportStage("DC blocker Q31", &dcCycles);
+		reportStage("Notch biquad Q31", &notchCycles);
+		reportStage("Low-pass FIR Q15", &lpfCycles);
+#if defined(HOST_SPECTRUM)
+		if (hostMode == HOST_MODE_SPECTRUM) {
+			DEBUGOUT("FFT %d: %d cycles per frame, worst %d\r\n", ADC_Spectrum_GetConfig()->size,
+					 ADC_Spectrum_GetStats()->cyclesLast, ADC_Spectrum_GetStats()->cyclesMax);
+		}
+#endif
+#if defined(APP_USB_AUDIO)
+		/* Trim in ppm, 10^6 / 2^24 = 15625 / 2^18 */
+		DEBUGOUT("Audio: trim %d ppm, error %d (max %d), underruns %u, inserted %u, resyncs %u\r\n",
+				 (UAC_Stream_GetTrim() * 15625) / (1 << 18), UAC_Stream_GetStats()->error,
+				 UAC_Stream_GetStats()->errorMax, UAC_Stream_GetStats()->underruns,
+				 UAC_Stream_GetStats()->inserted, UAC_Stream_GetStats()->resyncs);
+#endif
+	}
 }
 
-/* Find the address of interface descriptor for given class type. */
-USB_INTERFACE_DESCRIPTOR *find_IntfDesc(const uint8_t *pDesc, uint32_t intfClass)
+#endif
+
+#if (ADC_MODE == ADC_MODE_SINGLE) && defined(ADC_USE_DMA)
+/* Handle one block of raw ADC1 samples captured by DMA */
+static void processBlock(const uint32_t *pBlock, uint32_t count)
 {
-	USB_COMMON_DESCRIPTOR *pD;
-	USB_INTERFACE_DESCRIPTOR *pIntfDesc = 0;
-	uint32_t next_desc_adr;
+	uint32_t slot = ADC_Readout_SlotOf(&adc1Readout, BOARD_ADC_CH);
+#if defined(HOST_SUMMARY)
+	uint32_t start, s;
+#endif
+#if defined(HOST_FRAMES)
+	const ADC_TIME_MARK_T *pMark = ADC_DMA_GetMark(&adc1Stream);
+	uint32_t n = adc1Readout.numChans;
+#endif
 
-	pD = (USB_COMMON_DESCRIPTOR *) pDesc;
-	next_desc_adr = (uint32_t) pDesc;
+	ADC_Readout_Block(&adc1Readout, pBlock, count, &adc1Soa);
+#if defined(HOST_FRAMES)
+	/* Conversions follow the slots, every sequence is one trigger edge */
+	setFrameTime(pMark, adc1Soa.len[slot], (int32_t) ((pMark->index / n) - ((pMark->blockEnd - slot) / n)));
+#endif
+#if defined(HOST_SUMMARY)
+	/* Every channel of the sequence is summarized */
+	if (hostMode == HOST_MODE_SUMMARY) {
+		start = CycleCount_Get();
+		for (s = 0; s < adc1Readout.numChans; s++) {
+			ADC_Summary_Write(s, ADC_Readout_Slot(&adc1Readout, &adc1Soa, s), adc1Soa.len[s], 1);
+		}
+		CycleStat_Add(&summaryCycles, start, count);
+	}
+#endif
+	processSamples(ADC_Readout_Slot(&adc1Readout, &adc1Soa, slot), adc1Soa.len[slot]);
+}
 
-	while (pD->bLength) {
-		/* is it interface descriptor */
-		if (pD->bDescriptorType == USB_INTERFACE_DESCRIPTOR_TYPE) {
+#endif
 
-			pIntfDesc = (USB_INTERFACE_DESCRIPTOR *) pD;
-			/* did we find the right interface descriptor */
-			if (pIntfDesc->bInterfaceClass == intfClass) {
-				break;
-			}
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+/* Handle one block of interleaved ADC1/ADC0 samples */
+static void processDualBlock(const uint16_t *pBlock, uint32_t count)
+{
+	ADC_DUAL_MATCH_T est;
+#if defined(HOST_SUMMARY)
+	uint32_t start;
+#endif
+#if defined(HOST_FRAMES)
+	const ADC_TIME_MARK_T *pMark = ADC_Dual_GetMark();
+
+	/* ADC1 conversion i is sample 2i, the block ends on an ADC0 sample */
+	setFrameTime(pMark, count, (int32_t) ((2 * pMark->index) - ((2 * pMark->blockEnd) + 1)));
+#endif
+
+	/* Track the ADC0 mismatch slowly so noise does not modulate it */
+	if (ADC_Dual_EstimateMatch(&est)) {
+		adc0Match.offset += (est.offset - adc0Match.offset) / 16;
+		adc0Match.gain += (est.gain - adc0Match.gain) / 16;
+		ADC_Dual_SetMatch(ADC_DUAL_ADC0, &adc0Match);
+	}
+
+#if defined(HOST_SUMMARY)
+	if (hostMode == HOST_MODE_SUMMARY) {
+		start = CycleCount_Get();
+		ADC_Summary_Write(0, pBlock, count, 1);
+		CycleStat_Add(&summaryCycles, start, count);
+	}
+#endif
+	processSamples(pBlock, count);
+}
+
+#elif (ADC_MODE == ADC_MODE_SIMULTANEOUS)
+/* Handle one block of {ADC1, ADC0} pair records */
+static void processDualBlock(const uint16_t *pBlock, uint32_t count)
+{
+	const uint16_t *pLast = &pBlock[count - (2 * ADC_PAIR_COUNT)];
+	uint32_t i;
+#if defined(HOST_SUMMARY)
+	uint32_t start;
+
+	/* Every converter of every pair is summarized, straight from the records */
+	if (hostMode == HOST_MODE_SUMMARY) {
+		start = CycleCount_Get();
+		for (i = 0; i < (2 * ADC_PAIR_COUNT); i++) {
+			ADC_Summary_Write(i, &pBlock[i], count / (2 * ADC_PAIR_COUNT), 2 * ADC_PAIR_COUNT);
 		}
-		pIntfDesc = 0;
-		next_desc_adr = (uint32_t) pD + pD->bLength;
-		pD = (USB_COMMON_DESCRIPTOR *) next_desc_adr;
+		CycleStat_Add(&summaryCycles, start, count);
+		return;
 	}
+#endif
 
-	return pIntfDesc;
+	/* Show the last record of every pair */
+	for (i = 0; i < ADC_PAIR_COUNT; i++) {
+		DEBUGOUT("ADC0_%d/ADC1_%d: 0x%x/0x%x\r\n", adcPairs[i].adc0Ch, adcPairs[i].adc1Ch,
+				 pLast[(2 * i) + 1], pLast[2 * i]);
+	}
 }
 
-#define ADC_MY_RESULT(n)           ((((n) >> 8) & 0xFF))
+#endif
 
-void showValudeADC( uint8_t *report)
+/* Start the sequencers and the sample clock of the selected mode */
+static void startAcquisition(void)
 {
-	int index = 1, j;
-	uint32_t rawSample;
+#if (ADC_MODE == ADC_MODE_SIMULTANEOUS)
+	uint32_t adc0Chans, adc1Chans;
+#endif
 
-	/* Get raw sample data for channels 0-11 */
-	for (j = 0; j < 12; j++)
-	{
-		rawSample = Chip_ADC_GetDataReg(LPC_ADC1, j);
+#if (ADC_MODE == ADC_MODE_INTERLEAVED)
+	/* ADC0 and ADC1 sample the same input half a trigger period apart,
+	   the sequence interrupts only request DMA transfers */
+	ADC_Trig_Init();
+	ADC_DMA_Init();
+	ADC_Dual_Start(ADC_SEQ_CTRL_CHANSEL(BOARD_ADC0_CH), ADC_SEQ_CTRL_CHANSEL(BOARD_ADC_CH),
+				   ADC_TRIG_PHASE_180, ADC_SAMPLE_RATE_HZ);
+	ADC_Readout_Init(&adc1Readout, ADC_SEQ_CTRL_CHANSEL(BOARD_ADC_CH), ADC_DMA_BLOCK_SAMPLES);
+#elif (ADC_MODE == ADC_MODE_SIMULTANEOUS)
+	/* One SCT event starts both sequencers, pair n is converted in step n
+	   of both sequences at the same time */
+	if (!ADC_Dual_PairMasks(adcPairs, ADC_PAIR_COUNT, &adc0Chans, &adc1Chans)) {
+		DEBUGSTR("Invalid BOARD_ADC_PAIRS list\r\n");
+		while (1) {}
+	}
+	ADC_Trig_Init();
+	ADC_DMA_Init();
+	ADC_Dual_Start(adc0Chans, adc1Chans, ADC_TRIG_PHASE_0, ADC_SAMPLE_RATE_HZ);
+	ADC_Readout_Init(&adc1Readout, adc1Chans, ADC_DMA_BLOCK_SAMPLES);
+#elif defined(ADC_USE_DMA)
+	/* The sequence A interrupt only requests DMA transfers, it never
+	   reaches the NVIC */
+	ADC_DMA_Init();
+	ADC_DMA_Start(&adc1Stream, LPC_ADC1, ADC_SEQA_IDX, ADC1_SEQA_DMA_CH);
+	ADC_Readout_Init(&adc1Readout, ADC1_SEQA_CHANNELS, ADC_DMA_BLOCK_SAMPLES);
+#else
+	/* Enable related ADC NVIC interrupts */
+	NVIC_EnableIRQ(ADC1_SEQA_IRQn);
+	ADC_Readout_Init(&adc1Readout, ADC1_SEQA_CHANNELS, ADC_DMA_BLOCK_SAMPLES);
+#endif
 
-		/* Show some ADC data */
-		if ((rawSample & (ADC_DR_OVERRUN | ADC_SEQ_GDAT_DATAVALID)) != 0)
-		{
-			DEBUGOUT("ADC%d_%d: Sample value = 0x%x (Data sample %d)\r\n", index, j,
-					 ADC_DR_RESULT(rawSample), j);
-             uint32_t temp = ADC_MY_RESULT(rawSample);
-             temp -= 128;
-             report[0] = temp;
+	/* Enable sequencers */
+	Chip_ADC_EnableSequencer(LPC_ADC1, ADC_SEQA_IDX);
+
+#if defined(ADC_USE_HW_TRIGGER)
+#if (ADC_MODE == ADC_MODE_SINGLE)
+	/* The SCT starts every ADC1 sequence without software intervention */
+	ADC_Trig_Init();
+	ADC_Trig_AttachOutput(ADC_TRIG_OUT_ADC1, ADC_TRIG_PHASE_0);
+	ADC_Trig_SetRate(ADC_SAMPLE_RATE_HZ, adc1Readout.numChans);
+	ADC_Trig_Start();
+#endif
+#else
+	/* This example uses the periodic sysTick to manually trigger the ADC,
+	   but a periodic timer can be used in a match configuration to start
+	   an ADC sequence without software intervention. */
+	SysTick_Config(Chip_Clock_GetSysTickClockRate() / TICKRATE_HZ);
+#endif
 
+	/* Slow channels run on their own timers */
+	ADC_Sched_Start();
+#if (ADC1_CTRL_CHANNELS != 0)
+	ADC_Ctrl_Start();
+#endif
+
+	bootTimes.acqStart = CycleCount_Get();
+	recalIndex = adc1SampleIndex();
+	acqState = ACQ_RUNNING;
+}
+
+/* Stop converting for a recalibration. The DMA stays armed, the block
+   being filled continues after the pause. */
+static void pauseAcquisition(void)
+{
+	acqState = ACQ_PAUSED;
+	pauseStart = CycleCount_Get();
+#if defined(ADC_USE_HW_TRIGGER)
+	ADC_Trig_Pause();
+#endif
+	ADC_Sched_Stop();
+#if (ADC1_CTRL_CHANNELS != 0)
+	ADC_Ctrl_Stop();
+#endif
+}
+
+/* Resume converting after a recalibration */
+static void resumeAcquisition(void)
+{
+#if defined(ADC_USE_HW_TRIGGER)
+	ADC_Trig_Start();
+#endif
+	ADC_Sched_Start();
+#if (ADC1_CTRL_CHANNELS != 0)
+	ADC_Ctrl_Start();
+#endif
+	acqState = ACQ_RUNNING;
+	g_diag.recalPauses++;
+	Diag_HighWater(&g_diag.recalPauseMax, CycleCount_Get() - pauseStart);
+}
+
+/* Samples between two recalibrations */
+static uint32_t recalSamples(void)
+{
+#if defined(ADC_USE_HW_TRIGGER)
+	return ADC_RECAL_INTERVAL_S * ADC_Trig_GetRate();
+#else
+	return ADC_RECAL_INTERVAL_S * (TICKRATE_HZ / (TICKRATE_HZ / 8));
+#endif
+}
+
+/* Calibration housekeeping from the main loop. Acquisition starts when
+   the boot calibration completes; later calibrations are only started
+   in the gap right after a block so they never split a block. */
+static void calPoll(bool blockGap)
+{
+	if (ADC_Cal_Poll()) {
+		if (bootTimes.calDone == 0) {
+			bootTimes.calDone = CycleCount_Get();
+		}
+		if (acqState == ACQ_IDLE) {
+			startAcquisition();
+		}
+		else {
+			resumeAcquisition();
+		}
+		recalIndex = adc1SampleIndex();
+	}
+	else if (blockGap && (acqState == ACQ_RUNNING) && !ADC_Cal_IsBusy() &&
+			 (!ADC_Cal_IsValid() || ((adc1SampleIndex() - recalIndex) >= recalSamples()))) {
+		if (bootTimes.calStart == 0) {
+			bootTimes.calStart = CycleCount_Get();
 		}
+		pauseAcquisition();
+		ADC_Cal_Start();
 	}
 }
 
+/* Print the boot milestones once the first block was handled */
+static void reportBoot(void)
+{
+	DEBUGOUT("%s boot: calibrated at %d us, USB connect at %d us\r\n", warmBoot ? "Warm" : "Cold",
+			 cyclesToUs(bootTimes.calDone), cyclesToUs(bootTimes.usbConnect));
+	DEBUGOUT("First sample at %d us, first block at %d us\r\n", cyclesToUs(firstSampleCycles()),
+			 cyclesToUs(bootTimes.firstBlock));
+}
+
 /*****************************************************************************
  * Public functions
  ****************************************************************************/
@@ -142,6 +1779,7 @@ void showValudeADC( uint8_t *report)
  */
 void SysTick_Handler(void)
 {
+#if !defined(ADC_USE_HW_TRIGGER)
 	static uint32_t count;
 
 	/* Every 1/2 second */
@@ -149,9 +1787,13 @@ void SysTick_Handler(void)
 	if (count >= (TICKRATE_HZ / 8)) {
 		count = 0;
 
-		/* Manual start for ADC1 conversion sequence A */
-		Chip_ADC_StartSequencer(LPC_ADC1, ADC_SEQA_IDX);
+		/* Manual start for ADC1 conversion sequence A, held during a
+		   recalibration */
+		if (acqState == ACQ_RUNNING) {
+			Chip_ADC_StartSequencer(LPC_ADC1, ADC_SEQA_IDX);
+		}
 	}
+#endif
 }
 
 
@@ -169,12 +1811,67 @@ void ADC1A_IRQHandler(void)
 	/* Sequence A completion interrupt */
 	if (pending & ADC_FLAGS_SEQA_INT_MASK) {
 		sequence1Complete = true;
+#if (ADC_MODE == ADC_MODE_SINGLE) && !defined(ADC_USE_DMA)
+		adc1SeqCount++;
+#endif
 	}
 
 	/* Clear Sequence A completion interrupt */
 	Chip_ADC_ClearFlags(LPC_ADC1, ADC_FLAGS_SEQA_INT_MASK);
 }
 
+/**
+ * @brief	Handle interrupt from ADC1 sequencer B
+ * @return	Nothing
+ */
+void ADC1B_IRQHandler(void)
+{
+#if (ADC1_CTRL_CHANNELS != 0)
+	ADC_Ctrl_SeqHandler();
+#else
+	ADC_Sched_SeqHandler(LPC_ADC1);
+#endif
+}
+
+/**
+ * @brief	Handle interrupt from ADC0 sequencer B
+ * @return	Nothing
+ */
+void ADC0B_IRQHandler(void)
+{
+	ADC_Sched_SeqHandler(LPC_ADC0);
+}
+
+/**
+ * @brief	Handle threshold crossing interrupt from ADC1
+ * @return	Nothing
+ */
+void ADC1_THCMP_IRQHandler(void)
+{
+	ADC_Event_Capture(LPC_ADC1, adc1SampleIndex());
+}
+
+/**
+ * @brief	Handle overrun interrupt from ADC1
+ * @return	Nothing
+ */
+void ADC1_OVR_IRQHandler(void)
+{
+	Diag_AdcOverrunHandler(LPC_ADC1);
+}
+
+#if (ADC_MODE != ADC_MODE_SINGLE)
+/**
+ * @brief	Handle overrun interrupt from ADC0
+ * @return	Nothing
+ */
+void ADC0_OVR_IRQHandler(void)
+{
+	Diag_AdcOverrunHandler(LPC_ADC0);
+}
+
+#endif
+
 
 /**
  * @brief	main routine for ADC example
@@ -188,7 +1885,18 @@ int main(void)
     USB_CORE_DESCS_T desc;
 	ErrorCode_t ret = LPC_OK;
 	uint32_t prompt = 0, rdCnt = 0;
+#if (ADC_MODE != ADC_MODE_SINGLE)
+	const uint16_t *pDualBlock;
+#endif
+#if (ADC_MODE == ADC_MODE_SINGLE) && defined(ADC_USE_DMA)
+	const uint32_t *pBlock;
+#endif
+	uint32_t i;
+	bool blockGap;
 
+	/* Cycle counter used to benchmark the processing stages and to
+	   time the boot milestones from here */
+	CycleCount_Init();
 
 	 /**/
 	SystemCoreClockUpdate();
@@ -198,22 +1906,74 @@ int main(void)
 
 	DEBUGSTR("ADC sequencer demo\r\n");
 
+#if (ADC_MODE != ADC_MODE_SIMULTANEOUS) && defined(ADC_USE_DMA)
+	ADC_Decim_Init(&adcDecim, ADC_DECIM_RATIO);
+	DSP_Chain_Init(&adcFilter, DSP_DCBLOCK_COEF(ADC_FILTER_FS_HZ, ADC_FILTER_DC_HZ), &notchCoef, lpfCoef);
+#endif
+#if defined(HOST_CAPTURE)
+	ADC_Capture_Init();
+#endif
+#if defined(HOST_SPECTRUM)
+	ADC_Spectrum_Config(&spectrumDefault);
+#endif
+#if defined(HOST_SUMMARY)
+	summaryInit();
+#endif
+#if defined(HOST_FRAME_ZERO_COPY)
+	FramePool_Init();
+#endif
+#if defined(HID_STREAM)
+	HID_Stream_Init();
+#endif
+#if defined(APP_USB_AUDIO)
+	UAC_Stream_Init(ADC_STREAM_RATE_HZ, AUDIO_LATENCY_SAMPLES);
+#endif
+
 	/* Setup ADC for 12-bit mode and normal power */
 	Chip_ADC_Init(LPC_ADC0, 0);
 	Chip_ADC_Init(LPC_ADC1, 0);
 
-	/* Setup for maximum ADC clock rate */
-	Chip_ADC_SetClockRate(LPC_ADC1, ADC_MAX_SAMPLE_RATE);
-
+	/* Setup for maximum ADC clock rate and use higher voltage trim. ADC0
+	   runs with the same clock and trim as ADC1, it converts the slow
+	   channels and the second stream of the dual modes. */
+	warmBoot = ADC_Cal_Setup(ADC_CAL_ADC0 | ADC_CAL_ADC1, ADC_TRIM_VRANGE_HIGHV, ADC_MAX_SAMPLE_RATE);
+
+	/* Need to do a calibration after initialization and trim. It runs
+	   while the rest of the setup and the USB bring-up go on, a warm boot
+	   starts sampling at once and calibrates after the first block. */
+	if (!warmBoot) {
+		bootTimes.calStart = CycleCount_Get();
+		ADC_Cal_Start();
+	}
 
-	/* Use higher voltage trim for both ADCs */
-	Chip_ADC_SetTrim(LPC_ADC1, ADC_TRIM_VRANGE_HIGHV);
+#if (ADC_MODE != ADC_MODE_SINGLE)
+#if (ADC_MODE == ADC_MODE_SIMULTANEOUS)
+	for (i = 0; i < (sizeof(adcPairPins) / sizeof(adcPairPins[0])); i++) {
+		Chip_IOCON_PinMuxSet(LPC_IOCON, adcPairPins[i].port, adcPairPins[i].bit,
+			(IOCON_MODE_INACT | IOCON_DIGMODE_EN));
+		Chip_SWM_EnableFixedPin(adcPairPins[i].fixedPin);
+	}
+#else
+	Chip_IOCON_PinMuxSet(LPC_IOCON, ANALOG0_INPUT_PORT, ANALOG0_INPUT_BIT,
+		(IOCON_MODE_INACT | IOCON_DIGMODE_EN));
+	Chip_SWM_EnableFixedPin(ANALOG0_FIXED_PIN);
+#endif
+#endif
 
+#if defined(ADC_USE_HW_TRIGGER)
+	/* For ADC1, sequencer A will be used with threshold events.
+	   It is started on the rising edge of an SCT output and only
+	   monitors the ADC1 input. */
+	Chip_ADC_SetupSequencer(LPC_ADC1, ADC_SEQA_IDX,
+							(ADC1_SEQA_CHANNELS | ADC1_SEQ_CTRL_HWTRIG_SCT |
+							 ADC_SEQ_CTRL_HWTRIG_POLPOS | ADC1_SEQA_MODE));
+#else
 	/* For ADC1, sequencer A will be used with threshold events.
 	   It will be triggered manually by the sysTick interrupt and
 	   only monitors the ADC1 input. */
 	Chip_ADC_SetupSequencer(LPC_ADC1, ADC_SEQA_IDX,
-							(ADC_SEQ_CTRL_CHANSEL(BOARD_ADC_CH) | ADC_SEQ_CTRL_MODE_EOS));
+							(ADC1_SEQA_CHANNELS | ADC1_SEQA_MODE));
+#endif
 
 	/* Disables pullups/pulldowns and disable digital mode */
 	Chip_IOCON_PinMuxSet(LPC_IOCON, ANALOG_INPUT_PORT, ANALOG_INPUT_BIT, 
@@ -222,40 +1982,53 @@ int main(void)
 	/* Assign ADC1_0 to PIO1_1 via SWM (fixed pin) */
 	Chip_SWM_EnableFixedPin(ANALOG_FIXED_PIN);
 
-	/* Need to do a calibration after initialization and trim */
-	Chip_ADC_StartCalibration(LPC_ADC1);
-	while (!(Chip_ADC_IsCalibrationDone(LPC_ADC1))) {}
-
-	/* Setup threshold 0 low and high values to about 25% and 75% of max for
-	     ADC1 only */
-	Chip_ADC_SetThrLowValue(LPC_ADC1, 0, ((1 * 0xFFF) / 4));
-	Chip_ADC_SetThrHighValue(LPC_ADC1, 0, ((3 * 0xFFF) / 4));
-
 	/* Clear all pending interrupts */
 	Chip_ADC_ClearFlags(LPC_ADC1, Chip_ADC_GetFlags(LPC_ADC1));
 
+	/* Enable sequence A completion interrupt for ADC1 */
+	Chip_ADC_EnableInt(LPC_ADC1, ADC_INTEN_SEQA_ENABLE);
 
-	/* Enable sequence A completion and threshold crossing interrupts for ADC1_1 */
-	Chip_ADC_EnableInt(LPC_ADC1, ADC_INTEN_SEQA_ENABLE |
-					   ADC_INTEN_CMP_ENABLE(ADC_INTEN_CMP_CROSSTH, BOARD_ADC_CH));
-
-	/* Use threshold 0 for ADC channel and enable threshold interrupt mode for
-	   channel as crossing */
-	Chip_ADC_SelectTH0Channels(LPC_ADC1, ADC_THRSEL_CHAN_SEL_THR1(BOARD_ADC_CH));
-	Chip_ADC_SetThresholdInt(LPC_ADC1, BOARD_ADC_CH, ADC_INTEN_THCMP_CROSSING);
+	/* Use threshold 0 for the ADC1 input and turn every crossing into a
+	   timestamped event record from the compare interrupt */
+	ADC_Event_Init(LPC_ADC1, ADC_SEQ_CTRL_CHANSEL(BOARD_ADC_CH), ADC_EVENT_THR_LOW, ADC_EVENT_THR_HIGH);
 
-	/* Enable related ADC NVIC interrupts */
-	NVIC_EnableIRQ(ADC1_SEQA_IRQn);
-
-	/* Enable sequencers */
-	Chip_ADC_EnableSequencer(LPC_ADC1, ADC_SEQA_IDX);
+	/* Slow channels on sequencer B, ADC0 channel 0 can be the temperature sensor */
+	for (i = 0; i < SLOW_CHAN_COUNT; i++) {
+		if ((slowChans[i].adcNum == 0) && (slowChans[i].channel == ADC_TEMP_CH)) {
+			Chip_SYSCTL_PowerUp(SYSCTL_POWERDOWN_TS_PD);
+			Chip_ADC_SetADC0Input(LPC_ADC0, ADC_INSEL_TS);
+		}
+	}
+	if (!ADC_Sched_Init(slowChans, SLOW_CHAN_COUNT)) {
+		DEBUGSTR("Invalid BOARD_SLOW_CHANNELS list\r\n");
+		while (1) {}
+	}
 
+#if (ADC1_CTRL_CHANNELS != 0)
+	/* Control channels own ADC1 sequencer B, nothing may delay their
+	   interrupt */
+	for (i = 0; i < SLOW_CHAN_COUNT; i++) {
+		if (slowChans[i].adcNum == 1) {
+			DEBUGSTR("No ADC1 slow channels with ADC1_CTRL_CHANNELS\r\n");
+			while (1) {}
+		}
+	}
+	for (i = 0; i < (sizeof(ctrlLowerIrqs) / sizeof(ctrlLowerIrqs[0])); i++) {
+		NVIC_SetPriority(ctrlLowerIrqs[i], 1);
+	}
+	ADC_Ctrl_Init(ADC1_CTRL_CHANNELS, ADC_CTRL_RATE_HZ, NULL);
+#endif
 
+	/* Count results overwritten before they were read */
+	Diag_EnableAdcOverrun(LPC_ADC1);
+#if (ADC_MODE != ADC_MODE_SINGLE)
+	Diag_EnableAdcOverrun(LPC_ADC0);
+#endif
 
-	/* This example uses the periodic sysTick to manually trigger the ADC,
-	   but a periodic timer can be used in a match configuration to start
-	   an ADC sequence without software intervention. */
-	SysTick_Config(Chip_Clock_GetSysTickClockRate() / TICKRATE_HZ);
+	/* Start sampling now on a warm boot, once calibrated otherwise */
+	if (warmBoot) {
+		startAcquisition();
+	}
 
 	/* initialize USBD ROM API pointer. */
 	g_pUsbApi = (const USBD_API_T *) LPC_ROM_API->pUSBD;
@@ -271,9 +2044,23 @@ int main(void)
 	    to avoid data corruption. Corruption of padding memory doesn’t affect the
 	    stack/program behaviour.
 	 */
+#if defined(APP_USB_VCOM)
+	usb_param.max_num_ep = 3 + 1;
+#else
 	usb_param.max_num_ep = 2 + 1;
+#endif
 	usb_param.mem_base = USB_STACK_MEM_BASE;
 	usb_param.mem_size = USB_STACK_MEM_SIZE;
+#if defined(APP_USB_VCOM)
+	/* Transfers and notifications in flight are lost on a bus reset */
+	usb_param.USB_Reset_Event = vcom_reset_event;
+#endif
+#if defined(APP_USB_AUDIO)
+	/* Audio packets and the sample clock loop run on the start of frames */
+	usb_param.USB_SOF_Event = usb_audio_sof_event;
+	usb_param.USB_Interface_Event = usb_audio_interface_event;
+	usb_param.USB_Reset_Event = usb_audio_reset_event;
+#endif
 
 	/* Set the USB descriptors */
 	desc.device_desc = (uint8_t *) USB_DeviceDescriptor;
@@ -291,14 +2078,27 @@ int main(void)
 	ret = USBD_API->hw->Init(&g_hUsb, &desc, &usb_param);
 	if (ret == LPC_OK) {
 
+#if defined(APP_USB_VCOM)
+		/* Init VCOM interface */
+		ret = vcom_init(g_hUsb, &desc, &usb_param);
+		Link_Init(hostCmds, sizeof(hostCmds) / sizeof(hostCmds[0]));
+#if defined(HOST_FRAMES)
+		/* Start of frames are latched as the time reference of the frames */
+		USBD_API->hw->EnableEvent(g_hUsb, 0, USB_EVT_SOF, 1);
+#endif
+#elif defined(APP_USB_AUDIO)
+		ret = usb_audio_init(g_hUsb, &desc, &usb_param, streamConverted);
+#else
 		ret = Mouse_Init(g_hUsb,
 						 (USB_INTERFACE_DESCRIPTOR *) &USB_FsConfigDescriptor[sizeof(USB_CONFIGURATION_DESCRIPTOR)],
 						 &usb_param.mem_base, &usb_param.mem_size);
+#endif
 		if (ret == LPC_OK) {
 			/*  enable USB interrupts */
 			NVIC_EnableIRQ(USB0_IRQn);
 			/* now connect */
 			USBD_API->hw->Connect(g_hUsb, 1);
+			bootTimes.usbConnect = CycleCount_Get();
 		}
 	}
 
@@ -309,8 +2109,60 @@ int main(void)
 
 		/* Sleep until something happens */
 
+#if defined(APP_USB_HID)
 		Mouse_Tasks();
-		__WFI();
+#endif
+
+		/* Threshold events go out ahead of sample blocks */
+		sendEvents();
+
+		blockGap = false;
+#if (ADC_MODE != ADC_MODE_SINGLE)
+		/* Merged block ready once both converters filled a block */
+		while ((pDualBlock = ADC_Dual_GetBlock()) != NULL) {
+			processDualBlock(pDualBlock, ADC_DUAL_BLOCK_SAMPLES);
+			blockGap = true;
+		}
+#elif defined(ADC_USE_DMA)
+		/* Block ready events from the DMA interrupt */
+		while ((pBlock = ADC_DMA_GetBlock(&adc1Stream)) != NULL) {
+			processBlock(pBlock, ADC_DMA_BLOCK_SAMPLES);
+			ADC_DMA_ReleaseBlock(&adc1Stream);
+			blockGap = true;
+		}
+#else
+		/* Every sequence is started on its own, any time between two is a gap */
+		blockGap = (adc1SeqCount != 0);
+#endif
+		if (blockGap && (bootTimes.firstBlock == 0)) {
+			bootTimes.firstBlock = CycleCount_Get();
+			reportBoot();
+		}
+		calPoll(blockGap);
+
+		sendEvents();
+		sendSlowRecords();
+#if defined(HOST_SUMMARY)
+		sendSummaries();
+#endif
+#if defined(HOST_CAPTURE)
+		sendCapture();
+#endif
+#if defined(HOST_SPECTRUM)
+		sendSpectrum();
+#endif
+#if defined(HOST_PACK)
+		sendPacked();
+#endif
+		Diag_Poll();
+#if defined(APP_USB_VCOM)
+		usbPerfPoll();
+		Link_Poll();
+#endif
+		/* The end of a calibration raises no interrupt */
+		if (!ADC_Cal_IsBusy()) {
+			__WFI();
+		}
 	/*	if (sequence1Complete) {
 			showValudeADC(LPC_ADC1);
 		}*/
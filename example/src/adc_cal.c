@@ -0,0 +1,187 @@
+/*
+ * @brief Non-blocking ADC calibration with a context cached across warm resets
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "adc_cal.h"
+#include "cycle_count.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* "ADCC", bump the low byte when ADC_CAL_CTX_T changes */
+#define ADC_CAL_MAGIC       0x41444301
+
+/* Resets that do not preserve the RAM contents */
+#define ADC_CAL_COLD_RESETS (SYSCTL_RST_POR | SYSCTL_RST_BOD)
+
+/* Placed in the Ram1_16 no-init section, the startup code leaves it alone */
+static ADC_CAL_CTX_T calCtx __attribute__ ((section(".noinit.$RAM2")));
+
+static uint32_t calMask;
+static uint32_t calAdcClk;
+static uint32_t calStart;
+static bool calBusy;
+static bool calValid;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Checksum over all context fields but the last */
+static uint32_t contextCheck(const ADC_CAL_CTX_T *pCtx)
+{
+	const uint32_t *pWord = (const uint32_t *) pCtx;
+	uint32_t i, sum = 0;
+
+	for (i = 0; i < ((sizeof(*pCtx) / sizeof(uint32_t)) - 1); i++) {
+		sum = ((sum << 5) | (sum >> 27)) ^ pWord[i];
+	}
+
+	return ~sum;
+}
+
+/* Apply a function to every selected ADC */
+static void forEachAdc(void (*pFunc)(LPC_ADC_T *pADC))
+{
+	if (calMask & ADC_CAL_ADC0) {
+		pFunc(LPC_ADC0);
+	}
+	if (calMask & ADC_CAL_ADC1) {
+		pFunc(LPC_ADC1);
+	}
+}
+
+/* Conversion clock, calibration runs at 500 kHz */
+static void restoreClock(LPC_ADC_T *pADC)
+{
+	Chip_ADC_SetClockRate(pADC, calAdcClk);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Apply trim and clock to the ADCs and check the cached context */
+bool ADC_Cal_Setup(uint32_t adcMask, uint32_t trim, uint32_t adcClk)
+{
+	uint32_t resetCause = Chip_SYSCTL_GetSystemRSTStatus();
+	uint32_t sysClk = Chip_Clock_GetSystemClockRate();
+	bool warm;
+
+	calMask = adcMask;
+	calAdcClk = adcClk;
+	calBusy = false;
+	calValid = false;
+
+	if (adcMask & ADC_CAL_ADC0) {
+		Chip_ADC_SetClockRate(LPC_ADC0, adcClk);
+		Chip_ADC_SetTrim(LPC_ADC0, trim);
+	}
+	if (adcMask & ADC_CAL_ADC1) {
+		Chip_ADC_SetClockRate(LPC_ADC1, adcClk);
+		Chip_ADC_SetTrim(LPC_ADC1, trim);
+	}
+
+	/* The reset status is sticky, clear it for the next reset */
+	Chip_SYSCTL_ClearSystemRSTStatus(resetCause);
+
+	warm = ((resetCause & ADC_CAL_COLD_RESETS) == 0) &&
+		   (calCtx.magic == ADC_CAL_MAGIC) && (calCtx.check == contextCheck(&calCtx)) &&
+		   (calCtx.sysClk == sysClk) && (calCtx.adcClk == adcClk) &&
+		   (calCtx.trim == trim) && (calCtx.adcMask == adcMask);
+
+	if (!warm) {
+		calCtx.magic = 0;
+		calCtx.sysClk = sysClk;
+		calCtx.adcClk = adcClk;
+		calCtx.trim = trim;
+		calCtx.adcMask = adcMask;
+		calCtx.calCount = 0;
+		calCtx.calCycles = 0;
+		calCtx.check = 0;
+	}
+
+	return warm;
+}
+
+/* Start calibrating the ADCs without waiting for the result */
+void ADC_Cal_Start(void)
+{
+	calStart = CycleCount_Get();
+	calBusy = true;
+	forEachAdc(Chip_ADC_StartCalibration);
+}
+
+/* Finish a calibration started by ADC_Cal_Start() */
+bool ADC_Cal_Poll(void)
+{
+	if (!calBusy) {
+		return false;
+	}
+	if (((calMask & ADC_CAL_ADC0) && !Chip_ADC_IsCalibrationDone(LPC_ADC0)) ||
+		((calMask & ADC_CAL_ADC1) && !Chip_ADC_IsCalibrationDone(LPC_ADC1))) {
+		return false;
+	}
+
+	forEachAdc(restoreClock);
+	calBusy = false;
+	calValid = true;
+
+	calCtx.calCycles = CycleCount_Get() - calStart;
+	calCtx.calCount++;
+	calCtx.magic = ADC_CAL_MAGIC;
+	calCtx.check = contextCheck(&calCtx);
+
+	return true;
+}
+
+/* Return whether a calibration is in progress */
+bool ADC_Cal_IsBusy(void)
+{
+	return calBusy;
+}
+
+/* Return whether the ADCs were calibrated since the last reset */
+bool ADC_Cal_IsValid(void)
+{
+	return calValid;
+}
+
+/* Return the cached calibration context */
+const ADC_CAL_CTX_T *ADC_Cal_GetContext(void)
+{
+	return &calCtx;
+}
@@ -0,0 +1,299 @@
+/*
+ * @brief Pre/post-trigger capture from a circular sample history
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "board.h"
+#include "adc_capture.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define HISTORY_MASK        (ADC_CAPTURE_HISTORY - 1)
+
+/* Ram1_16 is otherwise unused by the sample path; Ram2_4 belongs to the
+   USB stack (USB_STACK_MEM_BASE) */
+static uint16_t history[ADC_CAPTURE_HISTORY] __attribute__ ((section(".bss.$RAM2")));
+
+static ADC_CAPTURE_CFG_T capCfg;
+static ADC_CAPTURE_STATE_T capState;
+static ADC_CAPTURE_STATS_T capStats;
+
+static uint32_t head;			/* Stream index of the next sample */
+static uint32_t validFrom;		/* Oldest index after the last gap */
+static uint32_t trigIndex;
+static uint32_t readIndex;		/* Next window sample to read, protected from here on */
+static int32_t lastSample;
+static bool haveLast;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Oldest index whose sample is still in the history */
+static uint32_t oldestIndex(void)
+{
+	uint32_t oldest = head - ADC_CAPTURE_HISTORY;
+
+	if ((int32_t) (validFrom - oldest) > 0) {
+		oldest = validFrom;
+	}
+
+	return oldest;
+}
+
+/* Take a trigger if its pre-trigger samples are still there */
+static bool takeTrigger(uint32_t index)
+{
+	if ((int32_t) ((index - capCfg.pre) - oldestIndex()) < 0) {
+		capStats.lateTriggers++;
+		return false;
+	}
+
+	trigIndex = index;
+	readIndex = index - capCfg.pre;
+	capState = ADC_CAPTURE_TRIGGERED;
+
+	return true;
+}
+
+/* Position of the trigger in a block from a start position, or count if
+   it is not there */
+static uint32_t findTrigger(const uint16_t *pSamples, uint32_t start, uint32_t count)
+{
+	int32_t prev, level = capCfg.level;
+	uint32_t i = start;
+
+	if (start > 0) {
+		prev = pSamples[start - 1];
+	}
+	else if (haveLast) {
+		prev = lastSample;
+	}
+	else {
+		prev = pSamples[0];
+		i = 1;
+	}
+
+	if (capCfg.source == ADC_CAPTURE_LEVEL) {
+		for (; i < count; i++) {
+			int32_t x = pSamples[i];
+
+			if ((capCfg.edge & ADC_CAPTURE_RISING) && (prev < level) && (x >= level)) {
+				break;
+			}
+			if ((capCfg.edge & ADC_CAPTURE_FALLING) && (prev >= level) && (x < level)) {
+				break;
+			}
+			prev = x;
+		}
+	}
+	else {
+		for (; i < count; i++) {
+			int32_t step = (int32_t) pSamples[i] - prev;
+
+			if ((capCfg.edge & ADC_CAPTURE_RISING) && (step >= level)) {
+				break;
+			}
+			if ((capCfg.edge & ADC_CAPTURE_FALLING) && (step <= -level)) {
+				break;
+			}
+			prev = pSamples[i];
+		}
+	}
+
+	return i;
+}
+
+/* Copy samples into the history at a stream index */
+static void storeSamples(uint32_t index, const uint16_t *pSamples, uint32_t count)
+{
+	uint32_t pos = index & HISTORY_MASK;
+	uint32_t first = ADC_CAPTURE_HISTORY - pos;
+
+	if (first > count) {
+		first = count;
+	}
+	memcpy(&history[pos], pSamples, first * sizeof(uint16_t));
+	memcpy(history, &pSamples[first], (count - first) * sizeof(uint16_t));
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Clear the history and disarm the trigger */
+void ADC_Capture_Init(void)
+{
+	capState = ADC_CAPTURE_IDLE;
+	memset(&capStats, 0, sizeof(capStats));
+	head = 0;
+	validFrom = 0;
+	haveLast = false;
+}
+
+/* Arm the trigger */
+bool ADC_Capture_Arm(const ADC_CAPTURE_CFG_T *pCfg)
+{
+	if ((pCfg->pre + pCfg->post) > ADC_CAPTURE_HISTORY) {
+		return false;
+	}
+
+	capCfg = *pCfg;
+	capState = ADC_CAPTURE_ARMED;
+
+	return true;
+}
+
+/* Disarm the trigger and drop a window not yet read */
+void ADC_Capture_Disarm(void)
+{
+	capState = ADC_CAPTURE_IDLE;
+}
+
+/* Append samples to the history and look for the trigger */
+void ADC_Capture_Write(const uint16_t *pSamples, uint32_t count)
+{
+	uint32_t pos, room, stored = count;
+
+	if (count == 0) {
+		return;
+	}
+
+	/* Only look where the pre-trigger samples are available */
+	if ((capState == ADC_CAPTURE_ARMED) && (capCfg.source != ADC_CAPTURE_EXTERNAL)) {
+		pos = (oldestIndex() + capCfg.pre) - head;
+		if ((int32_t) pos < 0) {
+			pos = 0;
+		}
+		if (pos < count) {
+			pos = findTrigger(pSamples, pos, count);
+			if (pos < count) {
+				takeTrigger(head + pos);
+			}
+		}
+	}
+
+	/* Never overwrite window samples that were not read yet */
+	if ((capState == ADC_CAPTURE_TRIGGERED) || (capState == ADC_CAPTURE_READY)) {
+		room = (readIndex + ADC_CAPTURE_HISTORY) - head;
+		if ((int32_t) room < 0) {
+			room = 0;
+		}
+		if (stored > room) {
+			stored = room;
+		}
+	}
+
+	storeSamples(head, pSamples, stored);
+	if (stored < count) {
+		capStats.skipped += count - stored;
+		validFrom = head + count;
+	}
+
+	lastSample = pSamples[count - 1];
+	haveLast = true;
+	head += count;
+
+	if ((capState == ADC_CAPTURE_TRIGGERED) && ((int32_t) (head - (trigIndex + capCfg.post)) >= 0)) {
+		capState = ADC_CAPTURE_READY;
+		capStats.captures++;
+	}
+}
+
+/* Fire an external trigger */
+bool ADC_Capture_Trigger(uint32_t index, ADC_CAPTURE_EDGE_T edge)
+{
+	if ((capState != ADC_CAPTURE_ARMED) || (capCfg.source != ADC_CAPTURE_EXTERNAL) ||
+		((capCfg.edge & edge) == 0)) {
+		return false;
+	}
+
+	if (!takeTrigger(index)) {
+		return false;
+	}
+	if ((int32_t) (head - (trigIndex + capCfg.post)) >= 0) {
+		capState = ADC_CAPTURE_READY;
+		capStats.captures++;
+	}
+
+	return true;
+}
+
+/* Return the capture state */
+ADC_CAPTURE_STATE_T ADC_Capture_GetState(void)
+{
+	return capState;
+}
+
+/* Return the stream index of the last trigger */
+uint32_t ADC_Capture_GetTriggerIndex(void)
+{
+	return trigIndex;
+}
+
+/* Read the next samples of a completed window */
+uint32_t ADC_Capture_Read(uint16_t *pDest, uint32_t max)
+{
+	uint32_t left, n, pos, first;
+
+	if (capState != ADC_CAPTURE_READY) {
+		return 0;
+	}
+
+	left = (trigIndex + capCfg.post) - readIndex;
+	n = (max < left) ? max : left;
+
+	pos = readIndex & HISTORY_MASK;
+	first = ADC_CAPTURE_HISTORY - pos;
+	if (first > n) {
+		first = n;
+	}
+	memcpy(pDest, &history[pos], first * sizeof(uint16_t));
+	memcpy(&pDest[first], history, (n - first) * sizeof(uint16_t));
+	readIndex += n;
+
+	if (n == left) {
+		capState = capCfg.autoArm ? ADC_CAPTURE_ARMED : ADC_CAPTURE_IDLE;
+	}
+
+	return n;
+}
+
+/* Return the counters of the capture */
+const ADC_CAPTURE_STATS_T *ADC_Capture_GetStats(void)
+{
+	return &capStats;
+}
@@ -0,0 +1,248 @@
+/*
+ * @brief Low latency control channels on ADC1 sequencer B
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "board.h"
+#include "adc_ctrl.h"
+#include "adc_trig.h"
+#include "cycle_count.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Event control: match only, MATCHSEL in bits 3:0 */
+#define SCT_EV_CTRL_MATCH(m)    ((m) | (1 << 12))
+/* Events are enabled in state 0 only, the SCT never changes state */
+#define SCT_EV_STATE0           (1 << 0)
+
+/* Event/match 0 is the period limit, event/match 1 raises the output on
+   the limit tick and event/match 2 drops it half a period later */
+#define CTRL_SET_EV             1
+#define CTRL_CLR_EV             2
+
+static uint32_t ctrlChans;
+static uint32_t ctrlSeqTicks;	/* Longest control sequence in system clocks */
+static ADC_CTRL_HANDLER_T ctrlHandler;
+static uint16_t ctrlValues[ADC_CTRL_ADC_CHANNELS];
+
+/* Written by the sequence B interrupt only, count last */
+static volatile ADC_CTRL_STATS_T ctrlStats;
+
+/* Set by the main loop, applied and cleared by the interrupt */
+static volatile bool resetPending;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Number of channels in a channel mask */
+static uint32_t chanCount(uint32_t chans)
+{
+	uint32_t n = 0;
+
+	while (chans) {
+		chans &= chans - 1;
+		n++;
+	}
+
+	return n;
+}
+
+/* Counters back to their initial values */
+static void clearStats(void)
+{
+	ctrlStats.count = 0;
+	ctrlStats.overruns = 0;
+	ctrlStats.latencyLast = 0;
+	ctrlStats.latencyMin = 0xFFFFFFFF;
+	ctrlStats.latencyMax = 0;
+	ctrlStats.latencySum = 0;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Set up sequencer B of ADC1 and the control trigger */
+uint32_t ADC_Ctrl_Init(uint32_t chans, uint32_t rateHz, ADC_CTRL_HANDLER_T handler)
+{
+	LPC_SCT_T *pSCT = ADC_CTRL_SCT;
+	uint32_t sysClk = Chip_Clock_GetSystemClockRate();
+	uint32_t maxRate, period;
+
+	chans &= ADC_SEQ_CTRL_CHANNELS;
+	if (chans == 0) {
+		return 0;
+	}
+
+	ctrlChans = chans;
+	ctrlHandler = handler;
+	memset(ctrlValues, 0, sizeof(ctrlValues));
+	clearStats();
+	resetPending = false;
+
+	/* Each trigger converts every control channel once */
+	maxRate = ADC_Trig_GetMaxRate(chanCount(chans));
+	if (rateHz > maxRate) {
+		rateHz = maxRate;
+	}
+	if (rateHz < ADC_TRIG_MIN_RATE_HZ) {
+		rateHz = ADC_TRIG_MIN_RATE_HZ;
+	}
+	period = sysClk / rateHz;
+	ctrlSeqTicks = sysClk / maxRate;
+
+	/* Same single 32-bit counter layout as the sample clock. The edge sits
+	   on the limit tick, so the counter reads the clocks since the edge
+	   minus one. */
+	Chip_SCT_Init(pSCT);
+	Chip_SCT_Config(pSCT, SCT_CONFIG_32BIT_COUNTER | SCT_CONFIG_AUTOLIMIT_L);
+	Chip_SCT_SetControl(pSCT, SCT_CTRL_HALT_L | SCT_CTRL_CLRCTR_L);
+
+	pSCT->MATCH[0].U = period - 1;
+	pSCT->MATCHREL[0].U = period - 1;
+	pSCT->MATCH[CTRL_SET_EV].U = period - 1;
+	pSCT->MATCHREL[CTRL_SET_EV].U = period - 1;
+	pSCT->MATCH[CTRL_CLR_EV].U = (period / 2) - 1;
+	pSCT->MATCHREL[CTRL_CLR_EV].U = (period / 2) - 1;
+
+	pSCT->EVENT[CTRL_SET_EV].STATE = SCT_EV_STATE0;
+	pSCT->EVENT[CTRL_SET_EV].CTRL = SCT_EV_CTRL_MATCH(CTRL_SET_EV);
+	pSCT->EVENT[CTRL_CLR_EV].STATE = SCT_EV_STATE0;
+	pSCT->EVENT[CTRL_CLR_EV].CTRL = SCT_EV_CTRL_MATCH(CTRL_CLR_EV);
+	pSCT->OUT[ADC_CTRL_SCT_OUT].SET = (1 << CTRL_SET_EV);
+	pSCT->OUT[ADC_CTRL_SCT_OUT].CLR = (1 << CTRL_CLR_EV);
+
+	/* The sequence only waits for the trigger edges */
+	Chip_ADC_SetupSequencer(LPC_ADC1, ADC_SEQB_IDX, (chans | ADC1_SEQ_CTRL_HWTRIG_CTRL |
+													 ADC_SEQ_CTRL_HWTRIG_POLPOS | ADC_SEQ_CTRL_MODE_EOS));
+	Chip_ADC_ClearFlags(LPC_ADC1, ADC_FLAGS_SEQB_INT_MASK);
+	Chip_ADC_EnableInt(LPC_ADC1, ADC_INTEN_SEQB_ENABLE);
+	Chip_ADC_EnableSequencer(LPC_ADC1, ADC_SEQB_IDX);
+
+	NVIC_SetPriority(ADC1_SEQB_IRQn, 0);
+	NVIC_EnableIRQ(ADC1_SEQB_IRQn);
+
+	return sysClk / period;
+}
+
+/* Let sequence B preempt sequence A and start the control trigger */
+void ADC_Ctrl_Start(void)
+{
+	/* Despite its name, LOWPRIO set on sequence A lets a B trigger abort
+	   the A conversion in progress; A resumes from that channel after B */
+	Chip_ADC_SetSequencerBits(LPC_ADC1, ADC_SEQA_IDX, ADC_SEQ_CTRL_LOWPRIO);
+	Chip_SCT_ClearControl(ADC_CTRL_SCT, SCT_CTRL_HALT_L);
+}
+
+/* Stop the control trigger */
+void ADC_Ctrl_Stop(void)
+{
+	uint32_t start;
+
+	Chip_SCT_SetControl(ADC_CTRL_SCT, SCT_CTRL_HALT_L | SCT_CTRL_CLRCTR_L);
+
+	/* Let the sequence started by the last edge complete */
+	start = CycleCount_Get();
+	while ((CycleCount_Get() - start) < ctrlSeqTicks) {}
+}
+
+/* Read the results of a control sequence and time it */
+void ADC_Ctrl_SeqHandler(void)
+{
+	uint32_t latency = ADC_CTRL_SCT->COUNT_U + 1;
+	uint32_t chans = ctrlChans, ch, raw, overruns = 0;
+
+	Chip_ADC_ClearFlags(LPC_ADC1, ADC_FLAGS_SEQB_INT_MASK);
+
+	while (chans) {
+		ch = 31 - __CLZ(chans);
+		chans &= ~(1 << ch);
+
+		raw = Chip_ADC_GetDataReg(LPC_ADC1, ch);
+		if (raw & ADC_DR_OVERRUN) {
+			overruns++;
+		}
+		ctrlValues[ch] = ADC_DR_RESULT(raw);
+	}
+
+	if (ctrlHandler != NULL) {
+		ctrlHandler(ctrlValues, ctrlChans);
+	}
+
+	if (resetPending) {
+		clearStats();
+		resetPending = false;
+	}
+	ctrlStats.overruns += overruns;
+	ctrlStats.latencyLast = latency;
+	if (latency < ctrlStats.latencyMin) {
+		ctrlStats.latencyMin = latency;
+	}
+	if (latency > ctrlStats.latencyMax) {
+		ctrlStats.latencyMax = latency;
+	}
+	ctrlStats.latencySum += latency;
+	ctrlStats.count++;
+}
+
+/* Copy the latency counters */
+void ADC_Ctrl_GetStats(ADC_CTRL_STATS_T *pStats)
+{
+	uint32_t count;
+
+	do {
+		count = ctrlStats.count;
+		pStats->count = count;
+		pStats->overruns = ctrlStats.overruns;
+		pStats->latencyLast = ctrlStats.latencyLast;
+		pStats->latencyMin = ctrlStats.latencyMin;
+		pStats->latencyMax = ctrlStats.latencyMax;
+		pStats->latencySum = ctrlStats.latencySum;
+	} while (count != ctrlStats.count);
+}
+
+/* Clear the latency counters */
+void ADC_Ctrl_ResetStats(void)
+{
+	resetPending = true;
+}
+
+/* Return the latest result of a control channel */
+uint16_t ADC_Ctrl_GetValue(uint32_t ch)
+{
+	return (ch < ADC_CTRL_ADC_CHANNELS) ? ctrlValues[ch] : 0;
+}
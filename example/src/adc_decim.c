@@ -0,0 +1,163 @@
+/*
+ * @brief CIC oversampling and decimation of ADC samples
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "adc_decim.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Compensation FIR taps in Q14 */
+#define COMP_Q              14
+#define COMP_OUTER          ((int32_t) ((ADC_DECIM_COMP_ALPHA * (1 << COMP_Q)) + 0.5))
+#define COMP_CENTER         ((1 << COMP_Q) + (2 * COMP_OUTER))
+
+/* CIC gain is ratio^2, outputs are scaled from 12 + 2 * log2(ratio) bits to 16 */
+#define DECIM_OUT_BITS      16
+#define DECIM_IN_BITS       12
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static inline int32_t sat16(int32_t v)
+{
+	if (v > 32767) {
+		return 32767;
+	}
+	if (v < -32768) {
+		return -32768;
+	}
+	return v;
+}
+
+/* Scale the CIC output to 16 bits with rounding */
+static inline int32_t scaleCic(int32_t v, uint32_t log2Ratio)
+{
+	int32_t shift = (int32_t) (2 * log2Ratio) + DECIM_IN_BITS - DECIM_OUT_BITS;
+
+	if (shift > 0) {
+		return (v + (1 << (shift - 1))) >> shift;
+	}
+	return v << -shift;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize a decimator */
+bool ADC_Decim_Init(ADC_DECIM_T *pDec, uint32_t ratio)
+{
+	pDec->log2Ratio = 1;
+	pDec->left = 2;
+	return ADC_Decim_SetRatio(pDec, ratio);
+}
+
+/* Change the oversampling ratio */
+bool ADC_Decim_SetRatio(ADC_DECIM_T *pDec, uint32_t ratio)
+{
+	uint32_t log2Ratio = 0;
+
+	if ((ratio < ADC_DECIM_MIN_RATIO) || (ratio > ADC_DECIM_MAX_RATIO) ||
+		((ratio & (ratio - 1)) != 0)) {
+		return false;
+	}
+	while ((1UL << log2Ratio) < ratio) {
+		log2Ratio++;
+	}
+
+	pDec->log2Ratio = log2Ratio;
+	pDec->left = ratio;
+	pDec->integ[0] = pDec->integ[1] = 0;
+	pDec->comb[0] = pDec->comb[1] = 0;
+	pDec->hist[0] = pDec->hist[1] = 0;
+
+	return true;
+}
+
+/* Decimate a block of 12-bit samples */
+uint32_t ADC_Decim_Process(ADC_DECIM_T *pDec, const uint16_t *pIn, uint32_t count, int16_t *pOut)
+{
+	uint32_t i1 = pDec->integ[0], i2 = pDec->integ[1];
+	uint32_t left = pDec->left;
+	uint32_t ratio = 1UL << pDec->log2Ratio;
+	uint32_t outCount = 0;
+	uint32_t n, c1, c2;
+	int32_t x, y;
+
+	while (count) {
+		n = (count < left) ? count : left;
+		count -= n;
+		left -= n;
+
+		/* Integrators at the input rate, two samples per iteration */
+		while (n >= 2) {
+			i1 += (uint32_t) pIn[0] - ADC_DECIM_INPUT_MID;
+			i2 += i1;
+			i1 += (uint32_t) pIn[1] - ADC_DECIM_INPUT_MID;
+			i2 += i1;
+			pIn += 2;
+			n -= 2;
+		}
+		if (n) {
+			i1 += (uint32_t) *pIn++ - ADC_DECIM_INPUT_MID;
+			i2 += i1;
+		}
+
+		if (left == 0) {
+			left = ratio;
+
+			/* Combs at the output rate, wrap-around differences are exact */
+			c1 = i2 - pDec->comb[0];
+			pDec->comb[0] = i2;
+			c2 = c1 - pDec->comb[1];
+			pDec->comb[1] = c1;
+			x = scaleCic((int32_t) c2, pDec->log2Ratio);
+
+			/* Droop compensation */
+			y = (COMP_CENTER * pDec->hist[0]) - (COMP_OUTER * (x + pDec->hist[1]));
+			pDec->hist[1] = pDec->hist[0];
+			pDec->hist[0] = x;
+			pOut[outCount++] = (int16_t) sat16((y + (1 << (COMP_Q - 1))) >> COMP_Q);
+		}
+	}
+
+	pDec->integ[0] = i1;
+	pDec->integ[1] = i2;
+	pDec->left = left;
+
+	return outCount;
+}
@@ -0,0 +1,241 @@
+/*
+ * @brief DMA ping-pong capture of ADC sequencer results
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "adc_dma.h"
+#include "adc_trig.h"
+#include "diag_stats.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* One word per request from SEQ_GDAT into the block, interrupt on A when
+   the block is full and reload the next descriptor */
+#define ADC_DMA_XFERCFG     (DMA_XFERCFG_CFGVALID | DMA_XFERCFG_RELOAD | \
+							 DMA_XFERCFG_SETINTA | DMA_XFERCFG_WIDTH_32 | \
+							 DMA_XFERCFG_SRCINC_0 | DMA_XFERCFG_DSTINC_1 | \
+							 DMA_XFERCFG_XFERCOUNT(ADC_DMA_BLOCK_SAMPLES))
+
+/* Transfers left in the active descriptor. XFERCOUNT holds the count minus
+   one and reads 0x3FF once the descriptor is exhausted. */
+#define ADC_DMA_XFER_LEFT(xfercfg)  (((((xfercfg) >> 16) & 0x3FF) + 1) & 0x3FF)
+
+/* Linked descriptors alternating between the two blocks of each stream */
+ALIGNED(16) static DMA_CHDESC_T dmaDesc[ADC_DMA_MAX_STREAMS][2];
+
+static ADC_DMA_STREAM_T *activeStream[ADC_DMA_MAX_STREAMS];
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Latch the time reference of the block just completed */
+static void latchMark(ADC_DMA_STREAM_T *pStream)
+{
+	ADC_TIME_MARK_T *pMark = &pStream->mark[(pStream->doneCount - 1) & 1];
+	bool settled;
+
+	pMark->blockEnd = (pStream->doneCount * ADC_DMA_BLOCK_SAMPLES) - 1;
+	do {
+		__disable_irq();
+		settled = ADC_Trig_GetEdgeCycles(&pMark->cycles);
+		if (settled) {
+			pMark->index = ADC_DMA_GetSampleIndex(pStream);
+		}
+		__enable_irq();
+	} while (!settled);
+	pMark->sofValid = ADC_Time_GetSof(&pMark->sofFrame, &pMark->sofCycles);
+}
+
+static DMA_TRIGSRC_T getTrigSource(LPC_ADC_T *pADC, ADC_SEQ_IDX_T seqIndex)
+{
+	if (pADC == LPC_ADC0) {
+		return (seqIndex == ADC_SEQA_IDX) ? DMATRIG_ADC0_SEQA_IRQ : DMATRIG_ADC0_SEQB_IRQ;
+	}
+	return (seqIndex == ADC_SEQA_IDX) ? DMATRIG_ADC1_SEQA_IRQ : DMATRIG_ADC1_SEQB_IRQ;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/**
+ * @brief	DMA interrupt handler, one entry per completed capture block
+ * @return	Nothing
+ */
+void DMA_IRQHandler(void)
+{
+	uint32_t pending = Chip_DMA_GetActiveIntAChannels(LPC_DMA);
+	uint32_t i;
+
+	for (i = 0; i < ADC_DMA_MAX_STREAMS; i++) {
+		ADC_DMA_STREAM_T *pStream = activeStream[i];
+
+		if ((pStream != NULL) && (pending & (1 << pStream->dmaCh))) {
+			Chip_DMA_ClearActiveIntAChannel(LPC_DMA, pStream->dmaCh);
+			pStream->doneCount++;
+			latchMark(pStream);
+		}
+	}
+}
+
+/* Initialize the DMA controller for ADC capture */
+void ADC_DMA_Init(void)
+{
+	Chip_DMA_Init(LPC_DMA);
+	Chip_DMA_Enable(LPC_DMA);
+	Chip_DMA_SetSRAMBase(LPC_DMA, DMA_ADDR(Chip_DMA_Table));
+
+	NVIC_EnableIRQ(DMA_IRQn);
+}
+
+/* Start capturing an ADC sequencer into a stream */
+bool ADC_DMA_Start(ADC_DMA_STREAM_T *pStream, LPC_ADC_T *pADC, ADC_SEQ_IDX_T seqIndex, DMA_CHID_T dmaCh)
+{
+	DMA_CHDESC_T *pDesc;
+	uint32_t slot;
+
+	for (slot = 0; slot < ADC_DMA_MAX_STREAMS; slot++) {
+		if (activeStream[slot] == NULL) {
+			break;
+		}
+	}
+	if (slot == ADC_DMA_MAX_STREAMS) {
+		return false;
+	}
+
+	pStream->pADC = pADC;
+	pStream->seqIndex = seqIndex;
+	pStream->dmaCh = dmaCh;
+	pStream->doneCount = 0;
+	pStream->readCount = 0;
+	pStream->lostCount = 0;
+
+	/* Source and destination are end addresses of the transfer */
+	pDesc = dmaDesc[slot];
+	pDesc[0].xfercfg = ADC_DMA_XFERCFG;
+	pDesc[0].source = DMA_ADDR(&pADC->SEQ_GDAT[seqIndex]);
+	pDesc[0].dest = DMA_ADDR(&pStream->block[0][ADC_DMA_BLOCK_SAMPLES - 1]);
+	pDesc[0].next = DMA_ADDR(&pDesc[1]);
+	pDesc[1].xfercfg = ADC_DMA_XFERCFG;
+	pDesc[1].source = DMA_ADDR(&pADC->SEQ_GDAT[seqIndex]);
+	pDesc[1].dest = DMA_ADDR(&pStream->block[1][ADC_DMA_BLOCK_SAMPLES - 1]);
+	pDesc[1].next = DMA_ADDR(&pDesc[0]);
+
+	/* The channel starts with a working copy of the first descriptor */
+	Chip_DMA_Table[dmaCh] = pDesc[0];
+
+	Chip_DMATRIGMUX_SetInputTrig(LPC_DMATRIGMUX, dmaCh, getTrigSource(pADC, seqIndex));
+	Chip_DMA_EnableChannel(LPC_DMA, dmaCh);
+	Chip_DMA_EnableIntChannel(LPC_DMA, dmaCh);
+	Chip_DMA_SetupChannelConfig(LPC_DMA, dmaCh, (DMA_CFG_HWTRIGEN | DMA_CFG_TRIGPOL_HIGH |
+												 DMA_CFG_TRIGTYPE_EDGE | DMA_CFG_TRIGBURST_BURST |
+												 DMA_CFG_BURSTPOWER_1 | DMA_CFG_CHPRIORITY(0)));
+
+	activeStream[slot] = pStream;
+
+	Chip_DMA_SetupChannelTransfer(LPC_DMA, dmaCh, ADC_DMA_XFERCFG);
+	Chip_DMA_SetValidChannel(LPC_DMA, dmaCh);
+
+	return true;
+}
+
+/* Stop a capture stream */
+void ADC_DMA_Stop(ADC_DMA_STREAM_T *pStream)
+{
+	uint32_t slot;
+
+	Chip_DMA_DisableIntChannel(LPC_DMA, pStream->dmaCh);
+	Chip_DMA_DisableChannel(LPC_DMA, pStream->dmaCh);
+	Chip_DMA_AbortChannel(LPC_DMA, pStream->dmaCh);
+
+	for (slot = 0; slot < ADC_DMA_MAX_STREAMS; slot++) {
+		if (activeStream[slot] == pStream) {
+			activeStream[slot] = NULL;
+		}
+	}
+}
+
+/* Return the oldest completed block of a stream */
+const uint32_t *ADC_DMA_GetBlock(ADC_DMA_STREAM_T *pStream)
+{
+	uint32_t done = pStream->doneCount;
+
+	if (done == pStream->readCount) {
+		return NULL;
+	}
+	Diag_HighWater(&g_diag.dmaBacklogMax, done - pStream->readCount);
+
+	/* Only the last completed block is intact, the DMA is already
+	   refilling the other one */
+	if ((done - pStream->readCount) > 1) {
+		pStream->lostCount += (done - pStream->readCount) - 1;
+		g_diag.dmaBlocksLost += (done - pStream->readCount) - 1;
+		pStream->readCount = done - 1;
+	}
+
+	return pStream->block[pStream->readCount & 1];
+}
+
+/* Give back the block returned by ADC_DMA_GetBlock() */
+void ADC_DMA_ReleaseBlock(ADC_DMA_STREAM_T *pStream)
+{
+	pStream->readCount++;
+}
+
+/* Return the time reference of the block returned by ADC_DMA_GetBlock() */
+const ADC_TIME_MARK_T *ADC_DMA_GetMark(const ADC_DMA_STREAM_T *pStream)
+{
+	return &pStream->mark[pStream->readCount & 1];
+}
+
+/* Return the index of the latest sample moved by the DMA */
+uint32_t ADC_DMA_GetSampleIndex(const ADC_DMA_STREAM_T *pStream)
+{
+	uint32_t done, left, blocks;
+
+	/* Retry if the block interrupt ran in between */
+	do {
+		done = pStream->doneCount;
+		left = ADC_DMA_XFER_LEFT(LPC_DMA->DMACH[pStream->dmaCh].XFERCFG);
+		blocks = done;
+		if (Chip_DMA_GetActiveIntAChannels(LPC_DMA) & (1 << pStream->dmaCh)) {
+			blocks++;
+		}
+	} while (done != pStream->doneCount);
+
+	return (blocks * ADC_DMA_BLOCK_SAMPLES) + (ADC_DMA_BLOCK_SAMPLES - left) - 1;
+}
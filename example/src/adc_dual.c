@@ -0,0 +1,249 @@
+/*
+ * @brief Dual ADC0/ADC1 sampling from a common SCT trigger
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "adc_trig.h"
+#include "adc_dma.h"
+#include "adc_dual.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define ADC0_SEQA_DMA_CH    DMA_CH1
+#define ADC1_SEQA_DMA_CH    DMA_CH0
+
+static ADC_DMA_STREAM_T adc0Stream, adc1Stream;
+static ADC_DUAL_MATCH_T convMatch[2] = {
+	{0, ADC_DUAL_GAIN_ONE},
+	{0, ADC_DUAL_GAIN_ONE},
+};
+
+/* Merged output and the raw blocks it was made from */
+static uint16_t mergedBlock[ADC_DUAL_BLOCK_SAMPLES];
+static const uint32_t *pLastRaw[2];
+static ADC_TIME_MARK_T lastMark;	/* ADC1 reference of the merged block */
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Count the channels selected in a sequencer channel mask */
+static uint32_t countChannels(uint32_t chans)
+{
+	uint32_t count = 0;
+
+	chans &= ADC_SEQ_CTRL_CHANNELS;
+	while (chans) {
+		chans &= chans - 1;
+		count++;
+	}
+	return count;
+}
+
+/* Apply the converter correction to a raw result and clip to 12 bits */
+static inline uint16_t correctSample(uint32_t raw, int32_t offset, int32_t gain)
+{
+	int32_t v = (((int32_t) ADC_DR_RESULT(raw) - offset) * gain + (ADC_DUAL_GAIN_ONE / 2)) >> 15;
+
+	if (v < 0) {
+		v = 0;
+	}
+	else if (v > 0xFFF) {
+		v = 0xFFF;
+	}
+	return (uint16_t) v;
+}
+
+/* Sum of results and sum of absolute deviations from their mean */
+static void blockSpread(const uint32_t *pRaw, uint32_t *pSum, uint32_t *pDev)
+{
+	uint32_t i, sum = 0, dev = 0;
+	int32_t mean, d;
+
+	for (i = 0; i < ADC_DMA_BLOCK_SAMPLES; i++) {
+		sum += ADC_DR_RESULT(pRaw[i]);
+	}
+	mean = sum / ADC_DMA_BLOCK_SAMPLES;
+	for (i = 0; i < ADC_DMA_BLOCK_SAMPLES; i++) {
+		d = (int32_t) ADC_DR_RESULT(pRaw[i]) - mean;
+		dev += (d < 0) ? -d : d;
+	}
+
+	*pSum = sum;
+	*pDev = dev;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Start ADC0 and ADC1 sequencer A from a common SCT period */
+uint32_t ADC_Dual_Start(uint32_t adc0Chans, uint32_t adc1Chans, uint16_t adc0Phase, uint32_t rateHz)
+{
+	uint32_t rate, conv0 = countChannels(adc0Chans), conv1 = countChannels(adc1Chans);
+
+	/* One DMA request per conversion on both converters */
+	Chip_ADC_SetupSequencer(LPC_ADC0, ADC_SEQA_IDX, (adc0Chans | ADC0_SEQ_CTRL_HWTRIG_SCT |
+													 ADC_SEQ_CTRL_HWTRIG_POLPOS));
+	Chip_ADC_SetupSequencer(LPC_ADC1, ADC_SEQA_IDX, (adc1Chans | ADC1_SEQ_CTRL_HWTRIG_SCT |
+													 ADC_SEQ_CTRL_HWTRIG_POLPOS));
+	Chip_ADC_EnableInt(LPC_ADC0, ADC_INTEN_SEQA_ENABLE);
+	Chip_ADC_EnableInt(LPC_ADC1, ADC_INTEN_SEQA_ENABLE);
+	Chip_ADC_EnableSequencer(LPC_ADC0, ADC_SEQA_IDX);
+	Chip_ADC_EnableSequencer(LPC_ADC1, ADC_SEQA_IDX);
+
+	ADC_DMA_Start(&adc0Stream, LPC_ADC0, ADC_SEQA_IDX, ADC0_SEQA_DMA_CH);
+	ADC_DMA_Start(&adc1Stream, LPC_ADC1, ADC_SEQA_IDX, ADC1_SEQA_DMA_CH);
+
+	/* Both outputs come from the same counter, so the phase offset is exact */
+	ADC_Trig_AttachOutput(ADC_TRIG_OUT_ADC1, ADC_TRIG_PHASE_0);
+	ADC_Trig_AttachOutput(ADC_TRIG_OUT_ADC0, adc0Phase);
+	rate = ADC_Trig_SetRate(rateHz, (conv0 > conv1) ? conv0 : conv1);
+	ADC_Trig_Start();
+
+	return rate;
+}
+
+/* Build the sequencer channel masks for a list of channel pairs */
+bool ADC_Dual_PairMasks(const ADC_DUAL_PAIR_T *pPairs, uint32_t count,
+						uint32_t *pAdc0Chans, uint32_t *pAdc1Chans)
+{
+	uint32_t i, adc0Chans = 0, adc1Chans = 0;
+
+	if ((count == 0) || ((ADC_DMA_BLOCK_SAMPLES % count) != 0)) {
+		return false;
+	}
+
+	for (i = 0; i < count; i++) {
+		if ((pPairs[i].adc0Ch > 11) || (pPairs[i].adc1Ch > 11)) {
+			return false;
+		}
+		if ((i > 0) && ((pPairs[i].adc0Ch <= pPairs[i - 1].adc0Ch) ||
+						(pPairs[i].adc1Ch <= pPairs[i - 1].adc1Ch))) {
+			return false;
+		}
+		adc0Chans |= ADC_SEQ_CTRL_CHANSEL(pPairs[i].adc0Ch);
+		adc1Chans |= ADC_SEQ_CTRL_CHANSEL(pPairs[i].adc1Ch);
+	}
+
+	*pAdc0Chans = adc0Chans;
+	*pAdc1Chans = adc1Chans;
+	return true;
+}
+
+/* Return the next merged block */
+const uint16_t *ADC_Dual_GetBlock(void)
+{
+	const uint32_t *pRaw0 = ADC_DMA_GetBlock(&adc0Stream);
+	const uint32_t *pRaw1 = ADC_DMA_GetBlock(&adc1Stream);
+	int32_t off0 = convMatch[ADC_DUAL_ADC0].offset, gain0 = convMatch[ADC_DUAL_ADC0].gain;
+	int32_t off1 = convMatch[ADC_DUAL_ADC1].offset, gain1 = convMatch[ADC_DUAL_ADC1].gain;
+	uint16_t *pOut = mergedBlock;
+	uint32_t i;
+
+	if ((pRaw0 == NULL) || (pRaw1 == NULL)) {
+		return NULL;
+	}
+
+	/* Blocks must come from the same trigger periods. After a lost block
+	   drop the older one and wait for its partner. */
+	if (adc0Stream.readCount != adc1Stream.readCount) {
+		if ((int32_t) (adc0Stream.readCount - adc1Stream.readCount) < 0) {
+			ADC_DMA_ReleaseBlock(&adc0Stream);
+		}
+		else {
+			ADC_DMA_ReleaseBlock(&adc1Stream);
+		}
+		return NULL;
+	}
+
+	/* ADC1 is triggered at phase 0, so its sample comes first */
+	for (i = 0; i < ADC_DMA_BLOCK_SAMPLES; i++) {
+		*pOut++ = correctSample(pRaw1[i], off1, gain1);
+		*pOut++ = correctSample(pRaw0[i], off0, gain0);
+	}
+
+	pLastRaw[ADC_DUAL_ADC0] = pRaw0;
+	pLastRaw[ADC_DUAL_ADC1] = pRaw1;
+	lastMark = *ADC_DMA_GetMark(&adc1Stream);
+	ADC_DMA_ReleaseBlock(&adc0Stream);
+	ADC_DMA_ReleaseBlock(&adc1Stream);
+
+	return mergedBlock;
+}
+
+/* Set the offset and gain correction of one converter */
+void ADC_Dual_SetMatch(ADC_DUAL_CONV_T conv, const ADC_DUAL_MATCH_T *pMatch)
+{
+	convMatch[conv] = *pMatch;
+}
+
+/* Estimate the correction of ADC0 against ADC1 */
+bool ADC_Dual_EstimateMatch(ADC_DUAL_MATCH_T *pMatch)
+{
+	uint32_t sum0, dev0, sum1, dev1;
+
+	if ((pLastRaw[ADC_DUAL_ADC0] == NULL) || (pLastRaw[ADC_DUAL_ADC1] == NULL)) {
+		return false;
+	}
+
+	blockSpread(pLastRaw[ADC_DUAL_ADC0], &sum0, &dev0);
+	blockSpread(pLastRaw[ADC_DUAL_ADC1], &sum1, &dev1);
+
+	/* Less than one LSB of average deviation says nothing about gain */
+	if ((dev0 < ADC_DMA_BLOCK_SAMPLES) || (dev1 < ADC_DMA_BLOCK_SAMPLES)) {
+		return false;
+	}
+
+	/* Match ADC0 spread and mean to ADC1:
+	   gain = dev1 / dev0, offset = mean0 - mean1 / gain */
+	pMatch->gain = (int32_t) (((uint64_t) dev1 << 15) / dev0);
+	pMatch->offset = (int32_t) (((int64_t) sum0 - ((int64_t) sum1 * dev0) / dev1) / ADC_DMA_BLOCK_SAMPLES);
+
+	return true;
+}
+
+/* Return the time reference of the last merged block */
+const ADC_TIME_MARK_T *ADC_Dual_GetMark(void)
+{
+	return &lastMark;
+}
+
+/* Return the index of the latest conversion of one converter */
+uint32_t ADC_Dual_GetSampleIndex(ADC_DUAL_CONV_T conv)
+{
+	return ADC_DMA_GetSampleIndex((conv == ADC_DUAL_ADC0) ? &adc0Stream : &adc1Stream);
+}
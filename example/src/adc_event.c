@@ -0,0 +1,162 @@
+/*
+ * @brief ADC threshold crossing events
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "adc_event.h"
+#include "cycle_count.h"
+#include "diag_stats.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* THCMPCROSS field of a data register */
+#define THCMP_CROSS_DOWN    2
+#define THCMP_CROSS_UP      3
+
+/* Written by the compare interrupt only */
+static ADC_EVENT_T eventQueue[ADC_EVENT_QUEUE_LEN];
+static volatile uint32_t eventHead;
+
+/* Written by the main loop only */
+static volatile uint32_t eventTail;
+
+static uint32_t monitoredChans[2];
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static uint32_t adcNumber(LPC_ADC_T *pADC)
+{
+	return (pADC == LPC_ADC0) ? 0 : 1;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Enable threshold crossing events on ADC channels */
+void ADC_Event_Init(LPC_ADC_T *pADC, uint32_t chanMask, uint16_t low, uint16_t high)
+{
+	uint32_t ch;
+
+	chanMask &= ADC_SEQ_CTRL_CHANNELS;
+	monitoredChans[adcNumber(pADC)] = chanMask;
+
+	ADC_Event_SetThresholds(pADC, low, high);
+	Chip_ADC_SelectTH0Channels(pADC, chanMask);
+	for (ch = 0; ch < 12; ch++) {
+		if (chanMask & (1 << ch)) {
+			Chip_ADC_SetThresholdInt(pADC, ch, ADC_INTEN_THCMP_CROSSING);
+		}
+	}
+
+	/* Drop crossings seen before the subsystem was ready */
+	Chip_ADC_ClearFlags(pADC, chanMask);
+	NVIC_EnableIRQ((pADC == LPC_ADC0) ? ADC0_THCMP_IRQn : ADC1_THCMP_IRQn);
+}
+
+/* Change the thresholds of the monitored channels */
+void ADC_Event_SetThresholds(LPC_ADC_T *pADC, uint16_t low, uint16_t high)
+{
+	Chip_ADC_SetThrLowValue(pADC, 0, low & 0xFFF);
+	Chip_ADC_SetThrHighValue(pADC, 0, high & 0xFFF);
+}
+
+/* Queue the pending threshold events of an ADC */
+void ADC_Event_Capture(LPC_ADC_T *pADC, uint32_t sampleIndex)
+{
+	uint32_t now = CycleCount_Get();
+	uint32_t num = adcNumber(pADC);
+	uint32_t pending = Chip_ADC_GetFlags(pADC) & monitoredChans[num];
+	uint32_t ch, raw, cross;
+	ADC_EVENT_T *pEvent;
+
+	/* The channel flags are the only compare sources, clearing them also
+	   clears the interrupt */
+	Chip_ADC_ClearFlags(pADC, pending);
+
+	while (pending) {
+		ch = 31 - __CLZ(pending);
+		pending &= ~(1 << ch);
+
+		/* The channel data register keeps the result that crossed */
+		raw = Chip_ADC_GetDataReg(pADC, ch);
+		cross = ADC_DR_THCMPCROSS(raw);
+		if ((cross != THCMP_CROSS_DOWN) && (cross != THCMP_CROSS_UP)) {
+			continue;
+		}
+
+		if ((eventHead - eventTail) >= ADC_EVENT_QUEUE_LEN) {
+			g_diag.eventsLost++;
+			continue;
+		}
+
+		pEvent = &eventQueue[eventHead & (ADC_EVENT_QUEUE_LEN - 1)];
+		pEvent->timestamp = now;
+		pEvent->sampleIndex = sampleIndex;
+		pEvent->value = ADC_DR_RESULT(raw);
+		pEvent->adcNum = num;
+		pEvent->channel = ch;
+		pEvent->dir = (cross == THCMP_CROSS_UP) ? ADC_EVENT_UP : ADC_EVENT_DOWN;
+		eventHead++;
+		Diag_HighWater(&g_diag.eventQueueMax, eventHead - eventTail);
+	}
+}
+
+/* Look at the oldest queued event without taking it */
+bool ADC_Event_Peek(ADC_EVENT_T *pEvent)
+{
+	uint32_t tail = eventTail;
+
+	if (tail == eventHead) {
+		return false;
+	}
+
+	*pEvent = eventQueue[tail & (ADC_EVENT_QUEUE_LEN - 1)];
+	return true;
+}
+
+/* Take the oldest queued event */
+bool ADC_Event_Get(ADC_EVENT_T *pEvent)
+{
+	if (!ADC_Event_Peek(pEvent)) {
+		return false;
+	}
+
+	eventTail++;
+	return true;
+}
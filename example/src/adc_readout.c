@@ -0,0 +1,124 @@
+/*
+ * @brief Channel mask driven ADC result readout
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "adc_readout.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Build the readout plan of a channel mask */
+uint32_t ADC_Readout_Init(ADC_READOUT_T *pR, uint32_t chanMask, uint32_t blockWords)
+{
+	uint32_t ch, n = 0, discard;
+
+	chanMask &= ADC_SEQ_CTRL_CHANNELS;
+	for (ch = 0; ch < ADC_READOUT_CHANNELS; ch++) {
+		if (chanMask & (1 << ch)) {
+			pR->chans[n++] = ch;
+		}
+	}
+
+	if (blockWords > ADC_READOUT_BLOCK_WORDS) {
+		blockWords = ADC_READOUT_BLOCK_WORDS;
+	}
+
+	pR->chanMask = chanMask;
+	pR->numChans = n;
+	pR->stride = (n != 0) ? (((blockWords + n - 1) / n) + 1) : 0;
+
+	/* Channels outside the mask all write the same word after the slots */
+	discard = n * pR->stride;
+	for (ch = 0; ch < ADC_READOUT_TAGS; ch++) {
+		pR->offset[ch] = discard;
+		pR->step[ch] = 0;
+	}
+	for (n = 0; n < pR->numChans; n++) {
+		pR->offset[pR->chans[n]] = n * pR->stride;
+		pR->step[pR->chans[n]] = 1;
+	}
+
+	return pR->numChans;
+}
+
+/* Read the data registers of the enabled channels */
+void ADC_Readout_Regs(const ADC_READOUT_T *pR, LPC_ADC_T *pADC, uint16_t *pOut,
+					  uint32_t *pValid, uint32_t *pOvr)
+{
+	uint32_t slot, raw, valid = 0, ovr = 0;
+
+	for (slot = 0; slot < pR->numChans; slot++) {
+		raw = pADC->DR[pR->chans[slot]];
+		pOut[slot] = ADC_DR_RESULT(raw);
+		valid |= (raw >> 31) << slot;
+		ovr |= ((raw >> 30) & 1) << slot;
+	}
+
+	*pValid = valid;
+	*pOvr = ovr;
+}
+
+/* Sort a block of raw sequence results into slots */
+void ADC_Readout_Block(const ADC_READOUT_T *pR, const uint32_t *pRaw, uint32_t count,
+					   ADC_SOA_BLOCK_T *pBlock)
+{
+	uint16_t wr[ADC_READOUT_TAGS];
+	uint32_t i, w, tag;
+
+	for (i = 0; i < ADC_READOUT_TAGS; i++) {
+		wr[i] = pR->offset[i];
+	}
+
+	/* The CHANNEL field selects the slot, no test per word */
+	for (i = 0; i < count; i++) {
+		w = pRaw[i];
+		tag = ADC_DR_CHANNEL(w);
+		pBlock->data[wr[tag]] = ADC_DR_RESULT(w);
+		wr[tag] += pR->step[tag];
+	}
+
+	for (i = 0; i < pR->numChans; i++) {
+		pBlock->len[i] = wr[pR->chans[i]] - pR->offset[pR->chans[i]];
+	}
+}
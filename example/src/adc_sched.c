@@ -0,0 +1,293 @@
+/*
+ * @brief Multi-rate scheduler for slow ADC channels
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "board.h"
+#include "adc_sched.h"
+#include "cycle_count.h"
+#include "diag_stats.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* ADC channels per converter */
+#define SCHED_ADC_CHANNELS  12
+
+/* Longest wait for a sequence in progress when stopping, in microseconds */
+#define SCHED_STOP_WAIT_US  100
+
+/* Slow channels of one ADC */
+typedef struct {
+	LPC_ADC_T *pADC;
+	LPC_MRT_CH_T *pMRT;
+	uint32_t tickHz;			/* Group timer rate, 0 for an empty group */
+	uint32_t chans;				/* Channels of the group */
+	uint16_t divider[SCHED_ADC_CHANNELS];	/* Ticks between two samples of a channel */
+	uint16_t countdown[SCHED_ADC_CHANNELS];	/* Ticks left until a channel is due */
+	uint32_t pending;			/* Channels due and not converted yet */
+	uint32_t inflight;			/* Channels of the sequence started last */
+	uint32_t stamp;				/* Cycle count when that sequence was started */
+	volatile bool busy;			/* Sequence started, results not read yet */
+} SCHED_GROUP_T;
+
+static SCHED_GROUP_T groups[2];
+
+/* Written by the sequence interrupts only */
+static ADC_SCHED_REC_T recQueue[ADC_SCHED_QUEUE_LEN];
+static volatile uint32_t recHead;
+
+/* Written by the main loop only */
+static volatile uint32_t recTail;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Convert the due channels of a group with one sequence B pass. The
+   channel selection can only change while the sequencer is disabled. */
+static void startGroup(SCHED_GROUP_T *pGroup)
+{
+	pGroup->inflight = pGroup->pending;
+	pGroup->stamp = CycleCount_Get();
+	pGroup->busy = true;
+
+	Chip_ADC_SetupSequencer(pGroup->pADC, ADC_SEQB_IDX, (pGroup->inflight | ADC_SEQ_CTRL_MODE_EOS));
+	Chip_ADC_EnableSequencer(pGroup->pADC, ADC_SEQB_IDX);
+	Chip_ADC_StartSequencer(pGroup->pADC, ADC_SEQB_IDX);
+}
+
+/* One timer tick of a group */
+static void tickGroup(SCHED_GROUP_T *pGroup)
+{
+	uint32_t chans = pGroup->chans, due = 0, ch;
+
+	while (chans) {
+		ch = 31 - __CLZ(chans);
+		chans &= ~(1 << ch);
+
+		if (--pGroup->countdown[ch] == 0) {
+			pGroup->countdown[ch] = pGroup->divider[ch];
+			due |= (1 << ch);
+		}
+	}
+	pGroup->pending |= due;
+
+	/* A sequence B start is ignored while sequence A converts. Its results
+	   would have been read long before this tick, so start it again. */
+	if (pGroup->busy) {
+		g_diag.schedRetries++;
+	}
+	if (pGroup->pending) {
+		startGroup(pGroup);
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/**
+ * @brief	Handle interrupt from the multi-rate timer
+ * @return	Nothing
+ */
+void MRT_IRQHandler(void)
+{
+	uint32_t num;
+
+	for (num = 0; num < 2; num++) {
+		if ((groups[num].tickHz != 0) && Chip_MRT_IntPending(groups[num].pMRT)) {
+			Chip_MRT_IntClear(groups[num].pMRT);
+			tickGroup(&groups[num]);
+		}
+	}
+}
+
+/* Set up the slow channel groups */
+bool ADC_Sched_Init(const ADC_SCHED_CHAN_T *pChans, uint32_t count)
+{
+	SCHED_GROUP_T *pGroup;
+	uint32_t i, num, ch;
+
+	if (count > ADC_SCHED_MAX_CHANNELS) {
+		return false;
+	}
+
+	memset(groups, 0, sizeof(groups));
+	groups[0].pADC = LPC_ADC0;
+	groups[1].pADC = LPC_ADC1;
+
+	/* The fastest channel sets the group tick */
+	for (i = 0; i < count; i++) {
+		num = pChans[i].adcNum;
+		ch = pChans[i].channel;
+		if ((num > 1) || (ch >= SCHED_ADC_CHANNELS) || (pChans[i].rateHz == 0) ||
+			(groups[num].chans & (1 << ch))) {
+			return false;
+		}
+		groups[num].chans |= (1 << ch);
+		if (pChans[i].rateHz > groups[num].tickHz) {
+			groups[num].tickHz = pChans[i].rateHz;
+		}
+	}
+
+	Chip_MRT_Init();
+
+	for (num = 0; num < 2; num++) {
+		pGroup = &groups[num];
+		if (pGroup->chans == 0) {
+			continue;
+		}
+		if (pGroup->tickHz < ADC_SCHED_MIN_TICK_HZ) {
+			pGroup->tickHz = ADC_SCHED_MIN_TICK_HZ;
+		}
+		pGroup->pMRT = Chip_MRT_GetRegPtr(ADC_SCHED_MRT_CH(num));
+		Chip_MRT_SetMode(pGroup->pMRT, MRT_MODE_REPEAT);
+
+		Chip_ADC_SetupSequencer(pGroup->pADC, ADC_SEQB_IDX, ADC_SEQ_CTRL_MODE_EOS);
+		Chip_ADC_ClearFlags(pGroup->pADC, ADC_FLAGS_SEQB_INT_MASK);
+		Chip_ADC_EnableInt(pGroup->pADC, ADC_INTEN_SEQB_ENABLE);
+		NVIC_EnableIRQ((num == 0) ? ADC0_SEQB_IRQn : ADC1_SEQB_IRQn);
+	}
+
+	/* Every channel is converted on the first tick */
+	for (i = 0; i < count; i++) {
+		pGroup = &groups[pChans[i].adcNum];
+		ch = pChans[i].channel;
+		pGroup->divider[ch] = pGroup->tickHz / pChans[i].rateHz;
+		pGroup->countdown[ch] = 1;
+	}
+
+	return true;
+}
+
+/* Start the group timers */
+void ADC_Sched_Start(void)
+{
+	uint32_t num, sysClk = Chip_Clock_GetSystemClockRate();
+
+	for (num = 0; num < 2; num++) {
+		if (groups[num].tickHz != 0) {
+			Chip_MRT_SetInterval(groups[num].pMRT, (sysClk / groups[num].tickHz) | MRT_INTVAL_LOAD);
+			Chip_MRT_SetEnabled(groups[num].pMRT);
+		}
+	}
+	NVIC_EnableIRQ(MRT_IRQn);
+}
+
+/* Stop the group timers */
+void ADC_Sched_Stop(void)
+{
+	uint32_t num, start, maxWait = (SystemCoreClock / 1000000) * SCHED_STOP_WAIT_US;
+
+	for (num = 0; num < 2; num++) {
+		if (groups[num].tickHz != 0) {
+			/* Loading a zero interval forces the channel idle */
+			Chip_MRT_SetInterval(groups[num].pMRT, MRT_INTVAL_LOAD);
+			Chip_MRT_SetDisabled(groups[num].pMRT);
+		}
+	}
+
+	/* A start that sequence A swallowed never completes, its channels
+	   stay pending for the next start */
+	start = CycleCount_Get();
+	for (num = 0; num < 2; num++) {
+		while (groups[num].busy && ((CycleCount_Get() - start) < maxWait)) {}
+		groups[num].busy = false;
+	}
+}
+
+/* Queue the results of a completed slow group sequence */
+void ADC_Sched_SeqHandler(LPC_ADC_T *pADC)
+{
+	SCHED_GROUP_T *pGroup = &groups[(pADC == LPC_ADC0) ? 0 : 1];
+	uint32_t chans = pGroup->inflight, done = 0, ch, raw;
+	ADC_SCHED_REC_T *pRec;
+
+	Chip_ADC_ClearFlags(pADC, ADC_FLAGS_SEQB_INT_MASK);
+	if (!pGroup->busy) {
+		return;
+	}
+
+	while (chans) {
+		ch = 31 - __CLZ(chans);
+		chans &= ~(1 << ch);
+
+		raw = Chip_ADC_GetDataReg(pADC, ch);
+		if ((raw & ADC_DR_DATAVALID) == 0) {
+			continue;
+		}
+		done |= (1 << ch);
+
+		if ((recHead - recTail) >= ADC_SCHED_QUEUE_LEN) {
+			g_diag.schedRecordsLost++;
+			continue;
+		}
+
+		pRec = &recQueue[recHead & (ADC_SCHED_QUEUE_LEN - 1)];
+		pRec->timestamp = pGroup->stamp;
+		pRec->value = ADC_DR_RESULT(raw);
+		pRec->adcNum = (pADC == LPC_ADC0) ? 0 : 1;
+		pRec->channel = ch;
+		recHead++;
+	}
+
+	pGroup->pending &= ~done;
+	pGroup->busy = false;
+}
+
+/* Take the oldest queued record */
+bool ADC_Sched_Get(ADC_SCHED_REC_T *pRec)
+{
+	if (!ADC_Sched_Peek(pRec)) {
+		return false;
+	}
+	recTail++;
+
+	return true;
+}
+
+/* Look at the oldest queued record without taking it */
+bool ADC_Sched_Peek(ADC_SCHED_REC_T *pRec)
+{
+	uint32_t tail = recTail;
+
+	if (tail == recHead) {
+		return false;
+	}
+	*pRec = recQueue[tail & (ADC_SCHED_QUEUE_LEN - 1)];
+
+	return true;
+}
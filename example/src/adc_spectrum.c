@@ -0,0 +1,191 @@
+/*
+ * @brief Averaged magnitude spectra of the ADC sample stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "board.h"
+#include "adc_spectrum.h"
+#include "cycle_count.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Mid-scale of the 12-bit samples */
+#define SPECTRUM_OFFSET     2048
+
+/* (sample - offset) * Q15 weight is brought down to DSP_FFT_MAX_INPUT */
+#define SPECTRUM_IN_SHIFT   6
+
+/* Frame and window share Ram1_16 with the capture history, 6 KB */
+static int32_t frame[DSP_FFT_MAX_SIZE] __attribute__ ((section(".bss.$RAM2")));
+static int16_t window[DSP_FFT_MAX_SIZE] __attribute__ ((section(".bss.$RAM2")));
+
+static uint32_t magSum[DSP_FFT_MAX_SIZE / 2];
+static uint16_t bins[DSP_FFT_MAX_SIZE / 2];
+
+static ADC_SPECTRUM_CFG_T specCfg;
+static ADC_SPECTRUM_STATS_T specStats;
+static uint32_t magScale;		/* Q32 factor from FFT magnitude to 1/16 LSB */
+static uint32_t fill;			/* Samples in the frame */
+static uint32_t summed;			/* Frames in magSum */
+static uint32_t frameCycles;	/* Windowing cycles of the frame being filled */
+static uint32_t seq;
+static bool ready;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Transform a full frame and add it to the average */
+static void processFrame(void)
+{
+	uint32_t k, start = CycleCount_Get();
+
+	DSP_Fft_Real(frame, specCfg.size);
+	DSP_Fft_AddMagnitude(frame, specCfg.size, magScale, magSum);
+
+	frameCycles += CycleCount_Get() - start;
+	specStats.cyclesLast = frameCycles;
+	if (frameCycles > specStats.cyclesMax) {
+		specStats.cyclesMax = frameCycles;
+	}
+	frameCycles = 0;
+	specStats.frames++;
+
+	if (++summed < specCfg.average) {
+		return;
+	}
+
+	if (ready) {
+		specStats.dropped++;
+	}
+	else {
+		for (k = 0; k < (specCfg.size / 2); k++) {
+			bins[k] = (uint16_t) (magSum[k] / specCfg.average);
+		}
+		seq++;
+		ready = true;
+		specStats.spectra++;
+	}
+	memset(magSum, 0, sizeof(magSum));
+	summed = 0;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Set up the frame size, window and averaging */
+bool ADC_Spectrum_Config(const ADC_SPECTRUM_CFG_T *pCfg)
+{
+	uint32_t windowSum;
+
+	if (!DSP_Fft_IsValidSize(pCfg->size) || (pCfg->window >= DSP_FFT_WIN_COUNT) ||
+		(pCfg->average == 0) || (pCfg->average > ADC_SPECTRUM_MAX_AVERAGE)) {
+		return false;
+	}
+
+	specCfg = *pCfg;
+	windowSum = DSP_Fft_Window(window, specCfg.size, specCfg.window);
+
+	/* A sinusoid of amplitude A gives A * windowSum / 2^(SPECTRUM_IN_SHIFT + 1)
+	   at its bin */
+	magScale = (uint32_t) ((1ULL << (32 + SPECTRUM_IN_SHIFT + 1 + ADC_SPECTRUM_FRAC_BITS)) / windowSum);
+
+	memset(magSum, 0, sizeof(magSum));
+	memset(&specStats, 0, sizeof(specStats));
+	fill = 0;
+	summed = 0;
+	frameCycles = 0;
+	ready = false;
+
+	return true;
+}
+
+/* Return the spectrum set up */
+const ADC_SPECTRUM_CFG_T *ADC_Spectrum_GetConfig(void)
+{
+	return &specCfg;
+}
+
+/* Window samples into the frame, transform every full frame */
+void ADC_Spectrum_Write(const uint16_t *pSamples, uint32_t count)
+{
+	uint32_t n, start;
+
+	while (count) {
+		start = CycleCount_Get();
+		n = specCfg.size - fill;
+		if (n > count) {
+			n = count;
+		}
+		count -= n;
+		while (n--) {
+			frame[fill] = (((int32_t) *pSamples++ - SPECTRUM_OFFSET) * window[fill]) >> SPECTRUM_IN_SHIFT;
+			fill++;
+		}
+		frameCycles += CycleCount_Get() - start;
+
+		if (fill == specCfg.size) {
+			processFrame();
+			fill = 0;
+		}
+	}
+}
+
+/* Return the averaged spectrum waiting to be read */
+const uint16_t *ADC_Spectrum_GetBins(uint32_t *pSeq)
+{
+	if (!ready) {
+		return NULL;
+	}
+	if (pSeq != NULL) {
+		*pSeq = seq;
+	}
+
+	return bins;
+}
+
+/* Release the spectrum returned by ADC_Spectrum_GetBins() */
+void ADC_Spectrum_Release(void)
+{
+	ready = false;
+}
+
+/* Return the counters of the spectrum stage */
+const ADC_SPECTRUM_STATS_T *ADC_Spectrum_GetStats(void)
+{
+	return &specStats;
+}
@@ -0,0 +1,247 @@
+/*
+ * @brief Windowed min/max/mean/RMS statistics of the ADC sample stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "board.h"
+#include "adc_summary.h"
+#include "diag_stats.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Accumulators of the current window of one channel */
+typedef struct {
+	uint32_t count;				/* Samples in the window so far */
+	uint32_t sum;				/* Below 2^28 for the longest window */
+	uint64_t sumSq;				/* Below 2^40 for the longest window */
+	uint16_t min;
+	uint16_t max;
+	uint32_t seq;				/* Windows completed */
+} SUMMARY_ACC_T;
+
+static ADC_SUMMARY_CHAN_T chanList[ADC_SUMMARY_MAX_CHANNELS];
+static SUMMARY_ACC_T acc[ADC_SUMMARY_MAX_CHANNELS];
+static uint32_t numChannels;
+static uint32_t windowLen;
+
+/* Written by the producer only */
+static ADC_SUMMARY_REC_T recQueue[ADC_SUMMARY_QUEUE_LEN];
+static volatile uint32_t recHead;
+
+/* Written by the consumer only */
+static volatile uint32_t recTail;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Integer square root, rounded down */
+static uint32_t isqrt64(uint64_t v)
+{
+	uint64_t root = 0, bit = 1ULL << 62;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit) {
+		if (v >= (root + bit)) {
+			v -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint32_t) root;
+}
+
+/* Start a new window on every channel */
+static void resetWindows(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < ADC_SUMMARY_MAX_CHANNELS; i++) {
+		acc[i].count = 0;
+		acc[i].sum = 0;
+		acc[i].sumSq = 0;
+		acc[i].min = 0xFFFF;
+		acc[i].max = 0;
+	}
+}
+
+/* Queue the record of a full window and start the next one */
+static void closeWindow(uint32_t idx)
+{
+	SUMMARY_ACC_T *pAcc = &acc[idx];
+	ADC_SUMMARY_REC_T *pRec;
+	uint32_t n = pAcc->count;
+
+	if ((recHead - recTail) >= ADC_SUMMARY_QUEUE_LEN) {
+		g_diag.summaryRecordsLost++;
+	}
+	else {
+		pRec = &recQueue[recHead & (ADC_SUMMARY_QUEUE_LEN - 1)];
+		pRec->seq = pAcc->seq;
+		pRec->count = n;
+		pRec->min = pAcc->min;
+		pRec->max = pAcc->max;
+		pRec->mean = (uint16_t) ((((uint64_t) pAcc->sum << ADC_SUMMARY_FRAC_BITS) + (n / 2)) / n);
+		pRec->rms = (uint16_t) isqrt64((pAcc->sumSq << (2 * ADC_SUMMARY_FRAC_BITS)) / n);
+		pRec->adcNum = chanList[idx].adcNum;
+		pRec->channel = chanList[idx].channel;
+		recHead++;
+	}
+
+	pAcc->seq++;
+	pAcc->count = 0;
+	pAcc->sum = 0;
+	pAcc->sumSq = 0;
+	pAcc->min = 0xFFFF;
+	pAcc->max = 0;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Set up the summarized channels and the window */
+bool ADC_Summary_Init(const ADC_SUMMARY_CHAN_T *pChans, uint32_t numChans, uint32_t window)
+{
+	if ((numChans == 0) || (numChans > ADC_SUMMARY_MAX_CHANNELS) ||
+		(window == 0) || (window > ADC_SUMMARY_MAX_WINDOW)) {
+		return false;
+	}
+
+	memcpy(chanList, pChans, numChans * sizeof(chanList[0]));
+	memset(acc, 0, sizeof(acc));
+	numChannels = numChans;
+	windowLen = window;
+	resetWindows();
+
+	return true;
+}
+
+/* Change the window length */
+bool ADC_Summary_SetWindow(uint32_t window)
+{
+	if ((window == 0) || (window > ADC_SUMMARY_MAX_WINDOW)) {
+		return false;
+	}
+
+	windowLen = window;
+	resetWindows();
+
+	return true;
+}
+
+/* Return the window length */
+uint32_t ADC_Summary_GetWindow(void)
+{
+	return windowLen;
+}
+
+/* Add samples of one channel to its window */
+void ADC_Summary_Write(uint32_t idx, const uint16_t *pSamples, uint32_t count, uint32_t stride)
+{
+	SUMMARY_ACC_T *pAcc = &acc[idx];
+	uint32_t n, v, sum, lo, hi;
+	uint64_t sumSq;
+
+	if (idx >= numChannels) {
+		return;
+	}
+
+	while (count) {
+		n = windowLen - pAcc->count;
+		if (n > count) {
+			n = count;
+		}
+		count -= n;
+		pAcc->count += n;
+
+		/* Accumulators stay in registers over the run */
+		sum = pAcc->sum;
+		sumSq = pAcc->sumSq;
+		lo = pAcc->min;
+		hi = pAcc->max;
+		while (n--) {
+			v = *pSamples;
+			pSamples += stride;
+			sum += v;
+			sumSq += v * v;
+			if (v < lo) {
+				lo = v;
+			}
+			if (v > hi) {
+				hi = v;
+			}
+		}
+		pAcc->sum = sum;
+		pAcc->sumSq = sumSq;
+		pAcc->min = (uint16_t) lo;
+		pAcc->max = (uint16_t) hi;
+
+		if (pAcc->count == windowLen) {
+			closeWindow(idx);
+		}
+	}
+}
+
+/* Take the oldest queued record */
+bool ADC_Summary_Get(ADC_SUMMARY_REC_T *pRec)
+{
+	if (!ADC_Summary_Peek(pRec)) {
+		return false;
+	}
+	recTail++;
+
+	return true;
+}
+
+/* Look at the oldest queued record without taking it */
+bool ADC_Summary_Peek(ADC_SUMMARY_REC_T *pRec)
+{
+	uint32_t tail = recTail;
+
+	if (tail == recHead) {
+		return false;
+	}
+	*pRec = recQueue[tail & (ADC_SUMMARY_QUEUE_LEN - 1)];
+
+	return true;
+}
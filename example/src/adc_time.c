@@ -0,0 +1,94 @@
+/*
+ * @brief Sample time references locked to the USB start of frame
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "adc_time.h"
+#include "cycle_count.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Latest start of frame, the pair is written and read with interrupts
+   disabled so that it stays consistent across interrupt priorities */
+static uint32_t sofFrame, sofCycles;
+static bool sofSeen;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Latch a pending USB start of frame */
+void ADC_Time_SofIrq(void)
+{
+	uint32_t cycles = CycleCount_Get();
+	uint32_t nr;
+
+	if ((LPC_USB->INTSTAT & ADC_TIME_USB_FRAME_INT) == 0) {
+		return;
+	}
+
+	/* Extend the 11-bit frame number, frames missed by a late interrupt
+	   are counted */
+	nr = LPC_USB->INFO & ADC_TIME_USB_FRAME_NR;
+	__disable_irq();
+	if (sofSeen) {
+		sofFrame += (nr - sofFrame) & ADC_TIME_USB_FRAME_NR;
+	}
+	else {
+		sofFrame = nr;
+		sofSeen = true;
+	}
+	sofCycles = cycles;
+	__enable_irq();
+}
+
+/* Return the latest start of frame */
+bool ADC_Time_GetSof(uint32_t *pFrame, uint32_t *pCycles)
+{
+	bool seen;
+
+	__disable_irq();
+	*pFrame = sofFrame;
+	*pCycles = sofCycles;
+	seen = sofSeen;
+	__enable_irq();
+
+	return seen;
+}
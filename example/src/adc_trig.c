@@ -0,0 +1,321 @@
+/*
+ * @brief SCT based hardware trigger for the ADC sequencers
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "adc_trig.h"
+#include "cycle_count.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Ticks from the end of a conversion to the DMA read of its result */
+#define TRIG_DMA_TICKS          16
+
+/* Event control: match only, MATCHSEL in bits 3:0 */
+#define SCT_EV_CTRL_MATCH(m)    ((m) | (1 << 12))
+/* Events are enabled in state 0 only, the SCT never changes state */
+#define SCT_EV_STATE0           (1 << 0)
+
+/* Each output uses one event/match pair for the rising edge and one for
+   the falling edge. Event/match 0 is the period limit. */
+#define TRIG_SET_EV(slot)       (1 + (2 * (slot)))
+#define TRIG_CLR_EV(slot)       (2 + (2 * (slot)))
+
+typedef struct {
+	uint8_t sctOut;
+	uint16_t phase;
+} TRIG_OUT_T;
+
+static TRIG_OUT_T trigOut[ADC_TRIG_MAX_OUTPUTS];
+static uint32_t trigOutCount;
+static uint32_t trigPeriod;
+static uint32_t trigPeriodFrac;	/* Exact period of trigRate, 16.16 ticks */
+static uint32_t trigFracAcc;	/* Fraction carried by ADC_Trig_SetPeriodFrac() */
+static uint32_t trigRate;
+static uint32_t trigSeqTicks;
+static uint32_t trigConvTicks;	/* One conversion after a trigger edge */
+static bool trigRunning;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Counter value at which a given phase occurs. The counter runs from 0 to
+   period - 1; phase 0 is placed on the limit tick so that every output is
+   offset by the same single tick. */
+static uint32_t phaseToMatch(uint32_t period, uint32_t phase)
+{
+	uint32_t pos = (uint32_t) (((uint64_t) period * phase) >> 16);
+
+	return (pos == 0) ? (period - 1) : (pos - 1);
+}
+
+/* Program match values of one output slot */
+static void setupSlotMatch(uint32_t slot, bool reloadOnly)
+{
+	LPC_SCT_T *pSCT = ADC_TRIG_SCT;
+	uint32_t setMatch = phaseToMatch(trigPeriod, trigOut[slot].phase);
+	uint32_t clrMatch = phaseToMatch(trigPeriod, (trigOut[slot].phase + ADC_TRIG_PHASE_180) & 0xFFFF);
+
+	if (!reloadOnly) {
+		pSCT->MATCH[TRIG_SET_EV(slot)].U = setMatch;
+		pSCT->MATCH[TRIG_CLR_EV(slot)].U = clrMatch;
+	}
+	pSCT->MATCHREL[TRIG_SET_EV(slot)].U = setMatch;
+	pSCT->MATCHREL[TRIG_CLR_EV(slot)].U = clrMatch;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the SCT as a free running ADC sample clock */
+void ADC_Trig_Init(void)
+{
+	LPC_SCT_T *pSCT = ADC_TRIG_SCT;
+
+	Chip_SCT_Init(pSCT);
+
+	/* One 32-bit counter, automatically limited (reset) by match 0 */
+	Chip_SCT_Config(pSCT, SCT_CONFIG_32BIT_COUNTER | SCT_CONFIG_AUTOLIMIT_L);
+	Chip_SCT_SetControl(pSCT, SCT_CTRL_HALT_L | SCT_CTRL_CLRCTR_L);
+
+	trigOutCount = 0;
+	trigRate = 0;
+	trigPeriod = 0;
+	trigPeriodFrac = 0;
+	trigFracAcc = 0;
+	trigSeqTicks = 0;
+	trigConvTicks = 0;
+	trigRunning = false;
+}
+
+/* Drive an SCT output as an ADC hardware trigger */
+bool ADC_Trig_AttachOutput(uint8_t sctOut, uint16_t phase)
+{
+	LPC_SCT_T *pSCT = ADC_TRIG_SCT;
+	uint32_t slot = trigOutCount;
+
+	if (slot >= ADC_TRIG_MAX_OUTPUTS) {
+		return false;
+	}
+
+	trigOut[slot].sctOut = sctOut;
+	trigOut[slot].phase = phase;
+	trigOutCount++;
+
+	pSCT->EVENT[TRIG_SET_EV(slot)].STATE = SCT_EV_STATE0;
+	pSCT->EVENT[TRIG_SET_EV(slot)].CTRL = SCT_EV_CTRL_MATCH(TRIG_SET_EV(slot));
+	pSCT->EVENT[TRIG_CLR_EV(slot)].STATE = SCT_EV_STATE0;
+	pSCT->EVENT[TRIG_CLR_EV(slot)].CTRL = SCT_EV_CTRL_MATCH(TRIG_CLR_EV(slot));
+
+	pSCT->OUT[sctOut].SET = (1 << TRIG_SET_EV(slot));
+	pSCT->OUT[sctOut].CLR = (1 << TRIG_CLR_EV(slot));
+
+	if (trigPeriod != 0) {
+		setupSlotMatch(slot, trigRunning);
+	}
+
+	return true;
+}
+
+/* Fastest trigger rate the ADCs can follow */
+uint32_t ADC_Trig_GetMaxRate(uint32_t convPerTrig)
+{
+	uint32_t sysClk = Chip_Clock_GetSystemClockRate();
+	uint32_t div = (sysClk + ADC_MAX_SAMPLE_RATE - 1) / ADC_MAX_SAMPLE_RATE;
+
+	if (convPerTrig == 0) {
+		convPerTrig = 1;
+	}
+
+	return (sysClk / div) / (ADC_CLOCKS_PER_CONV * convPerTrig);
+}
+
+/* Set the trigger rate */
+uint32_t ADC_Trig_SetRate(uint32_t rateHz, uint32_t convPerTrig)
+{
+	LPC_SCT_T *pSCT = ADC_TRIG_SCT;
+	uint32_t sctClk = Chip_Clock_GetSystemClockRate();
+	uint32_t maxRate = ADC_Trig_GetMaxRate(convPerTrig);
+	uint32_t slot;
+
+	if (rateHz > maxRate) {
+		rateHz = maxRate;
+	}
+	if (rateHz < ADC_TRIG_MIN_RATE_HZ) {
+		rateHz = ADC_TRIG_MIN_RATE_HZ;
+	}
+
+	trigPeriod = sctClk / rateHz;
+	trigPeriodFrac = (uint32_t) (((uint64_t) sctClk << 16) / rateHz);
+	trigFracAcc = 0;
+	trigRate = sctClk / trigPeriod;
+	trigSeqTicks = sctClk / maxRate;
+	trigConvTicks = sctClk / ADC_Trig_GetMaxRate(1);
+
+	/* A running counter picks up the new values at the next limit, all
+	   of them at the same one */
+	if (!trigRunning) {
+		pSCT->MATCH[0].U = trigPeriod - 1;
+	}
+	else {
+		pSCT->CONFIG |= SCT_CONFIG_NORELOADL_U;
+	}
+	pSCT->MATCHREL[0].U = trigPeriod - 1;
+
+	for (slot = 0; slot < trigOutCount; slot++) {
+		setupSlotMatch(slot, trigRunning);
+	}
+	pSCT->CONFIG &= ~SCT_CONFIG_NORELOADL_U;
+
+	return trigRate;
+}
+
+/* Return the programmed trigger rate */
+uint32_t ADC_Trig_GetRate(void)
+{
+	return trigRate;
+}
+
+/* Return the exact period of the programmed rate */
+uint32_t ADC_Trig_GetPeriodFrac(void)
+{
+	return trigPeriodFrac;
+}
+
+/* Trim the period of the running sample clock */
+void ADC_Trig_SetPeriodFrac(uint32_t period)
+{
+	LPC_SCT_T *pSCT = ADC_TRIG_SCT;
+	uint32_t ticks, slot;
+
+	if (trigPeriod == 0) {
+		return;
+	}
+
+	/* Whole ticks this time, the fraction adds up to a tick now and then */
+	trigFracAcc += period & 0xFFFF;
+	ticks = (period >> 16) + (trigFracAcc >> 16);
+	trigFracAcc &= 0xFFFF;
+	if (ticks == trigPeriod) {
+		return;
+	}
+
+	/* Phase 0 sits on the limit tick: a limit between the writes would
+	   start a shorter period with the old edge match, which is never
+	   reached. Hold the reload until every register is written; a limit
+	   in between keeps the old period once more. */
+	trigPeriod = ticks;
+	pSCT->CONFIG |= SCT_CONFIG_NORELOADL_U;
+	pSCT->MATCHREL[0].U = trigPeriod - 1;
+	for (slot = 0; slot < trigOutCount; slot++) {
+		setupSlotMatch(slot, true);
+	}
+	pSCT->CONFIG &= ~SCT_CONFIG_NORELOADL_U;
+}
+
+/* Return the cycle count at the latest phase 0 trigger edge */
+bool ADC_Trig_GetEdgeCycles(uint32_t *pCycles)
+{
+	LPC_SCT_T *pSCT = ADC_TRIG_SCT;
+	uint32_t now = CycleCount_Get();
+	uint32_t count, limit, age;
+
+	if (!trigRunning) {
+		*pCycles = now;
+		return true;
+	}
+
+	/* Phase 0 is the limit tick, the SCT runs on the core clock */
+	count = pSCT->COUNT_U;
+	limit = pSCT->MATCH[0].U;
+	age = (count >= limit) ? 0 : (count + 1);
+	*pCycles = now - age;
+
+	/* At the fastest rates the first conversion takes the whole period */
+	if ((trigConvTicks + TRIG_DMA_TICKS) > limit) {
+		*pCycles -= limit + 1;
+		return true;
+	}
+	return age >= (trigConvTicks + TRIG_DMA_TICKS);
+}
+
+/* Start generating triggers */
+void ADC_Trig_Start(void)
+{
+	trigRunning = true;
+	Chip_SCT_ClearControl(ADC_TRIG_SCT, SCT_CTRL_HALT_L);
+}
+
+/* Stop generating triggers */
+void ADC_Trig_Stop(void)
+{
+	Chip_SCT_SetControl(ADC_TRIG_SCT, SCT_CTRL_HALT_L | SCT_CTRL_CLRCTR_L);
+	trigRunning = false;
+}
+
+/* Stop generating triggers at a period boundary */
+void ADC_Trig_Pause(void)
+{
+	LPC_SCT_T *pSCT = ADC_TRIG_SCT;
+	uint32_t slot, match, limit, start, firstEdge = trigPeriod;
+
+	for (slot = 0; slot < trigOutCount; slot++) {
+		match = phaseToMatch(trigPeriod, trigOut[slot].phase);
+		if (match < firstEdge) {
+			firstEdge = match;
+		}
+	}
+
+	/* Below the first edge every output has fired as often as the others.
+	   Halt in the first half of that window so the write lands in it. */
+	limit = (firstEdge / 2) + 1;
+	while (1) {
+		__disable_irq();
+		if (pSCT->COUNT_U < limit) {
+			break;
+		}
+		__enable_irq();
+	}
+	Chip_SCT_SetControl(pSCT, SCT_CTRL_HALT_L | SCT_CTRL_CLRCTR_L);
+	__enable_irq();
+	trigRunning = false;
+
+	/* Let the sequences started by the last edges complete */
+	start = CycleCount_Get();
+	while ((CycleCount_Get() - start) < trigSeqTicks) {}
+}
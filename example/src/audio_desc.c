@@ -0,0 +1,267 @@
+/*
+ * @brief USB audio class descriptors of the ADC microphone
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "app_usbd_cfg.h"
+
+#if defined(APP_USB_AUDIO)
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Audio class 1.0 codes used below */
+#define UAC_SUBCLASS_AUDIOCONTROL       0x01
+#define UAC_SUBCLASS_AUDIOSTREAMING     0x02
+#define UAC_CS_INTERFACE                0x24
+#define UAC_CS_ENDPOINT                 0x25
+#define UAC_AC_HEADER                   0x01
+#define UAC_AC_INPUT_TERMINAL           0x02
+#define UAC_AC_OUTPUT_TERMINAL          0x03
+#define UAC_AS_GENERAL                  0x01
+#define UAC_AS_FORMAT_TYPE              0x02
+#define UAC_EP_GENERAL                  0x01
+#define UAC_FORMAT_TYPE_I               0x01
+#define UAC_FORMAT_PCM                  0x0001
+#define UAC_TERMINAL_USB_STREAMING      0x0101
+#define UAC_TERMINAL_MICROPHONE         0x0201
+
+/* Terminal IDs of the audio function: the ADC input goes straight to
+   the streaming interface */
+#define UAC_INPUT_TERMINAL_ID           1
+#define UAC_OUTPUT_TERMINAL_ID          2
+
+/* Class specific descriptor sizes */
+#define UAC_AC_HEADER_DESC_SIZE         0x09
+#define UAC_INPUT_TERMINAL_DESC_SIZE    0x0C
+#define UAC_OUTPUT_TERMINAL_DESC_SIZE   0x09
+#define UAC_AS_GENERAL_DESC_SIZE        0x07
+#define UAC_FORMAT_I_DESC_SIZE          0x0B	/* one discrete rate */
+#define UAC_ENDPOINT_DESC_SIZE          0x09	/* standard endpoint plus bRefresh, bSynchAddress */
+#define UAC_CS_ENDPOINT_DESC_SIZE       0x07
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/**
+ * USB Standard Device Descriptor
+ */
+ALIGNED(4) const uint8_t USB_DeviceDescriptor[] = {
+	USB_DEVICE_DESC_SIZE,				/* bLength */
+	USB_DEVICE_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	WBVAL(0x0200),						/* bcdUSB */
+	0x00,								/* bDeviceClass: per interface */
+	0x00,								/* bDeviceSubClass */
+	0x00,								/* bDeviceProtocol */
+	USB_MAX_PACKET0,					/* bMaxPacketSize0 */
+	WBVAL(0x1FC9),						/* idVendor */
+	WBVAL(0x0084),						/* idProduct */
+	WBVAL(0x0100),						/* bcdDevice */
+	0x01,								/* iManufacturer */
+	0x02,								/* iProduct */
+	0x03,								/* iSerialNumber */
+	0x01								/* bNumConfigurations */
+};
+
+/**
+ * USB FSConfiguration Descriptor
+ * All Descriptors (Configuration, Interface, Endpoint, Class, Vendor)
+ */
+ALIGNED(4) uint8_t USB_FsConfigDescriptor[] = {
+	/* Configuration 1 */
+	USB_CONFIGURATION_DESC_SIZE,			/* bLength */
+	USB_CONFIGURATION_DESCRIPTOR_TYPE,		/* bDescriptorType */
+	WBVAL(									/* wTotalLength */
+		USB_CONFIGURATION_DESC_SIZE     +
+		USB_INTERFACE_DESC_SIZE         +	/* audio control interface */
+		UAC_AC_HEADER_DESC_SIZE         +
+		UAC_INPUT_TERMINAL_DESC_SIZE    +
+		UAC_OUTPUT_TERMINAL_DESC_SIZE   +
+		2 * USB_INTERFACE_DESC_SIZE     +	/* audio streaming interface, settings 0 and 1 */
+		UAC_AS_GENERAL_DESC_SIZE        +
+		UAC_FORMAT_I_DESC_SIZE          +
+		UAC_ENDPOINT_DESC_SIZE          +	/* isochronous endpoint */
+		UAC_CS_ENDPOINT_DESC_SIZE       +
+		0
+		),
+	0x02,									/* bNumInterfaces */
+	0x01,									/* bConfigurationValue */
+	0x00,									/* iConfiguration */
+	USB_CONFIG_SELF_POWERED,				/* bmAttributes  */
+	USB_CONFIG_POWER_MA(500),				/* bMaxPower */
+
+	/* Interface 0, Alternate Setting 0, Audio control interface descriptor */
+	USB_INTERFACE_DESC_SIZE,			/* bLength */
+	USB_INTERFACE_DESCRIPTOR_TYPE,		/* bDescriptorType */
+	USB_AUDIO_CIF_NUM,					/* bInterfaceNumber: Number of Interface */
+	0x00,								/* bAlternateSetting: Alternate setting */
+	0x00,								/* bNumEndpoints: no interrupt endpoint */
+	USB_DEVICE_CLASS_AUDIO,				/* bInterfaceClass: Audio */
+	UAC_SUBCLASS_AUDIOCONTROL,			/* bInterfaceSubClass: Audio control */
+	0x00,								/* bInterfaceProtocol: no protocol used */
+	0x04,								/* iInterface: */
+	/* Audio control header */
+	UAC_AC_HEADER_DESC_SIZE,			/* bLength */
+	UAC_CS_INTERFACE,					/* bDescriptorType: CS_INTERFACE */
+	UAC_AC_HEADER,						/* bDescriptorSubtype: Header */
+	WBVAL(0x0100),						/* bcdADC 1.00 */
+	WBVAL(								/* wTotalLength: class specific descriptors */
+		UAC_AC_HEADER_DESC_SIZE         +
+		UAC_INPUT_TERMINAL_DESC_SIZE    +
+		UAC_OUTPUT_TERMINAL_DESC_SIZE
+		),
+	0x01,								/* bInCollection: one streaming interface */
+	USB_AUDIO_SIF_NUM,					/* baInterfaceNr(1) */
+	/* Input terminal, the ADC1 input */
+	UAC_INPUT_TERMINAL_DESC_SIZE,		/* bLength */
+	UAC_CS_INTERFACE,					/* bDescriptorType: CS_INTERFACE */
+	UAC_AC_INPUT_TERMINAL,				/* bDescriptorSubtype: Input terminal */
+	UAC_INPUT_TERMINAL_ID,				/* bTerminalID */
+	WBVAL(UAC_TERMINAL_MICROPHONE),		/* wTerminalType: Microphone */
+	0x00,								/* bAssocTerminal: none */
+	0x01,								/* bNrChannels: mono */
+	WBVAL(0x0000),						/* wChannelConfig: mono, no spatial position */
+	0x00,								/* iChannelNames */
+	0x00,								/* iTerminal */
+	/* Output terminal, to the host */
+	UAC_OUTPUT_TERMINAL_DESC_SIZE,		/* bLength */
+	UAC_CS_INTERFACE,					/* bDescriptorType: CS_INTERFACE */
+	UAC_AC_OUTPUT_TERMINAL,				/* bDescriptorSubtype: Output terminal */
+	UAC_OUTPUT_TERMINAL_ID,				/* bTerminalID */
+	WBVAL(UAC_TERMINAL_USB_STREAMING),	/* wTerminalType: USB streaming */
+	0x00,								/* bAssocTerminal: none */
+	UAC_INPUT_TERMINAL_ID,				/* bSourceID */
+	0x00,								/* iTerminal */
+
+	/* Interface 1, Alternate Setting 0, Audio streaming interface, no bandwidth */
+	USB_INTERFACE_DESC_SIZE,			/* bLength */
+	USB_INTERFACE_DESCRIPTOR_TYPE,		/* bDescriptorType */
+	USB_AUDIO_SIF_NUM,					/* bInterfaceNumber: Number of Interface */
+	0x00,								/* bAlternateSetting: Alternate setting */
+	0x00,								/* bNumEndpoints: no endpoint */
+	USB_DEVICE_CLASS_AUDIO,				/* bInterfaceClass: Audio */
+	UAC_SUBCLASS_AUDIOSTREAMING,		/* bInterfaceSubClass: Audio streaming */
+	0x00,								/* bInterfaceProtocol: no protocol used */
+	0x04,								/* iInterface: */
+
+	/* Interface 1, Alternate Setting 1, Audio streaming interface, streaming */
+	USB_INTERFACE_DESC_SIZE,			/* bLength */
+	USB_INTERFACE_DESCRIPTOR_TYPE,		/* bDescriptorType */
+	USB_AUDIO_SIF_NUM,					/* bInterfaceNumber: Number of Interface */
+	0x01,								/* bAlternateSetting: Alternate setting */
+	0x01,								/* bNumEndpoints: One endpoint used */
+	USB_DEVICE_CLASS_AUDIO,				/* bInterfaceClass: Audio */
+	UAC_SUBCLASS_AUDIOSTREAMING,		/* bInterfaceSubClass: Audio streaming */
+	0x00,								/* bInterfaceProtocol: no protocol used */
+	0x04,								/* iInterface: */
+	/* Audio streaming general */
+	UAC_AS_GENERAL_DESC_SIZE,			/* bLength */
+	UAC_CS_INTERFACE,					/* bDescriptorType: CS_INTERFACE */
+	UAC_AS_GENERAL,						/* bDescriptorSubtype: General */
+	UAC_OUTPUT_TERMINAL_ID,				/* bTerminalLink */
+	0x01,								/* bDelay: frames */
+	WBVAL(UAC_FORMAT_PCM),				/* wFormatTag: PCM */
+	/* Type I format */
+	UAC_FORMAT_I_DESC_SIZE,				/* bLength */
+	UAC_CS_INTERFACE,					/* bDescriptorType: CS_INTERFACE */
+	UAC_AS_FORMAT_TYPE,					/* bDescriptorSubtype: Format type */
+	UAC_FORMAT_TYPE_I,					/* bFormatType: Type I */
+	0x01,								/* bNrChannels: mono */
+	0x02,								/* bSubFrameSize: 2 bytes */
+	16,									/* bBitResolution: 12-bit samples in the upper bits */
+	0x01,								/* bSamFreqType: one discrete rate */
+	B3VAL(USB_AUDIO_RATE_HZ),			/* tSamFreq */
+	/* Endpoint, EP Isochronous In. Synchronous: the sample clock is locked
+	   to the start of frames. */
+	UAC_ENDPOINT_DESC_SIZE,				/* bLength */
+	USB_ENDPOINT_DESCRIPTOR_TYPE,		/* bDescriptorType */
+	USB_AUDIO_IN_EP,					/* bEndpointAddress */
+	USB_ENDPOINT_TYPE_ISOCHRONOUS | USB_ENDPOINT_SYNC_SYNCHRONOUS | USB_ENDPOINT_USAGE_DATA,	/* bmAttributes */
+	WBVAL(USB_AUDIO_PACKET_MAX),		/* wMaxPacketSize */
+	0x01,			/* 1ms */           /* bInterval */
+	0x00,								/* bRefresh */
+	0x00,								/* bSynchAddress: no sync endpoint */
+	/* Audio streaming endpoint */
+	UAC_CS_ENDPOINT_DESC_SIZE,			/* bLength */
+	UAC_CS_ENDPOINT,					/* bDescriptorType: CS_ENDPOINT */
+	UAC_EP_GENERAL,						/* bDescriptorSubtype: General */
+	0x00,								/* bmAttributes: no sampling frequency control */
+	0x00,								/* bLockDelayUnits */
+	WBVAL(0x0000),						/* wLockDelay */
+	/* Terminator */
+	0									/* bLength */
+};
+
+/**
+ * USB String Descriptor (optional)
+ */
+ALIGNED(4) const uint8_t USB_StringDescriptor[] = {
+	/* Index 0x00: LANGID Codes */
+	0x04,								/* bLength */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	WBVAL(0x0409),	/* US English */    /* wLANGID */
+	/* Index 0x01: Manufacturer */
+	(3 * 2 + 2),						/* bLength (3 Char + Type + lenght) */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'N', 0,
+	'X', 0,
+	'P', 0,
+	/* Index 0x02: Product */
+	(9 * 2 + 2),						/* bLength */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'A', 0,
+	'D', 0,
+	'C', 0,
+	' ', 0,
+	'A', 0,
+	'u', 0,
+	'd', 0,
+	'i', 0,
+	'o', 0,
+	/* Index 0x03: Serial Number */
+	(6 * 2 + 2),						/* bLength (6 Char + Type + lenght) */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'N', 0,
+	'X', 0,
+	'P', 0,
+	'-', 0,
+	'7', 0,
+	'7', 0,
+	/* Index 0x04: Interfaces */
+	( 4 * 2 + 2),						/* bLength (4 Char + Type + lenght) */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'A', 0,
+	'D', 0,
+	'C', 0,
+	'1', 0,
+};
+
+#endif /* defined(APP_USB_AUDIO) */
@@ -31,6 +31,8 @@
 
 #include "app_usbd_cfg.h"
 
+#if defined(APP_USB_VCOM)
+
 /*****************************************************************************
  * Private types/enumerations/variables
  ****************************************************************************/
@@ -204,3 +206,5 @@ ALIGNED(4) const uint8_t USB_StringDescriptor[] = {
 	'O', 0,
 	'M', 0,
 };
+
+#endif /* defined(APP_USB_VCOM) */
@@ -33,10 +33,42 @@
 #include "board.h"
 #include "cdc_vcom.h"
 
+#if defined(APP_USB_VCOM)
+
 /*****************************************************************************
  * Private types/enumerations/variables
  ****************************************************************************/
 
+/* Data queued for the bulk IN endpoint. vcom_write() is the only writer
+   of tx_head and the USB interrupt the only writer of tx_tail, so neither
+   side needs a lock. Bytes on the endpoint stay in the ring until their
+   USB_EVT_IN. Chunks are sent in place, so the ring starts on an
+   endpoint buffer boundary. */
+ALIGNED(VCOM_BUF_ALIGN) static uint8_t txRing[VCOM_TX_RING_SZ];
+
+/* Blocks sent in place, same ownership as the ring with blk_head and
+   blk_tail. mark is tx_head when the block was queued: ring bytes before
+   it go first, the ones after wait for the block. */
+typedef struct {
+	uint8_t *pData;
+	uint32_t len;
+	uint32_t mark;
+	VCOM_TX_DONE_T done;
+} VCOM_TX_BLOCK_T;
+
+static VCOM_TX_BLOCK_T txBlocks[VCOM_TX_BLOCKS];
+
+/* Filled RX buffers, oldest at rx_tail. The USB interrupt fills the
+   buffer at rx_head and publishes it by moving rx_head; the reader hands
+   it back by moving rx_tail. Buffers are used in turn, so the descriptor
+   index is also the buffer index. */
+typedef struct {
+	uint8_t *pData;
+	uint32_t len;
+} VCOM_RX_DESC_T;
+
+static VCOM_RX_DESC_T rxDesc[VCOM_RX_BUFS];
+
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -50,44 +82,257 @@ VCOM_DATA_T g_vCOM;
  * Private functions
  ****************************************************************************/
 
+/* Take a buffer from the stack memory on an endpoint buffer boundary */
+static uint8_t *VCOM_alloc(USBD_CDC_INIT_PARAM_T *pParam, uint32_t size)
+{
+	uint32_t pad = (VCOM_BUF_ALIGN - (pParam->mem_base & (VCOM_BUF_ALIGN - 1))) & (VCOM_BUF_ALIGN - 1);
+	uint8_t *p = (uint8_t *) (pParam->mem_base + pad);
+
+	pParam->mem_base += pad + size;
+	pParam->mem_size -= pad + size;
+	return p;
+}
+
+/* Queue the next chunk of the TX ring or of the oldest block, USB interrupt only */
+static void VCOM_tx_next(VCOM_DATA_T *pVcom)
+{
+	uint32_t tail = pVcom->tx_tail;
+	uint32_t len = pVcom->tx_head - tail;
+	uint32_t pos = tail & (VCOM_TX_RING_SZ - 1);
+	uint8_t *pData = &txRing[pos];
+	VCOM_TX_BLOCK_T *pBlk;
+
+	if ((pVcom->tx_flags & VCOM_TX_CONNECTED) == 0) {
+		pVcom->tx_flags &= ~VCOM_TX_BUSY;
+		return;
+	}
+
+	pVcom->tx_from_blk = 0;
+	if (pVcom->blk_tail != pVcom->blk_head) {
+		pBlk = &txBlocks[pVcom->blk_tail & (VCOM_TX_BLOCKS - 1)];
+		if (tail == pBlk->mark) {
+			/* Ring caught up with the block, send it from where it is */
+			pData = &pBlk->pData[pVcom->blk_sent];
+			len = pBlk->len - pVcom->blk_sent;
+			pVcom->tx_from_blk = 1;
+		}
+		else {
+			/* Ring bytes queued before the block */
+			len = pBlk->mark - tail;
+		}
+	}
+
+	if (len == 0) {
+		if (pVcom->tx_zlp) {
+			/* Data stops on a packet boundary, a zero-length packet ends the
+			   host's read without waiting for more */
+			pVcom->tx_zlp = 0;
+			pVcom->tx_zlps++;
+			pVcom->tx_flags |= VCOM_TX_BUSY;
+			pVcom->tx_len = 0;
+			USBD_API->hw->WriteEP(pVcom->hUsb, USB_CDC_IN_EP, txRing, 0);
+			return;
+		}
+		pVcom->tx_flags &= ~VCOM_TX_BUSY;
+		return;
+	}
+	if (!pVcom->tx_from_blk && (len > (VCOM_TX_RING_SZ - pos))) {
+		len = VCOM_TX_RING_SZ - pos;
+	}
+	if (len > VCOM_TX_XFER_MAX) {
+		len = VCOM_TX_XFER_MAX;
+	}
+	if (!pVcom->tx_from_blk && ((pos & (VCOM_BUF_ALIGN - 1)) != 0)) {
+		/* The endpoint only takes a buffer on a boundary. Bytes up to the
+		   next one go out of the staging buffer, the ring is sent in place
+		   again from there. Blocks start on a boundary and advance by whole
+		   transfers. */
+		if (len > (VCOM_BUF_ALIGN - (pos & (VCOM_BUF_ALIGN - 1)))) {
+			len = VCOM_BUF_ALIGN - (pos & (VCOM_BUF_ALIGN - 1));
+		}
+		memcpy(pVcom->tx_stage, pData, len);
+		pData = pVcom->tx_stage;
+	}
+
+	/* The endpoint splits the transfer into packets and raises one
+	   USB_EVT_IN at its end; a short last packet ends it for the host */
+	pVcom->tx_zlp = (len % USB_FS_MAX_BULK_PACKET) == 0;
+	pVcom->tx_flags |= VCOM_TX_BUSY;
+	pVcom->tx_len = len;
+	USBD_API->hw->WriteEP(pVcom->hUsb, USB_CDC_IN_EP, pData, len);
+}
+
+/* Fill in the CDC notification header */
+static void VCOM_ntf_header(uint8_t *p, uint8_t code, uint16_t len)
+{
+	p[0] = 0xA1;				/* device to host, class, interface */
+	p[1] = code;
+	p[2] = 0;
+	p[3] = 0;
+	p[4] = USB_CDC_CIF_NUM;
+	p[5] = 0;
+	p[6] = (uint8_t) len;
+	p[7] = (uint8_t) (len >> 8);
+}
+
+/* Send the pending notification on the interrupt endpoint, USB interrupt
+   only. One is in flight at a time and the host polls every 2 ms, which
+   bounds the rate. */
+static void VCOM_notify(VCOM_DATA_T *pVcom)
+{
+	uint8_t *p = pVcom->ntf_buff;
+	uint32_t drops = pVcom->tx_drops;
+	uint32_t used, blocks, level, blkLevel, state;
+
+	if (((pVcom->tx_flags & VCOM_TX_CONNECTED) == 0) || pVcom->ntf_busy) {
+		return;
+	}
+
+	/* Serial state first: the carriers once the port is open, the
+	   overrun after drops. Overrun is an event, the next one clears it. */
+	if (!pVcom->ntf_opened || (drops != pVcom->ntf_ss_drops)) {
+		state = VCOM_SERIAL_STATE_DCD | VCOM_SERIAL_STATE_DSR;
+		if (drops != pVcom->ntf_ss_drops) {
+			state |= VCOM_SERIAL_STATE_OVERRUN;
+		}
+		pVcom->ntf_opened = 1;
+		pVcom->ntf_ss_drops = drops;
+		VCOM_ntf_header(p, CDC_NOTIFICATION_SERIAL_STATE, 2);
+		p[8] = (uint8_t) state;
+		p[9] = 0;
+		pVcom->ntf_busy = 1;
+		pVcom->ntf_sent++;
+		USBD_API->hw->WriteEP(pVcom->hUsb, USB_CDC_INT_EP, p, VCOM_NOTIFY_SS_BYTES);
+		return;
+	}
+
+	used = pVcom->tx_head - pVcom->tx_tail;
+	blocks = pVcom->blk_head - pVcom->blk_tail;
+	level = (used * 100) / VCOM_TX_RING_SZ;
+	blkLevel = (blocks * 100) / VCOM_TX_BLOCKS;
+	if (blkLevel > level) {
+		level = blkLevel;
+	}
+	if ((drops == pVcom->ntf_tx_drops) && ((level / VCOM_NOTIFY_STEP_PCT) == pVcom->ntf_step)) {
+		return;
+	}
+	pVcom->ntf_tx_drops = drops;
+	pVcom->ntf_step = (uint8_t) (level / VCOM_NOTIFY_STEP_PCT);
+
+	VCOM_ntf_header(p, VCOM_NOTIFY_TX_STATE, VCOM_NOTIFY_TX_BYTES - 8);
+	p[8] = (uint8_t) used;
+	p[9] = (uint8_t) (used >> 8);
+	p[10] = (uint8_t) level;
+	p[11] = (uint8_t) blocks;
+	p[12] = (uint8_t) drops;
+	p[13] = (uint8_t) (drops >> 8);
+	p[14] = (uint8_t) (drops >> 16);
+	p[15] = (uint8_t) (drops >> 24);
+	pVcom->ntf_busy = 1;
+	pVcom->ntf_sent++;
+	USBD_API->hw->WriteEP(pVcom->hUsb, USB_CDC_INT_EP, p, VCOM_NOTIFY_TX_BYTES);
+}
+
+/* Drop the ring data and blocks queued before the flush marks, USB
+   interrupt only. None of them may be on the endpoint. */
+static void VCOM_tx_flush(VCOM_DATA_T *pVcom)
+{
+	VCOM_TX_BLOCK_T *pBlk;
+
+	while (pVcom->blk_tail != pVcom->blk_flush) {
+		pBlk = &txBlocks[pVcom->blk_tail & (VCOM_TX_BLOCKS - 1)];
+		pBlk->done(pBlk->pData);
+		pVcom->blk_tail++;
+	}
+	pVcom->blk_sent = 0;
+	pVcom->tx_tail = pVcom->tx_flush;
+	pVcom->tx_flags &= ~VCOM_TX_FLUSH;
+}
+
 /* VCOM bulk EP_IN endpoint handler */
 static ErrorCode_t VCOM_bulk_in_hdlr(USBD_HANDLE_T hUsb, void *data, uint32_t event)
 {
 	VCOM_DATA_T *pVcom = (VCOM_DATA_T *) data;
 
+	VCOM_TX_BLOCK_T *pBlk;
+
 	if (event == USB_EVT_IN) {
-		pVcom->tx_flags &= ~VCOM_TX_BUSY;
+		/* The chunk is out, free it and send the next one */
+		pVcom->tx_xfers++;
+		pVcom->tx_bytes += pVcom->tx_len;
+		if (pVcom->tx_from_blk) {
+			pBlk = &txBlocks[pVcom->blk_tail & (VCOM_TX_BLOCKS - 1)];
+			pVcom->blk_sent += pVcom->tx_len;
+			if (pVcom->blk_sent == pBlk->len) {
+				pBlk->done(pBlk->pData);
+				pVcom->blk_sent = 0;
+				pVcom->blk_tail++;
+			}
+		}
+		else {
+			pVcom->tx_tail += pVcom->tx_len;
+		}
+		pVcom->tx_len = 0;
+		if (pVcom->tx_flags & VCOM_TX_FLUSH) {
+			/* The port was re-opened during the transfer, a block cut
+			   short goes back to its owner with the other stale ones */
+			VCOM_tx_flush(pVcom);
+		}
+		VCOM_tx_next(pVcom);
+	}
+	return LPC_OK;
+}
+
+/* VCOM interrupt EP_IN endpoint handler */
+static ErrorCode_t VCOM_int_in_hdlr(USBD_HANDLE_T hUsb, void *data, uint32_t event)
+{
+	VCOM_DATA_T *pVcom = (VCOM_DATA_T *) data;
+
+	if (event == USB_EVT_IN) {
+		pVcom->ntf_busy = 0;
+		VCOM_notify(pVcom);
 	}
 	return LPC_OK;
 }
 
+/* Queue the next free RX buffer on the OUT endpoint, USB interrupt only */
+static void VCOM_rx_queue(VCOM_DATA_T *pVcom)
+{
+	uint32_t head = pVcom->rx_head;
+
+	if (((pVcom->rx_flags & VCOM_RX_BUF_QUEUED) == 0) && ((head - pVcom->rx_tail) < VCOM_RX_BUFS)) {
+		USBD_API->hw->ReadReqEP(pVcom->hUsb, USB_CDC_OUT_EP, rxDesc[head & (VCOM_RX_BUFS - 1)].pData,
+								VCOM_RX_BUF_SZ);
+		pVcom->rx_flags |= VCOM_RX_BUF_QUEUED;
+	}
+}
+
 /* VCOM bulk EP_OUT endpoint handler */
 static ErrorCode_t VCOM_bulk_out_hdlr(USBD_HANDLE_T hUsb, void *data, uint32_t event)
 {
 	VCOM_DATA_T *pVcom = (VCOM_DATA_T *) data;
+	VCOM_RX_DESC_T *pDesc;
 
 	switch (event) {
 	case USB_EVT_OUT:
-		pVcom->rx_count = USBD_API->hw->ReadEP(hUsb, USB_CDC_OUT_EP, pVcom->rx_buff);
 		if (pVcom->rx_flags & VCOM_RX_BUF_QUEUED) {
 			pVcom->rx_flags &= ~VCOM_RX_BUF_QUEUED;
-			if (pVcom->rx_count != 0) {
-				pVcom->rx_flags |= VCOM_RX_BUF_FULL;
+			pDesc = &rxDesc[pVcom->rx_head & (VCOM_RX_BUFS - 1)];
+			pDesc->len = USBD_API->hw->ReadEP(hUsb, USB_CDC_OUT_EP, pDesc->pData);
+			if (pDesc->len != 0) {
+				/* Length before index, the reader may look as soon as rx_head moves */
+				__DMB();
+				pVcom->rx_head++;
 			}
-
-		}
-		else if (pVcom->rx_flags & VCOM_RX_DB_QUEUED) {
-			pVcom->rx_flags &= ~VCOM_RX_DB_QUEUED;
-			pVcom->rx_flags |= VCOM_RX_DONE;
 		}
+		/* Keep a buffer on the endpoint while the pool has one, so the host is
+		   only NAKed once every buffer is waiting for the reader */
+		VCOM_rx_queue(pVcom);
 		break;
 
 	case USB_EVT_OUT_NAK:
-		/* queue free buffer for RX */
-		if ((pVcom->rx_flags & (VCOM_RX_BUF_FULL | VCOM_RX_BUF_QUEUED)) == 0) {
-			USBD_API->hw->ReadReqEP(hUsb, USB_CDC_OUT_EP, pVcom->rx_buff, VCOM_RX_BUF_SZ);
-			pVcom->rx_flags |= VCOM_RX_BUF_QUEUED;
-		}
+		/* queue free buffer for RX, one may have been handed back since */
+		VCOM_rx_queue(pVcom);
 		break;
 
 	default:
@@ -103,7 +348,25 @@ static ErrorCode_t VCOM_SetLineCode(USBD_HANDLE_T hCDC, CDC_LINE_CODING *line_co
 	VCOM_DATA_T *pVcom = &g_vCOM;
 
 	/* Called when baud rate is changed/set. Using it to know host connection state */
-	pVcom->tx_flags = VCOM_TX_CONNECTED;	/* reset other flags */
+	pVcom->tx_flags |= VCOM_TX_CONNECTED;
+
+	/* Data queued before the port was opened is stale. A ring chunk or
+	   block on the endpoint stays until its USB_EVT_IN, which then drops
+	   the rest; BUSY, tx_from_blk and tx_len are left for that event. */
+	pVcom->tx_flush = pVcom->tx_head;
+	pVcom->blk_flush = pVcom->blk_head;
+	if (pVcom->tx_flags & VCOM_TX_BUSY) {
+		pVcom->tx_flags |= VCOM_TX_FLUSH;
+	}
+	else {
+		VCOM_tx_flush(pVcom);
+		pVcom->tx_zlp = 0;
+	}
+
+	/* Report the carriers to the newly opened port. A notification still
+	   on the interrupt endpoint stays there, the carriers follow on its
+	   USB_EVT_IN; only a bus reset frees the endpoint without one. */
+	pVcom->ntf_opened = 0;
 
 	return LPC_OK;
 }
@@ -131,9 +394,12 @@ ErrorCode_t vcom_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT
 
 	if (ret == LPC_OK) {
 		/* allocate transfer buffers */
-		g_vCOM.rx_buff = (uint8_t *) cdc_param.mem_base;
-		cdc_param.mem_base += VCOM_RX_BUF_SZ;
-		cdc_param.mem_size -= VCOM_RX_BUF_SZ;
+		g_vCOM.rx_buff = VCOM_alloc(&cdc_param, VCOM_RX_BUF_SZ * VCOM_RX_BUFS);
+		for (ep_indx = 0; ep_indx < VCOM_RX_BUFS; ep_indx++) {
+			rxDesc[ep_indx].pData = &g_vCOM.rx_buff[ep_indx * VCOM_RX_BUF_SZ];
+		}
+		g_vCOM.ntf_buff = VCOM_alloc(&cdc_param, VCOM_NOTIFY_BUF_SZ);
+		g_vCOM.tx_stage = VCOM_alloc(&cdc_param, VCOM_BUF_ALIGN);
 
 		/* register endpoint interrupt handler */
 		ep_indx = (((USB_CDC_IN_EP & 0x0F) << 1) + 1);
@@ -144,6 +410,11 @@ ErrorCode_t vcom_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT
 			ret = USBD_API->core->RegisterEpHandler(hUsb, ep_indx, VCOM_bulk_out_hdlr, &g_vCOM);
 
 		}
+		if (ret == LPC_OK) {
+			/* notifications, in place of the stack's handler */
+			ep_indx = (((USB_CDC_INT_EP & 0x0F) << 1) + 1);
+			ret = USBD_API->core->RegisterEpHandler(hUsb, ep_indx, VCOM_int_in_hdlr, &g_vCOM);
+		}
 		/* update mem_base and size variables for cascading calls. */
 		pUsbParam->mem_base = cdc_param.mem_base;
 		pUsbParam->mem_size = cdc_param.mem_size;
@@ -155,76 +426,157 @@ ErrorCode_t vcom_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT
 /* Virtual com port buffered read routine */
 uint32_t vcom_bread(uint8_t *pBuf, uint32_t buf_len)
 {
-	VCOM_DATA_T *pVcom = &g_vCOM;
-	uint16_t cnt = 0;
-	/* read from the default buffer if any data present */
-	if (pVcom->rx_count) {
-		cnt = (pVcom->rx_count < buf_len) ? pVcom->rx_count : buf_len;
-		memcpy(pBuf, pVcom->rx_buff, cnt);
-		pVcom->rx_rd_count += cnt;
-
-		/* enter critical section */
-		NVIC_DisableIRQ(USB0_IRQn);
-		if (pVcom->rx_rd_count >= pVcom->rx_count) {
-			pVcom->rx_flags &= ~VCOM_RX_BUF_FULL;
-			pVcom->rx_rd_count = pVcom->rx_count = 0;
+	uint8_t *pData;
+	uint32_t cnt = 0, n;
+
+	while ((cnt < buf_len) && ((n = vcom_rx_peek(&pData)) != 0)) {
+		if (n > (buf_len - cnt)) {
+			n = buf_len - cnt;
 		}
-		/* exit critical section */
-		NVIC_EnableIRQ(USB0_IRQn);
+		memcpy(&pBuf[cnt], pData, n);
+		vcom_rx_consume(n);
+		cnt += n;
 	}
 	return cnt;
-
 }
 
-/* Virtual com port read routine */
-ErrorCode_t vcom_read_req(uint8_t *pBuf, uint32_t len)
+/* Look at the oldest received data in place */
+uint32_t vcom_rx_peek(uint8_t **ppData)
 {
 	VCOM_DATA_T *pVcom = &g_vCOM;
+	VCOM_RX_DESC_T *pDesc;
 
-	/* check if we queued Rx buffer */
-	if (pVcom->rx_flags & (VCOM_RX_BUF_QUEUED | VCOM_RX_DB_QUEUED)) {
-		return ERR_BUSY;
+	if (pVcom->rx_tail == pVcom->rx_head) {
+		return 0;
 	}
-	/* enter critical section */
-	NVIC_DisableIRQ(USB0_IRQn);
-	/* if not queue the request and return 0 bytes */
-	USBD_API->hw->ReadReqEP(pVcom->hUsb, USB_CDC_OUT_EP, pBuf, len);
-	/* exit critical section */
-	NVIC_EnableIRQ(USB0_IRQn);
-	pVcom->rx_flags |= VCOM_RX_DB_QUEUED;
+	pDesc = &rxDesc[pVcom->rx_tail & (VCOM_RX_BUFS - 1)];
+	*ppData = &pDesc->pData[pVcom->rx_rd_count];
+	return pDesc->len - pVcom->rx_rd_count;
+}
 
-	return LPC_OK;
+/* Consume bytes returned by vcom_rx_peek() */
+void vcom_rx_consume(uint32_t len)
+{
+	VCOM_DATA_T *pVcom = &g_vCOM;
+
+	if (pVcom->rx_tail == pVcom->rx_head) {
+		return;
+	}
+	pVcom->rx_rd_count += len;
+	if (pVcom->rx_rd_count >= rxDesc[pVcom->rx_tail & (VCOM_RX_BUFS - 1)].len) {
+		/* Buffer done, the interrupt queues it again on the next OUT NAK */
+		pVcom->rx_rd_count = 0;
+		pVcom->rx_tail++;
+	}
 }
 
-/* Gets current read count. */
-uint32_t vcom_read_cnt(void)
+/* Virtual com port write routine*/
+uint32_t vcom_write(const uint8_t *pBuf, uint32_t len)
 {
 	VCOM_DATA_T *pVcom = &g_vCOM;
-	uint32_t ret = 0;
+	uint32_t head = pVcom->tx_head;
+	uint32_t pos, first, room;
 
-	if (pVcom->rx_flags & VCOM_RX_DONE) {
-		ret = pVcom->rx_count;
-		pVcom->rx_count = 0;
+	if ((pVcom->tx_flags & VCOM_TX_CONNECTED) == 0) {
+		return 0;
 	}
 
-	return ret;
+	room = VCOM_TX_RING_SZ - (head - pVcom->tx_tail);
+	if (len > room) {
+		len = room;
+		pVcom->tx_drops++;
+	}
+	pos = head & (VCOM_TX_RING_SZ - 1);
+	first = VCOM_TX_RING_SZ - pos;
+	if (first > len) {
+		first = len;
+	}
+	memcpy(&txRing[pos], pBuf, first);
+	memcpy(txRing, &pBuf[first], len - first);
+
+	/* Data before index, the interrupt may read it as soon as tx_head moves */
+	__DMB();
+	pVcom->tx_head = head + len;
+
+	/* An idle endpoint has no USB_EVT_IN coming, have the interrupt start it.
+	   A transfer in flight picks the new data up on its USB_EVT_IN. */
+	if ((pVcom->tx_flags & VCOM_TX_BUSY) == 0) {
+		NVIC_SetPendingIRQ(USB0_IRQn);
+	}
+
+	return len;
 }
 
-/* Virtual com port write routine*/
-uint32_t vcom_write(uint8_t *pBuf, uint32_t len)
+/* Queue a block to be sent in place */
+ErrorCode_t vcom_write_block(uint8_t *pBlock, uint32_t len, VCOM_TX_DONE_T done)
 {
 	VCOM_DATA_T *pVcom = &g_vCOM;
-	uint32_t ret = 0;
+	uint32_t head = pVcom->blk_head;
+	VCOM_TX_BLOCK_T *pBlk = &txBlocks[head & (VCOM_TX_BLOCKS - 1)];
 
-	if ( (pVcom->tx_flags & VCOM_TX_CONNECTED) && ((pVcom->tx_flags & VCOM_TX_BUSY) == 0) ) {
-		pVcom->tx_flags |= VCOM_TX_BUSY;
+	if (((uint32_t) pBlock & (VCOM_BUF_ALIGN - 1)) != 0) {
+		/* Sent in place, the endpoint would take it from the boundary below */
+		return ERR_FAILED;
+	}
+	if (((pVcom->tx_flags & VCOM_TX_CONNECTED) == 0) || (len == 0) ||
+		((head - pVcom->blk_tail) >= VCOM_TX_BLOCKS)) {
+		return ERR_BUSY;
+	}
 
-		/* enter critical section */
-		NVIC_DisableIRQ(USB0_IRQn);
-		ret = USBD_API->hw->WriteEP(pVcom->hUsb, USB_CDC_IN_EP, pBuf, len);
-		/* exit critical section */
-		NVIC_EnableIRQ(USB0_IRQn);
+	pBlk->pData = pBlock;
+	pBlk->len = len;
+	pBlk->mark = pVcom->tx_head;
+	pBlk->done = done;
+
+	/* Descriptor before index, as in vcom_write() */
+	__DMB();
+	pVcom->blk_head = head + 1;
+
+	if ((pVcom->tx_flags & VCOM_TX_BUSY) == 0) {
+		NVIC_SetPendingIRQ(USB0_IRQn);
 	}
 
-	return ret;
+	return LPC_OK;
 }
+
+/* Bus reset: the stack drops every transfer without an event */
+ErrorCode_t vcom_reset_event(USBD_HANDLE_T hUsb)
+{
+	VCOM_DATA_T *pVcom = &g_vCOM;
+
+	(void) hUsb;
+
+	/* Closed until the host sets the line coding again, nothing is on
+	   the endpoints any more */
+	pVcom->tx_flags = 0;
+	pVcom->tx_len = 0;
+	pVcom->tx_from_blk = 0;
+	pVcom->tx_zlp = 0;
+	pVcom->tx_flush = pVcom->tx_head;
+	pVcom->blk_flush = pVcom->blk_head;
+	VCOM_tx_flush(pVcom);
+	pVcom->rx_flags &= ~VCOM_RX_BUF_QUEUED;
+	pVcom->ntf_busy = 0;
+	pVcom->ntf_opened = 0;
+
+	return LPC_OK;
+}
+
+/* Report data the producer dropped for lack of TX room */
+void vcom_tx_drop(void)
+{
+	g_vCOM.tx_drops++;
+}
+
+/* Start sending the TX ring if the IN endpoint is idle */
+void vcom_tx_irq(void)
+{
+	VCOM_DATA_T *pVcom = &g_vCOM;
+
+	if ((pVcom->tx_flags & VCOM_TX_BUSY) == 0) {
+		VCOM_tx_next(pVcom);
+	}
+	VCOM_notify(pVcom);
+}
+
+#endif /* defined(APP_USB_VCOM) */
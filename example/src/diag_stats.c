@@ -0,0 +1,123 @@
+/*
+ * @brief Data loss counters of the acquisition pipeline
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "board.h"
+#include "diag_stats.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Channel overrun flags, ADC_FLAGS_OVRRUN_MASK(0..11) */
+#define DIAG_CHAN_OVR_MASK  (0xFFF << 12)
+
+/* Overrun interrupt masked until the sequence overrun clears, per ADC */
+static volatile bool ovrMasked[2];
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+DIAG_STATS_T g_diag;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static LPC_ADC_T *adcBase(uint32_t num)
+{
+	return (num == 0) ? LPC_ADC0 : LPC_ADC1;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Clear all counters and high-water marks */
+void Diag_Reset(void)
+{
+	memset(&g_diag, 0, sizeof(g_diag));
+}
+
+/* Count the overruns of an ADC from its overrun interrupt */
+void Diag_EnableAdcOverrun(LPC_ADC_T *pADC)
+{
+	Chip_ADC_EnableInt(pADC, ADC_INTEN_OVRRUN_ENABLE);
+	NVIC_EnableIRQ((pADC == LPC_ADC0) ? ADC0_OVR_IRQn : ADC1_OVR_IRQn);
+}
+
+/* Count and clear the pending overruns of an ADC */
+void Diag_AdcOverrunHandler(LPC_ADC_T *pADC)
+{
+	uint32_t num = (pADC == LPC_ADC0) ? 0 : 1;
+	uint32_t flags = Chip_ADC_GetFlags(pADC);
+	uint32_t chans = (flags & DIAG_CHAN_OVR_MASK) >> 12;
+	uint32_t ch;
+
+	/* Reading a channel data register clears its overrun flag */
+	while (chans) {
+		ch = 31 - __CLZ(chans);
+		chans &= ~(1 << ch);
+		g_diag.adcChanOvr[num][ch]++;
+		Chip_ADC_GetDataReg(pADC, ch);
+	}
+
+	if (flags & (ADC_FLAGS_SEQA_OVRRUN_MASK | ADC_FLAGS_SEQB_OVRRUN_MASK)) {
+		if (flags & ADC_FLAGS_SEQA_OVRRUN_MASK) {
+			g_diag.adcSeqOvr[num][ADC_SEQA_IDX]++;
+		}
+		if (flags & ADC_FLAGS_SEQB_OVRRUN_MASK) {
+			g_diag.adcSeqOvr[num][ADC_SEQB_IDX]++;
+		}
+		Chip_ADC_DisableInt(pADC, ADC_INTEN_OVRRUN_ENABLE);
+		ovrMasked[num] = true;
+	}
+}
+
+/* Re-arm overrun interrupts masked by Diag_AdcOverrunHandler() */
+void Diag_Poll(void)
+{
+	uint32_t num;
+	LPC_ADC_T *pADC;
+
+	for (num = 0; num < 2; num++) {
+		if (!ovrMasked[num]) {
+			continue;
+		}
+
+		pADC = adcBase(num);
+		if ((Chip_ADC_GetFlags(pADC) & (ADC_FLAGS_SEQA_OVRRUN_MASK | ADC_FLAGS_SEQB_OVRRUN_MASK)) == 0) {
+			ovrMasked[num] = false;
+			Chip_ADC_EnableInt(pADC, ADC_INTEN_OVRRUN_ENABLE);
+		}
+	}
+}
@@ -0,0 +1,331 @@
+/*
+ * @brief Fixed-point FFT of real sample frames
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "dsp_fft.h"
+#include "dsp_filter.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Quarter wave of the twiddle table */
+#define FFT_QUARTER         (DSP_FFT_MAX_SIZE / 4)
+
+/* The table below is written out for a 1024 point maximum */
+#if (DSP_FFT_MAX_SIZE != 1024)
+#error "sinTable must be extended to match DSP_FFT_MAX_SIZE"
+#endif
+
+/* Non-negative constant to Q31, 1.0 saturates */
+#define FFT_Q31_RAW(v)      ((v) * 2147483648.0 + 0.5)
+#define FFT_Q31(v)          ((int32_t) ((FFT_Q31_RAW(v) > 2147483647.0) ? 2147483647.0 : FFT_Q31_RAW(v)))
+
+/* sin(2 pi k / DSP_FFT_MAX_SIZE) in Q31, computed by the compiler. The
+   angle never exceeds pi / 2, no range reduction is needed. */
+#define FFT_SIN(k)          FFT_Q31(DSP_SIN_R(2 * DSP_PI * (k) / DSP_FFT_MAX_SIZE))
+#define FFT_SIN8(k)         FFT_SIN((k) + 0), FFT_SIN((k) + 1), FFT_SIN((k) + 2), FFT_SIN((k) + 3), \
+							FFT_SIN((k) + 4), FFT_SIN((k) + 5), FFT_SIN((k) + 6), FFT_SIN((k) + 7)
+#define FFT_SIN32(k)        FFT_SIN8((k) + 0), FFT_SIN8((k) + 8), FFT_SIN8((k) + 16), FFT_SIN8((k) + 24)
+
+static const int32_t sinTable[FFT_QUARTER + 1] = {
+	FFT_SIN32(0), FFT_SIN32(32), FFT_SIN32(64), FFT_SIN32(96),
+	FFT_SIN32(128), FFT_SIN32(160), FFT_SIN32(192), FFT_SIN32(224),
+	FFT_SIN(256)
+};
+
+/* Window weights a0 - a1 cos(2 pi n / N) + a2 cos(4 pi n / N) in Q15 */
+static const int16_t windowCoef[DSP_FFT_WIN_COUNT][3] = {
+	{32767, 0, 0},				/* Rectangular */
+	{16384, 16384, 0},			/* Hann */
+	{17695, 15073, 0},			/* Hamming 0.54, 0.46 */
+	{13763, 16384, 2621},		/* Blackman 0.42, 0.5, 0.08 */
+};
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* cos and sin of 2 pi t / DSP_FFT_MAX_SIZE in Q31 from the quarter wave */
+static inline void twiddle(uint32_t t, int32_t *pCos, int32_t *pSin)
+{
+	uint32_t r = t & (FFT_QUARTER - 1);
+
+	switch (t / FFT_QUARTER) {
+	case 0:
+		*pCos = sinTable[FFT_QUARTER - r];
+		*pSin = sinTable[r];
+		break;
+
+	case 1:
+		*pCos = -sinTable[r];
+		*pSin = sinTable[FFT_QUARTER - r];
+		break;
+
+	case 2:
+		*pCos = -sinTable[FFT_QUARTER - r];
+		*pSin = -sinTable[r];
+		break;
+
+	default:
+		*pCos = sinTable[r];
+		*pSin = -sinTable[FFT_QUARTER - r];
+		break;
+	}
+}
+
+/* Multiply by the twiddle factor cos - j sin, rounded back from Q31 */
+static inline void rotate(int32_t *pOut, int32_t re, int32_t im, int32_t c, int32_t s)
+{
+	pOut[0] = (int32_t) ((((int64_t) re * c) + ((int64_t) im * s) + (1 << 30)) >> 31);
+	pOut[1] = (int32_t) ((((int64_t) im * c) - ((int64_t) re * s) + (1 << 30)) >> 31);
+}
+
+/* The decimation in frequency stages leave the points in bit reversed order */
+static void bitReverse(int32_t *pData, uint32_t points)
+{
+	uint32_t i, j = 0, bit;
+	int32_t re, im;
+
+	for (i = 0; i < points; i++) {
+		if (i < j) {
+			re = pData[2 * i];
+			im = pData[(2 * i) + 1];
+			pData[2 * i] = pData[2 * j];
+			pData[(2 * i) + 1] = pData[(2 * j) + 1];
+			pData[2 * j] = re;
+			pData[(2 * j) + 1] = im;
+		}
+		bit = points >> 1;
+		while (j & bit) {
+			j ^= bit;
+			bit >>= 1;
+		}
+		j |= bit;
+	}
+}
+
+/* Integer square root, bit by bit */
+static uint32_t isqrt32(uint32_t v)
+{
+	uint32_t root = 0, bit = 1UL << 30;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit) {
+		if (v >= (root + bit)) {
+			v -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+/* |re + j im|, both parts reduced to 15 bits so the squares fit 32 bits */
+static uint32_t magnitude(int32_t re, int32_t im)
+{
+	uint32_t ur = (re < 0) ? -re : re;
+	uint32_t ui = (im < 0) ? -im : im;
+	uint32_t bits, shift = 0;
+
+	if ((ur | ui) >= 0x8000) {
+		bits = 32 - __builtin_clz(ur | ui);
+		shift = bits - 15;
+		ur >>= shift;
+		ui >>= shift;
+	}
+
+	return isqrt32((ur * ur) + (ui * ui)) << shift;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Check an FFT size */
+bool DSP_Fft_IsValidSize(uint32_t size)
+{
+	return (size >= DSP_FFT_MIN_SIZE) && (size <= DSP_FFT_MAX_SIZE) && ((size & (size - 1)) == 0);
+}
+
+/* Fill a window table */
+uint32_t DSP_Fft_Window(int16_t *pWin, uint32_t size, DSP_FFT_WINDOW_T type)
+{
+	const int16_t *pCoef = windowCoef[(type < DSP_FFT_WIN_COUNT) ? type : DSP_FFT_WIN_RECT];
+	uint32_t n, stride = DSP_FFT_MAX_SIZE / size, sum = 0;
+	int32_t c1, c2, s, w;
+
+	for (n = 0; n < size; n++) {
+		twiddle((n * stride) & (DSP_FFT_MAX_SIZE - 1), &c1, &s);
+		twiddle((2 * n * stride) & (DSP_FFT_MAX_SIZE - 1), &c2, &s);
+		w = pCoef[0] - (int32_t) (((int64_t) pCoef[1] * c1) >> 31) + (int32_t) (((int64_t) pCoef[2] * c2) >> 31);
+		if (w > 32767) {
+			w = 32767;
+		}
+		if (w < 0) {
+			w = 0;
+		}
+		pWin[n] = (int16_t) w;
+		sum += w;
+	}
+
+	return sum;
+}
+
+/* In-place complex FFT */
+void DSP_Fft_Complex(int32_t *pData, uint32_t points)
+{
+	uint32_t len, quarter, stride, j, g;
+	int32_t c1, s1, c2, s2, c3, s3;
+	int32_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i;
+	int32_t *p0, *p1, *p2, *p3;
+
+	/* Radix-4 butterflies on groups of len points, each the equivalent of
+	   two radix-2 stages. Writing the 2nd and 3rd outputs swapped keeps
+	   the result in plain bit reversed order. */
+	for (len = points; len >= 4; len >>= 2) {
+		quarter = len >> 2;
+		stride = DSP_FFT_MAX_SIZE / len;
+
+		for (j = 0; j < quarter; j++) {
+			twiddle(j * stride, &c1, &s1);
+			twiddle(2 * j * stride, &c2, &s2);
+			twiddle(3 * j * stride, &c3, &s3);
+
+			for (g = j; g < points; g += len) {
+				p0 = &pData[2 * g];
+				p1 = p0 + (2 * quarter);
+				p2 = p1 + (2 * quarter);
+				p3 = p2 + (2 * quarter);
+
+				t0r = p0[0] + p2[0];
+				t0i = p0[1] + p2[1];
+				t1r = p0[0] - p2[0];
+				t1i = p0[1] - p2[1];
+				t2r = p1[0] + p3[0];
+				t2i = p1[1] + p3[1];
+				/* (b - d) times -j */
+				t3r = p1[1] - p3[1];
+				t3i = p3[0] - p1[0];
+
+				p0[0] = t0r + t2r;
+				p0[1] = t0i + t2i;
+				if (j == 0) {
+					p1[0] = t0r - t2r;
+					p1[1] = t0i - t2i;
+					p2[0] = t1r + t3r;
+					p2[1] = t1i + t3i;
+					p3[0] = t1r - t3r;
+					p3[1] = t1i - t3i;
+				}
+				else {
+					rotate(p1, t0r - t2r, t0i - t2i, c2, s2);
+					rotate(p2, t1r + t3r, t1i + t3i, c1, s1);
+					rotate(p3, t1r - t3r, t1i - t3i, c3, s3);
+				}
+			}
+		}
+	}
+
+	/* Odd number of radix-2 stages, the last one has no twiddles */
+	if (len == 2) {
+		for (g = 0; g < points; g += 2) {
+			p0 = &pData[2 * g];
+			t0r = p0[0];
+			t0i = p0[1];
+			p0[0] = t0r + p0[2];
+			p0[1] = t0i + p0[3];
+			p0[2] = t0r - p0[2];
+			p0[3] = t0i - p0[3];
+		}
+	}
+
+	bitReverse(pData, points);
+}
+
+/* In-place FFT of real samples */
+void DSP_Fft_Real(int32_t *pData, uint32_t size)
+{
+	uint32_t half = size / 2, stride = DSP_FFT_MAX_SIZE / size, k;
+	int32_t *pA, *pB, c, s, er, ei, orr, oi, t[2];
+
+	/* Even samples as the real parts, odd ones as the imaginary parts */
+	DSP_Fft_Complex(pData, half);
+
+	/* DC and Nyquist are both real */
+	er = pData[0];
+	ei = pData[1];
+	pData[0] = er + ei;
+	pData[1] = er - ei;
+
+	/* Split Z into the spectra of the even and odd samples, then
+	   X[k] = E[k] + W^k O[k] and X[N/2 - k] = conj(E[k] - W^k O[k]) */
+	for (k = 1; k <= (half / 2); k++) {
+		pA = &pData[2 * k];
+		pB = &pData[2 * (half - k)];
+
+		er = (pA[0] + pB[0]) >> 1;
+		ei = (pA[1] - pB[1]) >> 1;
+		orr = (pA[1] + pB[1]) >> 1;
+		oi = (pB[0] - pA[0]) >> 1;
+
+		twiddle(k * stride, &c, &s);
+		rotate(t, orr, oi, c, s);
+
+		pA[0] = er + t[0];
+		pA[1] = ei + t[1];
+		pB[0] = er - t[0];
+		pB[1] = t[1] - ei;
+	}
+}
+
+/* Add the bin magnitudes of a real FFT to accumulators */
+void DSP_Fft_AddMagnitude(const int32_t *pBins, uint32_t size, uint32_t scale, uint32_t *pAcc)
+{
+	uint32_t k, m;
+	uint64_t v;
+
+	for (k = 0; k < (size / 2); k++) {
+		/* The imaginary slot of bin 0 holds the Nyquist bin */
+		m = (k == 0) ? magnitude(pBins[0], 0) : magnitude(pBins[2 * k], pBins[(2 * k) + 1]);
+		v = ((uint64_t) m * scale) >> 32;
+		pAcc[k] += (uint32_t) ((v > 0xFFFF) ? 0xFFFF : v);
+	}
+}
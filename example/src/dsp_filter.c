@@ -0,0 +1,212 @@
+/*
+ * @brief Fixed-point FIR/IIR filter kernels for the ADC sample stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "dsp_filter.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define FIR_HIST            (DSP_FIR_TAPS - 1)
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static inline int32_t sat16(int32_t v)
+{
+	if (v > 32767) {
+		return 32767;
+	}
+	if (v < -32768) {
+		return -32768;
+	}
+	return v;
+}
+
+static inline int32_t sat32(int64_t v)
+{
+	if (v > INT32_MAX) {
+		return INT32_MAX;
+	}
+	if (v < INT32_MIN) {
+		return INT32_MIN;
+	}
+	return (int32_t) v;
+}
+
+/* Q31 state to Q15 output with rounding */
+static inline int16_t q31ToQ15(int32_t v)
+{
+	return (int16_t) sat16((int32_t) (((int64_t) v + 0x8000) >> 16));
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize a DC blocker */
+void DSP_DcBlock_Init(DSP_DCBLOCK_T *pDc, int32_t a)
+{
+	pDc->a = a;
+	pDc->x1 = 0;
+	pDc->y1 = 0;
+}
+
+/* Run a DC blocker over a block */
+void DSP_DcBlock_Process(DSP_DCBLOCK_T *pDc, const int16_t *pIn, int16_t *pOut, uint32_t count)
+{
+	int32_t a = pDc->a, x1 = pDc->x1, y1 = pDc->y1;
+	int32_t x0;
+
+	while (count--) {
+		x0 = *pIn++;
+		y1 = sat32(((int64_t) (x0 - x1) << 16) + (((int64_t) a * y1) >> 30));
+		x1 = x0;
+		*pOut++ = q31ToQ15(y1);
+	}
+
+	pDc->x1 = x1;
+	pDc->y1 = y1;
+}
+
+/* Initialize a biquad section */
+void DSP_Biquad_Init(DSP_BIQUAD_T *pBq, const DSP_BIQUAD_COEF_T *pCoef)
+{
+	pBq->pCoef = pCoef;
+	pBq->x1 = pBq->x2 = 0;
+	pBq->y1 = pBq->y2 = 0;
+}
+
+/* Run a biquad section over a block, direct form I */
+void DSP_Biquad_Process(DSP_BIQUAD_T *pBq, const int16_t *pIn, int16_t *pOut, uint32_t count)
+{
+	const DSP_BIQUAD_COEF_T *pC = pBq->pCoef;
+	int32_t b0 = pC->b0, b1 = pC->b1, b2 = pC->b2, a1 = pC->a1, a2 = pC->a2;
+	int32_t x1 = pBq->x1, x2 = pBq->x2, y1 = pBq->y1, y2 = pBq->y2;
+	int32_t x0, y0;
+	int64_t acc;
+
+	while (count--) {
+		x0 = *pIn++;
+
+		/* Q30 x Q15 feed-forward scaled to Q61, Q30 x Q31 feedback is Q61 */
+		acc = ((int64_t) b0 * x0) + ((int64_t) b1 * x1) + ((int64_t) b2 * x2);
+		acc <<= 16;
+		acc -= ((int64_t) a1 * y1) + ((int64_t) a2 * y2);
+		y0 = sat32(acc >> 30);
+
+		x2 = x1;
+		x1 = x0;
+		y2 = y1;
+		y1 = y0;
+		*pOut++ = q31ToQ15(y0);
+	}
+
+	pBq->x1 = x1;
+	pBq->x2 = x2;
+	pBq->y1 = y1;
+	pBq->y2 = y2;
+}
+
+/* Initialize a FIR filter */
+void DSP_Fir_Init(DSP_FIR_T *pFir, const int16_t *pCoef)
+{
+	pFir->pCoef = pCoef;
+	memset(pFir->buf, 0, sizeof(pFir->buf));
+}
+
+/* Run a FIR filter over a block */
+void DSP_Fir_Process(DSP_FIR_T *pFir, const int16_t *pIn, int16_t *pOut, uint32_t count)
+{
+	const int16_t *h = pFir->pCoef;
+	int32_t h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3];
+	int32_t h4 = h[4], h5 = h[5], h6 = h[6], h7 = h[7];
+	const int16_t *x;
+	uint32_t n, i;
+	int32_t acc;
+
+	while (count) {
+		n = (count < DSP_FILTER_MAX_BLOCK) ? count : DSP_FILTER_MAX_BLOCK;
+		memcpy(&pFir->buf[FIR_HIST], pIn, n * sizeof(int16_t));
+
+		/* Symmetric taps: fold mirrored samples first, 8 multiplies for 15 taps */
+		x = pFir->buf;
+		for (i = 0; i < n; i++) {
+			acc = h0 * (x[0] + x[14]);
+			acc += h1 * (x[1] + x[13]);
+			acc += h2 * (x[2] + x[12]);
+			acc += h3 * (x[3] + x[11]);
+			acc += h4 * (x[4] + x[10]);
+			acc += h5 * (x[5] + x[9]);
+			acc += h6 * (x[6] + x[8]);
+			acc += h7 * x[7];
+			x++;
+			pOut[i] = (int16_t) sat16((acc + (1 << 14)) >> 15);
+		}
+
+		memmove(pFir->buf, &pFir->buf[n], FIR_HIST * sizeof(int16_t));
+		pIn += n;
+		pOut += n;
+		count -= n;
+	}
+}
+
+/* Initialize a filter chain with all stages enabled */
+void DSP_Chain_Init(DSP_FILTER_CHAIN_T *pChain, int32_t dcCoef,
+					const DSP_BIQUAD_COEF_T *pNotchCoef, const int16_t *pLpfCoef)
+{
+	DSP_DcBlock_Init(&pChain->dc, dcCoef);
+	DSP_Biquad_Init(&pChain->notch, pNotchCoef);
+	DSP_Fir_Init(&pChain->lpf, pLpfCoef);
+	pChain->dcEnabled = true;
+	pChain->notchEnabled = true;
+	pChain->lpfEnabled = true;
+}
+
+/* Run the enabled stages of a filter chain over a block in place */
+void DSP_Chain_Process(DSP_FILTER_CHAIN_T *pChain, int16_t *pSamples, uint32_t count)
+{
+	if (pChain->dcEnabled) {
+		DSP_DcBlock_Process(&pChain->dc, pSamples, pSamples, count);
+	}
+	if (pChain->notchEnabled) {
+		DSP_Biquad_Process(&pChain->notch, pSamples, pSamples, count);
+	}
+	if (pChain->lpfEnabled) {
+		DSP_Fir_Process(&pChain->lpf, pSamples, pSamples, count);
+	}
+}
@@ -0,0 +1,305 @@
+/*
+ * @brief Lossless block coding of 12-bit samples
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "dsp_rice.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Largest Rice parameter, any larger one would not beat a raw partition */
+#define RICE_MAX_K          13
+
+/* Bits written at once by putBits() */
+#define RICE_PUT_MAX        24
+
+/* Bit stream being written, bits holds the pending bit count, below 8 */
+typedef struct {
+	uint8_t *p;
+	uint32_t acc;
+	uint32_t bits;
+} RICE_WRITER_T;
+
+/* Bit stream being read, reading past the end sets err and returns zeros */
+typedef struct {
+	const uint8_t *p;
+	const uint8_t *pEnd;
+	uint32_t acc;
+	uint32_t bits;
+	bool err;
+} RICE_READER_T;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Append up to RICE_PUT_MAX bits */
+static inline void putBits(RICE_WRITER_T *pW, uint32_t value, uint32_t len)
+{
+	pW->acc = (pW->acc << len) | value;
+	pW->bits += len;
+	while (pW->bits >= 8) {
+		pW->bits -= 8;
+		*pW->p++ = (uint8_t) (pW->acc >> pW->bits);
+	}
+}
+
+/* Write out the last partial byte, zero padded */
+static void flushBits(RICE_WRITER_T *pW)
+{
+	if (pW->bits) {
+		*pW->p++ = (uint8_t) (pW->acc << (8 - pW->bits));
+		pW->bits = 0;
+	}
+}
+
+/* Bits used by n residuals with parameter k */
+static uint32_t riceCost(const uint32_t *pU, uint32_t n, uint32_t k)
+{
+	uint32_t i, cost = n * (k + 1);
+
+	for (i = 0; i < n; i++) {
+		cost += pU[i] >> k;
+	}
+
+	return cost;
+}
+
+/* Code one partition of zigzag mapped residuals, pIn holds its samples */
+static void encodePartition(RICE_WRITER_T *pW, const uint16_t *pIn, const uint32_t *pU, uint32_t n)
+{
+	uint32_t i, k, q, u, sum = 0, mean, cost, bestCost, bestK, first, last;
+
+	for (i = 0; i < n; i++) {
+		sum += pU[i];
+	}
+
+	/* The best parameter is next to log2 of the mean, try its neighbours */
+	mean = sum / n;
+	k = mean ? (31 - __builtin_clz(mean)) : 0;
+	first = k ? (k - 1) : 0;
+	last = (k < RICE_MAX_K) ? (k + 1) : RICE_MAX_K;
+	bestK = first;
+	bestCost = riceCost(pU, n, first);
+	for (k = first + 1; k <= last; k++) {
+		cost = riceCost(pU, n, k);
+		if (cost < bestCost) {
+			bestCost = cost;
+			bestK = k;
+		}
+	}
+
+	if (bestCost >= (n * DSP_RICE_RAW_BITS)) {
+		putBits(pW, DSP_RICE_RAW_K, 4);
+		for (i = 0; i < n; i++) {
+			putBits(pW, pIn[i], DSP_RICE_RAW_BITS);
+		}
+		return;
+	}
+
+	k = bestK;
+	putBits(pW, k, 4);
+	for (i = 0; i < n; i++) {
+		u = pU[i];
+		q = u >> k;
+		if ((q + 1 + k) <= RICE_PUT_MAX) {
+			/* Quotient, stop bit and remainder in one go */
+			putBits(pW, ((((1UL << q) - 1) << (k + 1))) | (u & ((1UL << k) - 1)), q + 1 + k);
+		}
+		else {
+			while (q >= 16) {
+				putBits(pW, 0xFFFF, 16);
+				q -= 16;
+			}
+			putBits(pW, ((1UL << q) - 1) << 1, q + 1);
+			putBits(pW, u & ((1UL << k) - 1), k);
+		}
+	}
+}
+
+/* Take up to RICE_PUT_MAX bits */
+static uint32_t getBits(RICE_READER_T *pR, uint32_t len)
+{
+	while (pR->bits < len) {
+		pR->acc <<= 8;
+		if (pR->p < pR->pEnd) {
+			pR->acc |= *pR->p++;
+		}
+		else {
+			pR->err = true;
+		}
+		pR->bits += 8;
+	}
+	pR->bits -= len;
+
+	return (pR->acc >> pR->bits) & ((1UL << len) - 1);
+}
+
+/* Count one bits up to the stop bit */
+static uint32_t getUnary(RICE_READER_T *pR)
+{
+	uint32_t q = 0;
+
+	while (getBits(pR, 1)) {
+		/* A coded partition is shorter than its raw form */
+		if (++q > (DSP_RICE_PARTITION * DSP_RICE_RAW_BITS)) {
+			pR->err = true;
+			break;
+		}
+	}
+
+	return q;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Encode one block of samples */
+uint32_t DSP_Rice_Encode(const uint16_t *pIn, uint32_t count, uint8_t *pOut)
+{
+	RICE_WRITER_T w;
+	uint32_t u[DSP_RICE_PARTITION];
+	uint32_t i, j, n, order, sum1 = 0, sum2 = 0;
+	int32_t r, d, dPrev;
+
+	/* One pass over the block picks the predictor */
+	if (count > 2) {
+		dPrev = (int32_t) pIn[1] - pIn[0];
+		sum1 = (dPrev < 0) ? -dPrev : dPrev;
+		for (i = 2; i < count; i++) {
+			d = (int32_t) pIn[i] - pIn[i - 1];
+			r = d - dPrev;
+			sum1 += (d < 0) ? -d : d;
+			sum2 += (r < 0) ? -r : r;
+			dPrev = d;
+		}
+	}
+	order = ((count > 2) && (sum2 < sum1)) ? 2 : 1;
+
+	pOut[0] = (uint8_t) count;
+	pOut[1] = (uint8_t) (count >> 8);
+	pOut[2] = (uint8_t) order;
+	w.p = &pOut[DSP_RICE_HEADER_BYTES];
+	w.acc = 0;
+	w.bits = 0;
+
+	for (i = 0; i < order; i++) {
+		putBits(&w, pIn[i], DSP_RICE_RAW_BITS);
+	}
+	for (i = order; i < count; i += n) {
+		n = count - i;
+		if (n > DSP_RICE_PARTITION) {
+			n = DSP_RICE_PARTITION;
+		}
+		for (j = 0; j < n; j++) {
+			if (order == 1) {
+				r = (int32_t) pIn[i + j] - pIn[i + j - 1];
+			}
+			else {
+				r = (int32_t) pIn[i + j] - (2 * pIn[i + j - 1]) + pIn[i + j - 2];
+			}
+			u[j] = ((uint32_t) r << 1) ^ (uint32_t) (r >> 31);
+		}
+		encodePartition(&w, &pIn[i], u, n);
+	}
+	flushBits(&w);
+
+	return w.p - pOut;
+}
+
+/* Return the sample count of an encoded block */
+uint32_t DSP_Rice_GetCount(const uint8_t *pIn)
+{
+	return pIn[0] | ((uint32_t) pIn[1] << 8);
+}
+
+/* Decode one block of samples */
+uint32_t DSP_Rice_Decode(const uint8_t *pIn, uint32_t len, uint16_t *pOut, uint32_t maxCount)
+{
+	RICE_READER_T rd;
+	uint32_t i, j, n, k, u, count, order;
+	int32_t r, x;
+
+	if (len < DSP_RICE_HEADER_BYTES) {
+		return 0;
+	}
+	count = DSP_Rice_GetCount(pIn);
+	order = pIn[2];
+	if ((count == 0) || (count > maxCount) || (order < 1) || (order > 2) || (order > count)) {
+		return 0;
+	}
+
+	rd.p = &pIn[DSP_RICE_HEADER_BYTES];
+	rd.pEnd = &pIn[len];
+	rd.acc = 0;
+	rd.bits = 0;
+	rd.err = false;
+
+	for (i = 0; i < order; i++) {
+		pOut[i] = (uint16_t) getBits(&rd, DSP_RICE_RAW_BITS);
+	}
+	for (i = order; i < count; i += n) {
+		n = count - i;
+		if (n > DSP_RICE_PARTITION) {
+			n = DSP_RICE_PARTITION;
+		}
+		k = getBits(&rd, 4);
+		if ((k > RICE_MAX_K) && (k != DSP_RICE_RAW_K)) {
+			return 0;
+		}
+		for (j = i; j < (i + n); j++) {
+			if (k == DSP_RICE_RAW_K) {
+				pOut[j] = (uint16_t) getBits(&rd, DSP_RICE_RAW_BITS);
+				continue;
+			}
+			u = getUnary(&rd) << k;
+			u |= getBits(&rd, k);
+			r = (int32_t) (u >> 1) ^ -(int32_t) (u & 1);
+			if (order == 1) {
+				x = pOut[j - 1] + r;
+			}
+			else {
+				x = (2 * pOut[j - 1]) - pOut[j - 2] + r;
+			}
+			if (rd.err || (x < 0) || (x > 0xFFF)) {
+				return 0;
+			}
+			pOut[j] = (uint16_t) x;
+		}
+	}
+
+	return rd.err ? 0 : count;
+}
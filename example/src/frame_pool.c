@@ -0,0 +1,109 @@
+/*
+ * @brief Pool of frame blocks sent in place
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "frame_pool.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+static uint32_t blocks[FRAME_POOL_BLOCKS][FRAME_POOL_BLOCK_BYTES / 4] __attribute__ ((aligned(64)));
+
+/* Indices of the free blocks. FramePool_Free() is the only writer of
+   freeHead and FramePool_Alloc() the only writer of freeTail. */
+static volatile uint8_t freeList[FRAME_POOL_BLOCKS];
+static volatile uint32_t freeHead, freeTail;
+static uint32_t lowWater;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Put every block back into the pool */
+void FramePool_Init(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < FRAME_POOL_BLOCKS; i++) {
+		freeList[i] = (uint8_t) i;
+	}
+	freeTail = 0;
+	freeHead = FRAME_POOL_BLOCKS;
+	lowWater = FRAME_POOL_BLOCKS;
+}
+
+/* Take a block */
+uint8_t *FramePool_Alloc(void)
+{
+	uint32_t tail = freeTail;
+	uint32_t free = freeHead - tail;
+
+	if (free == 0) {
+		return NULL;
+	}
+	if ((free - 1) < lowWater) {
+		lowWater = free - 1;
+	}
+
+	freeTail = tail + 1;
+	return (uint8_t *) blocks[freeList[tail & (FRAME_POOL_BLOCKS - 1)]];
+}
+
+/* Give a block back */
+void FramePool_Free(uint8_t *pBlock)
+{
+	uint32_t head = freeHead;
+
+	/* The slot is written before freeHead makes it visible, both volatile */
+	freeList[head & (FRAME_POOL_BLOCKS - 1)] = (uint8_t) (((uint32_t *) pBlock - blocks[0]) /
+												(FRAME_POOL_BLOCK_BYTES / 4));
+	freeHead = head + 1;
+}
+
+/* Return the number of free blocks */
+uint32_t FramePool_GetFree(void)
+{
+	return freeHead - freeTail;
+}
+
+/* Return the fewest free blocks seen since FramePool_Init() */
+uint32_t FramePool_GetLowWater(void)
+{
+	return lowWater;
+}
@@ -0,0 +1,145 @@
+/*
+ * @brief Raw samples in vendor HID reports
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "hid_stream.h"
+#include "host_frame.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define FIFO_MASK           (HID_STREAM_FIFO_SZ - 1)
+
+static uint16_t fifo[HID_STREAM_FIFO_SZ];
+static uint32_t head, tail;		/* Samples written and read */
+static uint32_t nextIndex;		/* Sample index of the next block */
+static uint32_t readIndex;		/* Sample index at tail */
+static uint16_t seq;
+
+/* A dropped block ends the run of samples at gapPos, the next run starts
+   at gapIndex */
+static bool gapPending, gapFlag;
+static uint32_t gapPos, gapIndex;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Empty the queue and restart the sequence */
+void HID_Stream_Init(void)
+{
+	head = tail = 0;
+	nextIndex = readIndex = 0;
+	seq = 0;
+	gapPending = gapFlag = false;
+}
+
+/* Queue a block of 12-bit samples */
+uint32_t HID_Stream_Write(const uint16_t *pSamples, uint32_t count)
+{
+	uint32_t pos, first, dropped = 0;
+
+	if (count > (HID_STREAM_FIFO_SZ - (head - tail))) {
+		if (gapPending) {
+			/* Only one gap is kept, samples queued after it go as well */
+			dropped = head - gapPos;
+			head = gapPos;
+		}
+		gapPending = true;
+		gapPos = head;
+		nextIndex += count;
+		gapIndex = nextIndex;
+		return dropped + count;
+	}
+
+	pos = head & FIFO_MASK;
+	first = HID_STREAM_FIFO_SZ - pos;
+	if (first > count) {
+		first = count;
+	}
+	memcpy(&fifo[pos], pSamples, first * sizeof(uint16_t));
+	memcpy(fifo, &pSamples[first], (count - first) * sizeof(uint16_t));
+	head += count;
+	nextIndex += count;
+
+	return 0;
+}
+
+/* Fill the next input report from the queue */
+uint32_t HID_Stream_FillReport(uint8_t *pReport)
+{
+	uint16_t samples[HID_STREAM_MAX_SAMPLES];
+	uint32_t i, n;
+
+	if (gapPending && (tail == gapPos)) {
+		readIndex = gapIndex;
+		gapPending = false;
+		gapFlag = true;
+	}
+
+	/* A report never spans a gap */
+	n = (gapPending ? gapPos : head) - tail;
+	if (n > HID_STREAM_MAX_SAMPLES) {
+		n = HID_STREAM_MAX_SAMPLES;
+	}
+	for (i = 0; i < n; i++) {
+		samples[i] = fifo[(tail + i) & FIFO_MASK];
+	}
+
+	memset(pReport, 0, HID_STREAM_REPORT_SIZE);
+	pReport[0] = (uint8_t) n;
+	pReport[1] = gapFlag ? HID_STREAM_FLAG_GAP : 0;
+	pReport[2] = (uint8_t) seq;
+	pReport[3] = (uint8_t) (seq >> 8);
+	pReport[4] = (uint8_t) readIndex;
+	pReport[5] = (uint8_t) (readIndex >> 8);
+	pReport[6] = (uint8_t) (readIndex >> 16);
+	pReport[7] = (uint8_t) (readIndex >> 24);
+	Frame_Pack12(samples, n, &pReport[HID_STREAM_HEADER_BYTES]);
+
+	seq++;
+	tail += n;
+	readIndex += n;
+	if (n != 0) {
+		gapFlag = false;
+	}
+
+	return n;
+}
@@ -0,0 +1,224 @@
+/*
+ * @brief Command and record link to the host over the virtual COM port
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "board.h"
+#include "cdc_vcom.h"
+#include "host_link.h"
+#include "diag_stats.h"
+
+#if defined(APP_USB_VCOM)
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+static char cmdLine[LINK_CMD_LINE_MAX];
+static uint32_t cmdLen;
+static bool cmdOverflow;
+
+static const LINK_CMD_T *pCmdTable;
+static uint32_t cmdCount;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* List the commands */
+static void cmdHelp(void)
+{
+	uint32_t i;
+
+	Link_Printf("help - list commands\r\n");
+	for (i = 0; i < cmdCount; i++) {
+		Link_Printf("%s - %s\r\n", pCmdTable[i].pName, pCmdTable[i].pHelp);
+	}
+}
+
+/* Split a command line and call its handler */
+static void runCommand(char *pLine)
+{
+	char *pArgs;
+	uint32_t i;
+
+	while (*pLine == ' ') {
+		pLine++;
+	}
+	if (*pLine == 0) {
+		return;
+	}
+
+	pArgs = strchr(pLine, ' ');
+	if (pArgs != NULL) {
+		*pArgs++ = 0;
+		while (*pArgs == ' ') {
+			pArgs++;
+		}
+	}
+	else {
+		pArgs = &pLine[strlen(pLine)];
+	}
+
+	if (strcmp(pLine, "help") == 0) {
+		cmdHelp();
+		return;
+	}
+
+	for (i = 0; i < cmdCount; i++) {
+		if (strcmp(pLine, pCmdTable[i].pName) == 0) {
+			pCmdTable[i].handler(pArgs);
+			return;
+		}
+	}
+
+	Link_Printf("ERR unknown command %s\r\n", pLine);
+}
+
+/* Collect received bytes into lines, read in place from the RX buffers */
+static void receive(void)
+{
+	uint8_t *pData;
+	uint32_t count, i;
+	char c;
+
+	while ((count = vcom_rx_peek(&pData)) != 0) {
+		for (i = 0; i < count; i++) {
+			c = (char) pData[i];
+			if ((c == '\r') || (c == '\n')) {
+				if (cmdOverflow) {
+					Link_Printf("ERR line too long\r\n");
+				}
+				else {
+					cmdLine[cmdLen] = 0;
+					runCommand(cmdLine);
+				}
+				cmdLen = 0;
+				cmdOverflow = false;
+			}
+			else if (cmdLen < (LINK_CMD_LINE_MAX - 1)) {
+				cmdLine[cmdLen++] = c;
+			}
+			else {
+				cmdOverflow = true;
+			}
+		}
+		vcom_rx_consume(count);
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the host link */
+void Link_Init(const LINK_CMD_T *pCmds, uint32_t count)
+{
+	pCmdTable = pCmds;
+	cmdCount = count;
+	cmdLen = 0;
+	cmdOverflow = false;
+}
+
+/* Run received commands, queued data is sent from the USB interrupt */
+void Link_Poll(void)
+{
+	if (Link_IsConnected()) {
+		receive();
+	}
+}
+
+/* Queue data for the host */
+bool Link_Write(const void *pData, uint32_t len)
+{
+	if (!Link_IsConnected()) {
+		return false;
+	}
+	if (len > vcom_tx_free()) {
+		g_diag.usbTxFull++;
+		return false;
+	}
+
+	/* Room was checked, the ring takes all of it */
+	vcom_write((const uint8_t *) pData, len);
+	Diag_HighWater(&g_diag.linkFifoMax, LINK_TX_FIFO_SZ - vcom_tx_free());
+
+	return true;
+}
+
+/* Queue a formatted record for the host */
+bool Link_Printf(const char *pFmt, ...)
+{
+	char record[LINK_RECORD_MAX];
+	va_list args;
+	int len;
+
+	va_start(args, pFmt);
+	len = vsnprintf(record, sizeof(record), pFmt, args);
+	va_end(args);
+
+	if (len < 0) {
+		return false;
+	}
+	if (len >= (int) sizeof(record)) {
+		/* Keep the line terminator so the host still sees one record */
+		len = sizeof(record) - 1;
+		record[len - 2] = '\r';
+		record[len - 1] = '\n';
+	}
+
+	return Link_Write(record, len);
+}
+
+/* Tell the host that data was dropped for lack of TX room */
+void Link_Dropped(void)
+{
+	vcom_tx_drop();
+}
+
+/* Return the room left in the TX FIFO */
+uint32_t Link_GetFree(void)
+{
+	return vcom_tx_free();
+}
+
+/* Check if the host has opened the port */
+bool Link_IsConnected(void)
+{
+	return vcom_connected() != 0;
+}
+
+#endif /* defined(APP_USB_VCOM) */
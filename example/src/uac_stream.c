@@ -0,0 +1,227 @@
+/*
+ * @brief Sample stream and clock loop of the USB audio personality
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "uac_stream.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define FIFO_MASK           (UAC_STREAM_FIFO_SZ - 1)
+
+/* 12-bit sample to 16-bit PCM around mid-scale */
+#define PCM_OF(s)           ((int16_t) ((((s) & 0xFFF) << 4) - 0x8000))
+
+static volatile int16_t fifo[UAC_STREAM_FIFO_SZ];
+static volatile uint32_t head;	/* Samples queued */
+static volatile bool running;
+
+/* Frame side, only touched from the start of frame interrupt */
+static uint32_t rate, readLatency;
+static uint32_t readIndex;		/* Sample index of the next packet */
+static uint32_t lastConverted;
+static uint32_t frameAcc;		/* Samples due, in 1/1000 */
+static bool locked;
+static int32_t kp, ki, integ, trim;
+static UAC_STREAM_STATS_T stats;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static int32_t clampTrim(int32_t v)
+{
+	if (v > UAC_STREAM_TRIM_MAX) {
+		return UAC_STREAM_TRIM_MAX;
+	}
+	if (v < -UAC_STREAM_TRIM_MAX) {
+		return -UAC_STREAM_TRIM_MAX;
+	}
+	return v;
+}
+
+/* Move the read position to the latency behind the converter */
+static void resync(uint32_t converted)
+{
+	readIndex = converted - readLatency;
+	stats.errorMax = 0;
+}
+
+/* Advance the PI loop by one frame */
+static void runLoop(uint32_t converted)
+{
+	int32_t error = (int32_t) (converted - readIndex - readLatency);
+
+	if ((error > (int32_t) (readLatency / 2)) || (error < -(int32_t) (readLatency / 2))) {
+		/* Far off, e.g. after a pause of the sample clock */
+		resync(converted);
+		stats.resyncs++;
+		error = 0;
+	}
+	stats.error = error;
+	if ((error > stats.errorMax) || (-error > stats.errorMax)) {
+		stats.errorMax = (error < 0) ? -error : error;
+	}
+
+	/* A converter ahead of the frames gets a longer period */
+	integ = clampTrim(integ + (error * ki));
+	trim = clampTrim((error * kp) + integ);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Set up the stream, stopped */
+void UAC_Stream_Init(uint32_t rateHz, uint32_t latency)
+{
+	uint32_t perFrame = rateHz / 1000;
+
+	if (perFrame == 0) {
+		perFrame = 1;
+	}
+
+	running = false;
+	head = 0;
+	rate = rateHz;
+	readLatency = latency;
+	readIndex = 0;
+	lastConverted = 0;
+	frameAcc = 0;
+	locked = false;
+
+	/* Critically damped: the proportional part alone settles in
+	   UAC_STREAM_LOOP_FRAMES, the integral is four times slower */
+	kp = (1 << 24) / (int32_t) (perFrame * UAC_STREAM_LOOP_FRAMES);
+	ki = kp / (4 * UAC_STREAM_LOOP_FRAMES);
+	if (ki == 0) {
+		ki = 1;
+	}
+	integ = trim = 0;
+	memset(&stats, 0, sizeof(stats));
+}
+
+/* Queue a block of 12-bit samples */
+void UAC_Stream_Write(const uint16_t *pSamples, uint32_t count)
+{
+	uint32_t pos = head, i;
+
+	for (i = 0; i < count; i++) {
+		fifo[(pos + i) & FIFO_MASK] = PCM_OF(pSamples[i]);
+	}
+	head = pos + count;
+}
+
+/* Start filling packets */
+void UAC_Stream_Start(void)
+{
+	running = true;
+}
+
+/* Stop filling packets */
+void UAC_Stream_Stop(void)
+{
+	running = false;
+}
+
+/* Run the loop for one USB frame and fill its packet */
+uint32_t UAC_Stream_Frame(uint32_t converted, int16_t *pPacket)
+{
+	uint32_t n, i, index, queued;
+	bool clockRunning = (converted != lastConverted);
+
+	stats.frames++;
+	lastConverted = converted;
+	if (!locked) {
+		resync(converted);
+		locked = true;
+		clockRunning = true;
+	}
+
+	/* Samples due in this frame, a fraction is carried over */
+	frameAcc += rate;
+	n = frameAcc / 1000;
+	frameAcc -= n * 1000;
+
+	if (!clockRunning) {
+		/* The samples of this frame are not converted yet. Silence goes
+		   in their place, the loop and the read position wait. */
+		if (!running) {
+			return 0;
+		}
+		for (i = 0; i < n; i++) {
+			pPacket[i] = 0;
+		}
+		stats.inserted += n;
+		stats.samples += n;
+		return n;
+	}
+
+	runLoop(converted);
+	if (!running) {
+		readIndex += n;
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		index = readIndex + i;
+		queued = head - index;
+		/* Queued and not yet overwritten */
+		if ((queued - 1) < (UAC_STREAM_FIFO_SZ / 2)) {
+			pPacket[i] = fifo[index & FIFO_MASK];
+		}
+		else {
+			pPacket[i] = 0;
+			stats.underruns++;
+		}
+	}
+	readIndex += n;
+	stats.samples += n;
+
+	return n;
+}
+
+/* Return the output of the loop */
+int32_t UAC_Stream_GetTrim(void)
+{
+	return trim;
+}
+
+/* Return the stream counters */
+const UAC_STREAM_STATS_T *UAC_Stream_GetStats(void)
+{
+	return &stats;
+}
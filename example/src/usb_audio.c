@@ -0,0 +1,127 @@
+/*
+ * @brief USB audio streaming of the ADC samples
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "app_usbd_cfg.h"
+#include "usb_audio.h"
+#include "uac_stream.h"
+#include "adc_trig.h"
+
+#if defined(APP_USB_AUDIO)
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+static USB_AUDIO_CONVERTED_T pConverted;
+
+/* Packets in USB RAM, filled in turn so that the one being sent is left
+   alone. The endpoint takes buffers on a 64-byte boundary only. */
+#define USB_AUDIO_PACKET_BUF_SZ ((USB_AUDIO_PACKET_MAX + 63) & ~63)
+
+static int16_t *pPacket[2];
+static uint32_t packetSel;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Audio streaming init routine */
+ErrorCode_t usb_audio_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT_PARAM_T *pUsbParam,
+						   USB_AUDIO_CONVERTED_T converted)
+{
+	uint32_t i, pad;
+
+	(void) pDesc;
+	pConverted = converted;
+
+	/* allocate packet buffers, each on its own boundary */
+	pad = (64 - (pUsbParam->mem_base & 63)) & 63;
+	pUsbParam->mem_base += pad;
+	pUsbParam->mem_size -= pad;
+	for (i = 0; i < 2; i++) {
+		pPacket[i] = (int16_t *) pUsbParam->mem_base;
+		pUsbParam->mem_base += USB_AUDIO_PACKET_BUF_SZ;
+		pUsbParam->mem_size -= USB_AUDIO_PACKET_BUF_SZ;
+	}
+	packetSel = 0;
+
+	/* The loop runs on every start of frame */
+	return USBD_API->hw->EnableEvent(hUsb, 0, USB_EVT_SOF, 1);
+}
+
+/* Send the packet of this frame and trim the sample clock */
+ErrorCode_t usb_audio_sof_event(USBD_HANDLE_T hUsb)
+{
+	int16_t *pData = pPacket[packetSel];
+	uint32_t n, period = ADC_Trig_GetPeriodFrac();
+
+	n = UAC_Stream_Frame(pConverted(), pData);
+	ADC_Trig_SetPeriodFrac(period + (int32_t) (((int64_t) period * UAC_Stream_GetTrim()) >> 24));
+
+	if (n != 0) {
+		USBD_API->hw->WriteEP(hUsb, USB_AUDIO_IN_EP, (uint8_t *) pData, n * sizeof(int16_t));
+		packetSel ^= 1;
+	}
+	return LPC_OK;
+}
+
+/* Follow the alternate setting of the streaming interface */
+ErrorCode_t usb_audio_interface_event(USBD_HANDLE_T hUsb)
+{
+	USB_CORE_CTRL_T *pCtrl = (USB_CORE_CTRL_T *) hUsb;
+
+	if (pCtrl->alt_setting[USB_AUDIO_SIF_NUM] != 0) {
+		UAC_Stream_Start();
+	}
+	else {
+		UAC_Stream_Stop();
+	}
+	return LPC_OK;
+}
+
+/* The host sets up the streaming interface again after a reset */
+ErrorCode_t usb_audio_reset_event(USBD_HANDLE_T hUsb)
+{
+	(void) hUsb;
+	UAC_Stream_Stop();
+	return LPC_OK;
+}
+
+#endif /* defined(APP_USB_AUDIO) */
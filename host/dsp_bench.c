@@ -0,0 +1,185 @@
+/*
+ * @brief Host benchmark of the ADC signal processing stages
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+/*
+ * Host build of the device signal processing stages, used to measure their
+ * cost per sample away from the target. Build from this directory with:
+ *
+ *   gcc -O2 -I../example/inc -o dsp_bench dsp_bench.c ../example/src/adc_decim.c \
+ *       ../example/src/dsp_filter.c
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "adc_decim.h"
+#include "dsp_filter.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define BENCH_BLOCK_SAMPLES     256
+#define BENCH_BLOCKS            20000
+
+static uint16_t inBlock[BENCH_BLOCK_SAMPLES];
+static int16_t outBlock[BENCH_BLOCK_SAMPLES];
+static int16_t filtBlock[BENCH_BLOCK_SAMPLES];
+
+/* Same filter design as the device at a 2 kHz filter rate */
+#define BENCH_FILTER_FS_HZ      2000
+
+static const DSP_BIQUAD_COEF_T benchNotch = DSP_NOTCH_COEF(BENCH_FILTER_FS_HZ, 50, 5);
+static const int16_t benchLpf[DSP_FIR_TAPS] = DSP_LPF_COEF(BENCH_FILTER_FS_HZ, 400);
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static double nowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+static uint64_t nowTicks(void)
+{
+#if defined(HAVE_TSC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/* Triangle wave with a little dither over most of the 12-bit range */
+static void fillInput(void)
+{
+	uint32_t i, seed = 1;
+
+	for (i = 0; i < BENCH_BLOCK_SAMPLES; i++) {
+		seed = (seed * 1103515245) + 12345;
+		inBlock[i] = (uint16_t) (200 + ((i < 128) ? (i * 28) : ((255 - i) * 28)) + ((seed >> 16) & 3));
+	}
+}
+
+static void benchDecim(void)
+{
+	ADC_DECIM_T dec;
+	uint32_t ratio, b, outCount;
+	double t0, ns;
+	uint64_t c0, ticks;
+
+	for (ratio = ADC_DECIM_MIN_RATIO; ratio <= ADC_DECIM_MAX_RATIO; ratio *= 2) {
+		ADC_Decim_Init(&dec, ratio);
+		outCount = 0;
+
+		t0 = nowNs();
+		c0 = nowTicks();
+		for (b = 0; b < BENCH_BLOCKS; b++) {
+			outCount += ADC_Decim_Process(&dec, inBlock, BENCH_BLOCK_SAMPLES, outBlock);
+		}
+		ticks = nowTicks() - c0;
+		ns = nowNs() - t0;
+
+		printf("decim x%-3u: %6.2f ns/sample, %6.2f TSC ticks/sample (%u outputs)\n", ratio,
+			   ns / ((double) BENCH_BLOCKS * BENCH_BLOCK_SAMPLES),
+			   (double) ticks / ((double) BENCH_BLOCKS * BENCH_BLOCK_SAMPLES), outCount);
+	}
+}
+
+/* Print the cost of one filter kernel run over the bench block */
+static void printKernel(const char *pName, double ns, uint64_t ticks)
+{
+	printf("%-14s: %6.2f ns/sample, %6.2f TSC ticks/sample\n", pName,
+		   ns / ((double) BENCH_BLOCKS * BENCH_BLOCK_SAMPLES),
+		   (double) ticks / ((double) BENCH_BLOCKS * BENCH_BLOCK_SAMPLES));
+}
+
+static void benchFilters(void)
+{
+	DSP_FILTER_CHAIN_T chain;
+	uint32_t i, b;
+	double t0;
+	uint64_t c0;
+
+	/* Signed input like the decimator output */
+	for (i = 0; i < BENCH_BLOCK_SAMPLES; i++) {
+		filtBlock[i] = (int16_t) ((inBlock[i] - 2048) << 3);
+	}
+	DSP_Chain_Init(&chain, DSP_DCBLOCK_COEF(BENCH_FILTER_FS_HZ, 1), &benchNotch, benchLpf);
+
+	t0 = nowNs();
+	c0 = nowTicks();
+	for (b = 0; b < BENCH_BLOCKS; b++) {
+		DSP_DcBlock_Process(&chain.dc, filtBlock, outBlock, BENCH_BLOCK_SAMPLES);
+	}
+	printKernel("dc blocker Q31", nowNs() - t0, nowTicks() - c0);
+
+	t0 = nowNs();
+	c0 = nowTicks();
+	for (b = 0; b < BENCH_BLOCKS; b++) {
+		DSP_Biquad_Process(&chain.notch, filtBlock, outBlock, BENCH_BLOCK_SAMPLES);
+	}
+	printKernel("notch Q31", nowNs() - t0, nowTicks() - c0);
+
+	t0 = nowNs();
+	c0 = nowTicks();
+	for (b = 0; b < BENCH_BLOCKS; b++) {
+		DSP_Fir_Process(&chain.lpf, filtBlock, outBlock, BENCH_BLOCK_SAMPLES);
+	}
+	printKernel("fir15 Q15", nowNs() - t0, nowTicks() - c0);
+
+	t0 = nowNs();
+	c0 = nowTicks();
+	for (b = 0; b < BENCH_BLOCKS; b++) {
+		DSP_Chain_Process(&chain, outBlock, BENCH_BLOCK_SAMPLES);
+	}
+	printKernel("chain", nowNs() - t0, nowTicks() - c0);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	fillInput();
+	benchDecim();
+	benchFilters();
+	return 0;
+}
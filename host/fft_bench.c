@@ -0,0 +1,227 @@
+/*
+ * @brief Host accuracy and speed check of the fixed-point FFT
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+/*
+ * Host check of the device fixed-point FFT against a double precision DFT,
+ * with its run time. Build from this directory with:
+ *
+ *   gcc -O2 -I../example/inc -o fft_bench fft_bench.c ../example/src/dsp_fft.c -lm
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "dsp_fft.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define BENCH_RUNS          2000
+
+/* Input scaling of the device spectrum stage */
+#define BENCH_IN_SHIFT      6
+
+static const char *const windowName[DSP_FFT_WIN_COUNT] = {"rect", "hann", "hamming", "blackman"};
+
+static uint16_t samples[DSP_FFT_MAX_SIZE];
+static int16_t window[DSP_FFT_MAX_SIZE];
+static int32_t frame[DSP_FFT_MAX_SIZE];
+static int32_t work[DSP_FFT_MAX_SIZE];
+static double refRe[DSP_FFT_MAX_SIZE / 2 + 1];
+static double refIm[DSP_FFT_MAX_SIZE / 2 + 1];
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static double nowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+static uint64_t nowTicks(void)
+{
+#if defined(HAVE_TSC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/* Two tones, one between bins, and a little noise over most of the 12-bit range */
+static void fillInput(uint32_t size)
+{
+	uint32_t i, seed = 1;
+
+	for (i = 0; i < size; i++) {
+		seed = (seed * 1103515245) + 12345;
+		samples[i] = (uint16_t) (2048 + 1500 * sin(2 * M_PI * i * 5.0 / 64) +
+								 300 * sin(2 * M_PI * i * 37.3 / size) + ((seed >> 16) & 7) - 3.5 + 0.5);
+	}
+}
+
+/* Windowed frame as the device builds it */
+static void buildFrame(uint32_t size)
+{
+	uint32_t i;
+
+	for (i = 0; i < size; i++) {
+		frame[i] = ((samples[i] - 2048) * window[i]) >> BENCH_IN_SHIFT;
+	}
+}
+
+/* Double precision DFT of the same integer frame, bins 0 to size / 2 */
+static void referenceDft(uint32_t size)
+{
+	uint32_t k, i;
+	double re, im, a;
+
+	for (k = 0; k <= (size / 2); k++) {
+		re = 0;
+		im = 0;
+		for (i = 0; i < size; i++) {
+			a = 2 * M_PI * (double) ((k * i) % size) / size;
+			re += frame[i] * cos(a);
+			im -= frame[i] * sin(a);
+		}
+		refRe[k] = re;
+		refIm[k] = im;
+	}
+}
+
+/* Error of the fixed-point bins against the reference, the worst errors
+   relative to the largest bin */
+static void checkAccuracy(uint32_t size, double *pSnrDb, double *pMaxErr, double *pMagErrDb)
+{
+	uint32_t k;
+	double re, im, err, sig = 0, noise = 0, maxErr = 0, peak = 0, magErr = 0, mag;
+	uint32_t acc[DSP_FFT_MAX_SIZE / 2] = {0};
+
+	for (k = 0; k <= (size / 2); k++) {
+		if (k == 0) {
+			re = work[0];
+			im = 0;
+		}
+		else if (k == (size / 2)) {
+			re = work[1];
+			im = 0;
+		}
+		else {
+			re = work[2 * k];
+			im = work[(2 * k) + 1];
+		}
+		err = hypot(re - refRe[k], im - refIm[k]);
+		noise += err * err;
+		sig += (refRe[k] * refRe[k]) + (refIm[k] * refIm[k]);
+		if (err > maxErr) {
+			maxErr = err;
+		}
+	}
+
+	/* Magnitudes scaled so that the largest bin reads 0xFFFF */
+	for (k = 0; k < (size / 2); k++) {
+		mag = hypot(refRe[k], refIm[k]);
+		if (mag > peak) {
+			peak = mag;
+		}
+	}
+	DSP_Fft_AddMagnitude(work, size, (uint32_t) ((65535.0 * 4294967296.0) / peak), acc);
+	for (k = 0; k < (size / 2); k++) {
+		err = fabs((acc[k] * peak / 65535.0) - hypot(refRe[k], refIm[k]));
+		if (err > magErr) {
+			magErr = err;
+		}
+	}
+
+	*pSnrDb = 10 * log10(sig / noise);
+	*pMaxErr = 20 * log10(maxErr / peak);
+	*pMagErrDb = 20 * log10(magErr / peak);
+}
+
+static void benchSize(uint32_t size)
+{
+	uint32_t w, r, i;
+	double snr, maxErr, magErr, t0, ns;
+	uint64_t c0, ticks;
+
+	fillInput(size);
+
+	for (w = 0; w < DSP_FFT_WIN_COUNT; w++) {
+		DSP_Fft_Window(window, size, (DSP_FFT_WINDOW_T) w);
+		buildFrame(size);
+		referenceDft(size);
+		for (i = 0; i < size; i++) {
+			work[i] = frame[i];
+		}
+		DSP_Fft_Real(work, size);
+		checkAccuracy(size, &snr, &maxErr, &magErr);
+
+		printf("fft %4u %-8s: SNR %6.1f dB, worst bin error %6.1f dB, worst magnitude error %6.1f dB\n",
+			   size, windowName[w], snr, maxErr, magErr);
+	}
+
+	t0 = nowNs();
+	c0 = nowTicks();
+	for (r = 0; r < BENCH_RUNS; r++) {
+		for (i = 0; i < size; i++) {
+			work[i] = frame[i];
+		}
+		DSP_Fft_Real(work, size);
+	}
+	ticks = nowTicks() - c0;
+	ns = nowNs() - t0;
+	printf("fft %4u run time: %8.0f ns, %8.0f TSC ticks per frame (copy included)\n", size,
+		   ns / BENCH_RUNS, (double) ticks / BENCH_RUNS);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	uint32_t size;
+
+	for (size = DSP_FFT_MIN_SIZE; size <= DSP_FFT_MAX_SIZE; size *= 2) {
+		benchSize(size);
+	}
+	return 0;
+}
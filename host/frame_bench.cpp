@@ -0,0 +1,296 @@
+/*
+ * @brief Throughput of the host frame decoder
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+/*
+ * Throughput of the host frame decoder against parsing the same samples
+ * sent as text records. The stream is built with the device framing code,
+ * text records are mixed in and a few frames are corrupted to exercise
+ * the resynchronization. The frames carry the time references of a
+ * device whose oscillator is off by BENCH_DRIFT_PPM; the sample times
+ * rebuilt by the Timeline are checked against the true ones. Build from this directory with:
+ *
+ *   gcc -O2 -I../example/inc -c ../example/src/host_frame.c
+ *   g++ -O2 -I../example/inc -o frame_bench frame_bench.cpp frame_decoder.cpp host_frame.o
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "frame_decoder.h"
+#include "host_frame.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Samples per frame, as sent by the device */
+#define BENCH_FRAME_SAMPLES     256
+
+/* Frames in the test stream, 64 Msamples */
+#define BENCH_FRAMES            (256 * 1024)
+
+/* A text record after every this many frames, a bad CRC every BENCH_BAD_EVERY */
+#define BENCH_TEXT_EVERY        4
+#define BENCH_BAD_EVERY         10007
+
+/* Bytes per feed(), a typical serial port read */
+#define BENCH_READ_BYTES        4096
+
+/* Filtered samples per text record on the device */
+#define BENCH_TEXT_PER_RECORD   8
+
+/* Device core clock, its error against the host and the sample period */
+#define BENCH_CORE_HZ           72000000.0
+#define BENCH_DRIFT_PPM         37.0
+#define BENCH_SAMPLE_CYCLES     720
+
+/* Samples from the end of a block to its reference, start of frame
+   latency up to this many cycles */
+#define BENCH_REF_LAG           2
+#define BENCH_SOF_JITTER        36
+
+/* Sample times are checked once the estimates have a second of data */
+#define BENCH_SETTLE_SAMPLES    100000
+
+/* Device cycles in one host millisecond */
+static const double cyclesPerMs = (BENCH_CORE_HZ / 1000.0) * (1.0 + (BENCH_DRIFT_PPM * 1e-6));
+
+/* Checks every sample against the generator */
+class CheckSink : public adcframe::Sink {
+public:
+	CheckSink() : mErrors(0), mLines(0), mTimeErrorUs(0) {}
+
+	void onFrame(const adcframe::Frame &frame)
+	{
+		uint32_t i;
+		double error;
+
+		for (i = 0; i < frame.count; i++) {
+			if (frame.samples[i] != sampleAt(frame.timestamp + i)) {
+				mErrors++;
+			}
+		}
+
+		mTime.update(frame);
+		if (mTime.ready() && (frame.timestamp >= BENCH_SETTLE_SAMPLES)) {
+			error = fabs(mTime.sampleTime(frame, frame.timestamp) - timeAt(frame.timestamp)) * 1000.0;
+			if (error > mTimeErrorUs) {
+				mTimeErrorUs = error;
+			}
+		}
+	}
+
+	void onText(const char *pLine, size_t len)
+	{
+		(void) pLine;
+		(void) len;
+		mLines++;
+	}
+
+	static uint16_t sampleAt(uint32_t index)
+	{
+		return (uint16_t) ((index * 2654435761U) >> 20);
+	}
+
+	/* Device cycles at a sample, not wrapped */
+	static uint64_t cyclesAt(uint32_t index)
+	{
+		return 12345 + ((uint64_t) index * BENCH_SAMPLE_CYCLES);
+	}
+
+	/* True time of a sample in host milliseconds */
+	static double timeAt(uint32_t index)
+	{
+		return cyclesAt(index) / cyclesPerMs;
+	}
+
+	uint64_t mErrors;
+	uint64_t mLines;
+	adcframe::Timeline mTime;
+	double mTimeErrorUs;		/*!< Worst sample time error once settled */
+};
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static double nowSec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + (ts.tv_nsec * 1e-9);
+}
+
+/* Time reference of the block ending with sample end, as the device
+   latches it: the cycle count of a later sample and of the start of frame
+   before it, taken a little late */
+static void setTime(FRAME_INFO_T *pInfo, uint32_t end)
+{
+	uint64_t cycles, sofCycles;
+	uint32_t frame;
+
+	pInfo->time.index = end + BENCH_REF_LAG;
+	cycles = CheckSink::cyclesAt(pInfo->time.index);
+	frame = (uint32_t) floor(cycles / cyclesPerMs);
+	do {
+		sofCycles = (uint64_t) ceil(frame * cyclesPerMs) + ((frame * 2654435761U) >> 16) % BENCH_SOF_JITTER;
+	} while ((sofCycles > cycles) && frame--);
+
+	pInfo->time.cycles = (uint32_t) cycles;
+	pInfo->time.sofFrame = frame;
+	pInfo->time.sofCycles = (uint32_t) sofCycles;
+}
+
+/* Frames with text records in between, as the device mixes them */
+static void buildStream(std::vector<uint8_t> &stream, uint32_t *pBad)
+{
+	uint16_t samples[BENCH_FRAME_SAMPLES];
+	uint8_t frame[FRAME_BYTES(BENCH_FRAME_SAMPLES)];
+	FRAME_INFO_T info = {FRAME_TYPE_SAMPLES12, FRAME_FLAG_SOF, 0, 0, FRAME_CHAN_ADC1(1), {0, 0, 0, 0}};
+	char text[64];
+	uint32_t f, i, len;
+	int n;
+
+	*pBad = 0;
+	stream.reserve((size_t) BENCH_FRAMES * sizeof(frame));
+	for (f = 0; f < BENCH_FRAMES; f++) {
+		info.seq = f;
+		info.timestamp = f * BENCH_FRAME_SAMPLES;
+		setTime(&info, info.timestamp + BENCH_FRAME_SAMPLES - 1);
+		for (i = 0; i < BENCH_FRAME_SAMPLES; i++) {
+			samples[i] = CheckSink::sampleAt(info.timestamp + i);
+		}
+		len = Frame_Build(frame, &info, samples, BENCH_FRAME_SAMPLES);
+		if ((f % BENCH_BAD_EVERY) == (BENCH_BAD_EVERY - 1)) {
+			frame[FRAME_HEADER_BYTES + 5] ^= 0x10;
+			(*pBad)++;
+		}
+		stream.insert(stream.end(), frame, frame + len);
+
+		if ((f % BENCH_TEXT_EVERY) == 0) {
+			n = sprintf(text, "E 1 1 U %u %u 3071\r\n", info.timestamp, f * 4500);
+			stream.insert(stream.end(), text, text + n);
+		}
+	}
+}
+
+/* The same samples as "S <index> <v>..." records */
+static void buildText(std::vector<char> &text)
+{
+	char record[128];
+	uint32_t index, i;
+	int n;
+
+	text.reserve((size_t) BENCH_FRAMES * BENCH_FRAME_SAMPLES * 5);
+	for (index = 0; index < ((uint32_t) BENCH_FRAMES * BENCH_FRAME_SAMPLES); index += BENCH_TEXT_PER_RECORD) {
+		n = sprintf(record, "S %u", index);
+		for (i = 0; i < BENCH_TEXT_PER_RECORD; i++) {
+			n += sprintf(&record[n], " %u", CheckSink::sampleAt(index + i));
+		}
+		n += sprintf(&record[n], "\r\n");
+		text.insert(text.end(), record, record + n);
+	}
+}
+
+/* Parse the text records, return the sample count */
+static uint64_t parseText(const std::vector<char> &text, uint64_t *pErrors)
+{
+	const char *p = text.data(), *pEnd = p + text.size();
+	char *pNext;
+	uint32_t index, i;
+	uint64_t samples = 0;
+
+	while (p < pEnd) {
+		index = (uint32_t) strtoul(p + 2, &pNext, 10);
+		p = pNext;
+		for (i = 0; i < BENCH_TEXT_PER_RECORD; i++) {
+			if ((uint16_t) strtoul(p, &pNext, 10) != CheckSink::sampleAt(index + i)) {
+				(*pErrors)++;
+			}
+			p = pNext;
+		}
+		p += 2;
+		samples += BENCH_TEXT_PER_RECORD;
+	}
+	return samples;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	std::vector<uint8_t> stream;
+	std::vector<char> text;
+	CheckSink sink;
+	adcframe::Decoder decoder(sink);
+	uint32_t bad;
+	uint64_t textSamples, textErrors = 0;
+	size_t pos, n;
+	double t0, sec;
+
+	buildStream(stream, &bad);
+	t0 = nowSec();
+	for (pos = 0; pos < stream.size(); pos += n) {
+		n = stream.size() - pos;
+		if (n > BENCH_READ_BYTES) {
+			n = BENCH_READ_BYTES;
+		}
+		decoder.feed(&stream[pos], n);
+	}
+	sec = nowSec() - t0;
+
+	const adcframe::Stats &st = decoder.stats();
+	printf("binary: %.1f MB, %.2f bytes/sample, %.0f MB/s, %.1f Msamples/s\n", stream.size() / 1e6,
+		   (double) stream.size() / (BENCH_FRAMES * (double) BENCH_FRAME_SAMPLES), st.bytes / sec / 1e6,
+		   st.samples / sec / 1e6);
+	printf("        frames %llu, text lines %llu (%llu skipped), bad frames %llu (%u injected), sequence gaps %llu, "
+		   "sample errors %llu\n", (unsigned long long) st.frames, (unsigned long long) st.textLines,
+		   (unsigned long long) st.skippedLines,
+		   (unsigned long long) st.crcErrors, bad, (unsigned long long) st.seqGaps,
+		   (unsigned long long) sink.mErrors);
+	printf("        rate %.4f Hz, drift %.2f ppm (%.2f true), worst sample time error %.3f us\n",
+		   sink.mTime.sampleRate(), sink.mTime.driftPpm(BENCH_CORE_HZ), BENCH_DRIFT_PPM, sink.mTimeErrorUs);
+
+	buildText(text);
+	t0 = nowSec();
+	textSamples = parseText(text, &textErrors);
+	sec = nowSec() - t0;
+	printf("text:   %.1f MB, %.2f bytes/sample, %.0f MB/s, %.1f Msamples/s, sample errors %llu\n",
+		   text.size() / 1e6, (double) text.size() / textSamples, text.size() / sec / 1e6,
+		   textSamples / sec / 1e6, (unsigned long long) textErrors);
+	return 0;
+}
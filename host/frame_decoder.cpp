@@ -0,0 +1,285 @@
+/*
+ * @brief Host reader of the device CDC stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+/*
+ * Host side reader of the device CDC stream, see frame_decoder.h. Build
+ * the library from this directory with:
+ *
+ *   g++ -O2 -I../example/inc -c frame_decoder.cpp
+ */
+
+#include "frame_decoder.h"
+#include "host_frame.h"
+
+namespace adcframe {
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* CRC-16/CCITT-FALSE, same as Frame_Crc16() on the device */
+static uint16_t crcTable[256];
+
+static void crcInit(void)
+{
+	uint16_t crc;
+	int i, b;
+
+	for (i = 0; i < 256; i++) {
+		crc = (uint16_t) (i << 8);
+		for (b = 0; b < 8; b++) {
+			crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+		}
+		crcTable[i] = crc;
+	}
+}
+
+static uint16_t crc16(const uint8_t *p, size_t len)
+{
+	uint16_t crc = 0xFFFF;
+
+	while (len--) {
+		crc = (uint16_t) ((crc << 8) ^ crcTable[(crc >> 8) ^ *p++]);
+	}
+	return crc;
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+	return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+	return get16(p) | ((uint32_t) get16(&p[2]) << 16);
+}
+
+enum {
+	FRAME_NEED_MORE,
+	FRAME_BAD,
+	FRAME_GOOD
+};
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+void unpack12(const uint8_t *pIn, size_t count, uint16_t *pOut)
+{
+	for (; count >= 2; count -= 2) {
+		pOut[0] = (uint16_t) (pIn[0] | ((pIn[1] & 0x0F) << 8));
+		pOut[1] = (uint16_t) ((pIn[1] >> 4) | (pIn[2] << 4));
+		pIn += 3;
+		pOut += 2;
+	}
+	if (count) {
+		pOut[0] = (uint16_t) (pIn[0] | ((pIn[1] & 0x0F) << 8));
+	}
+}
+
+Decoder::Decoder(Sink &sink)
+	: mSink(sink), mStats(), mNextSeq(0), mHaveSeq(false), mInSync(true)
+{
+	mSamples.resize(0xFFFF);
+	if (crcTable[1] == 0) {
+		crcInit();
+	}
+}
+
+void Decoder::feed(const uint8_t *pData, size_t len)
+{
+	size_t used;
+
+	mStats.bytes += len;
+	if (mPending.empty()) {
+		/* Common case, no copy unless a frame or line is cut */
+		used = parse(pData, len);
+		mPending.assign(pData + used, pData + len);
+		return;
+	}
+
+	mPending.insert(mPending.end(), pData, pData + len);
+	used = parse(mPending.data(), mPending.size());
+	mPending.erase(mPending.begin(), mPending.begin() + used);
+}
+
+/* Decode what is complete, return the bytes consumed */
+size_t Decoder::parse(const uint8_t *p, size_t len)
+{
+	size_t pos = 0, lineStart = 0, used;
+	bool binary = false;
+	int result;
+
+	while (pos < len) {
+		if (p[pos] == FRAME_SYNC0) {
+			result = frameAt(&p[pos], len - pos, &used);
+			if (result == FRAME_NEED_MORE) {
+				return lineStart;
+			}
+			if (result == FRAME_GOOD) {
+				pos += used;
+			}
+			else {
+				/* Resynchronize on the next sync byte, count the frame once */
+				if (mInSync) {
+					mStats.crcErrors++;
+				}
+				mInSync = false;
+				pos++;
+			}
+			lineStart = pos;
+			binary = false;
+		}
+		else if (p[pos] == '\n') {
+			used = pos - lineStart;
+			if (used && (p[pos - 1] == '\r')) {
+				used--;
+			}
+			/* Lines with 8-bit bytes are pieces of a damaged frame */
+			if (binary) {
+				mStats.skippedLines++;
+			}
+			else {
+				mStats.textLines++;
+				mSink.onText(reinterpret_cast<const char *>(&p[lineStart]), used);
+			}
+			lineStart = ++pos;
+			binary = false;
+		}
+		else {
+			binary |= (p[pos] & 0x80) != 0;
+			pos++;
+		}
+	}
+
+	return lineStart;
+}
+
+/* Check and decode a frame starting at p */
+int Decoder::frameAt(const uint8_t *p, size_t len, size_t *pUsed)
+{
+	uint32_t payload, count, total, seq;
+	Frame frame;
+
+	if (len < 2) {
+		return FRAME_NEED_MORE;
+	}
+	if (p[1] != FRAME_SYNC1) {
+		return FRAME_BAD;
+	}
+	if (len < FRAME_HEADER_BYTES) {
+		return FRAME_NEED_MORE;
+	}
+	payload = get16(&p[4]);
+	count = get16(&p[6]);
+	if ((p[2] != FRAME_TYPE_SAMPLES12) || (payload != FRAME_PAYLOAD_BYTES(count))) {
+		return FRAME_BAD;
+	}
+	total = FRAME_BYTES(count);
+	if (len < total) {
+		return FRAME_NEED_MORE;
+	}
+	if (crc16(p, total - FRAME_CRC_BYTES) != get16(&p[total - FRAME_CRC_BYTES])) {
+		return FRAME_BAD;
+	}
+
+	seq = get32(&p[8]);
+	if (mHaveSeq && (seq != mNextSeq)) {
+		mStats.seqGaps += seq - mNextSeq;
+	}
+	mHaveSeq = true;
+	mNextSeq = seq + 1;
+	mInSync = true;
+
+	unpack12(&p[FRAME_HEADER_BYTES], count, mSamples.data());
+	frame.type = p[2];
+	frame.flags = p[3];
+	frame.seq = seq;
+	frame.timestamp = get32(&p[12]);
+	frame.chanMask = get32(&p[16]);
+	frame.timeIndex = get32(&p[20]);
+	frame.timeCycles = get32(&p[24]);
+	frame.sofFrame = get32(&p[28]);
+	frame.sofCycles = get32(&p[32]);
+	frame.count = count;
+	frame.samples = mSamples.data();
+
+	mStats.frames++;
+	mStats.samples += count;
+	mSink.onFrame(frame);
+	*pUsed = total;
+
+	return FRAME_GOOD;
+}
+
+Timeline::Timeline()
+	: mStarted(false), mReady(false), mLastCycles(0), mLastSofCycles(0), mCycles(0), mSofCycles(0),
+	  mFirstCycles(0), mFirstSofCycles(0), mFirstIndex(0), mFirstSofFrame(0),
+	  mCyclesPerSample(0), mCyclesPerMs(0)
+{}
+
+void Timeline::update(const Frame &frame)
+{
+	if ((frame.flags & FRAME_FLAG_SOF) == 0) {
+		return;
+	}
+
+	/* References come every block, well within the 32-bit cycle wrap */
+	if (!mStarted) {
+		mStarted = true;
+		mCycles = mFirstCycles = frame.timeCycles;
+		mSofCycles = mFirstSofCycles = frame.sofCycles;
+		mFirstIndex = frame.timeIndex;
+		mFirstSofFrame = frame.sofFrame;
+	}
+	else {
+		mCycles += (uint32_t) (frame.timeCycles - mLastCycles);
+		mSofCycles += (uint32_t) (frame.sofCycles - mLastSofCycles);
+	}
+	mLastCycles = frame.timeCycles;
+	mLastSofCycles = frame.sofCycles;
+
+	if ((frame.sofFrame != mFirstSofFrame) && (frame.timeIndex != mFirstIndex)) {
+		mCyclesPerMs = (double) (mSofCycles - mFirstSofCycles) / (uint32_t) (frame.sofFrame - mFirstSofFrame);
+		mCyclesPerSample = (double) (mCycles - mFirstCycles) / (uint32_t) (frame.timeIndex - mFirstIndex);
+		mReady = true;
+	}
+}
+
+double Timeline::sampleTime(const Frame &frame, uint32_t index) const
+{
+	double cycles = (double) (int32_t) (frame.timeCycles - frame.sofCycles) +
+					((double) (int32_t) (index - frame.timeIndex) * mCyclesPerSample);
+
+	return frame.sofFrame + (cycles / mCyclesPerMs);
+}
+
+}	// namespace adcframe
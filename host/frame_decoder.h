@@ -0,0 +1,153 @@
+/*
+ * @brief Host reader of the device CDC stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#ifndef __FRAME_DECODER_H_
+#define __FRAME_DECODER_H_
+
+/*
+ * Host side reader of the device CDC stream. Bytes are fed as they come
+ * from the serial port; binary sample frames (host_frame.h) and text
+ * lines are separated and handed to a sink. Frames are checked by length
+ * and CRC, a bad frame is skipped by resynchronizing on the next sync
+ * byte. A Timeline follows the time references of the frames and
+ * gives the time of any sample on the host's USB frame clock.
+ */
+
+namespace adcframe {
+
+/** One decoded sample frame */
+struct Frame {
+	uint8_t type;
+	uint8_t flags;
+	uint32_t seq;
+	uint32_t timestamp;			/*!< Index of the first sample */
+	uint32_t chanMask;
+	uint32_t timeIndex;			/*!< Sample index of the time reference */
+	uint32_t timeCycles;		/*!< Device cycle count at that sample */
+	uint32_t sofFrame;			/*!< Start of frames counted by the device */
+	uint32_t sofCycles;			/*!< Device cycle count at that start of frame */
+	uint32_t count;				/*!< Samples in samples[] */
+	const uint16_t *samples;	/*!< Valid during the callback only */
+};
+
+/** Receiver of the decoded stream */
+class Sink {
+public:
+	virtual ~Sink() {}
+	virtual void onFrame(const Frame &frame) = 0;
+	virtual void onText(const char *pLine, size_t len) { (void) pLine; (void) len; }
+};
+
+/** Decoder counters */
+struct Stats {
+	uint64_t bytes;				/*!< Bytes fed */
+	uint64_t frames;			/*!< Good frames */
+	uint64_t samples;			/*!< Samples in good frames */
+	uint64_t crcErrors;			/*!< Frames lost to a bad CRC or header */
+	uint64_t seqGaps;			/*!< Frames missing from the sequence */
+	uint64_t textLines;
+	uint64_t skippedLines;		/*!< Damaged frame bytes passed over while resynchronizing */
+};
+
+/**
+ * @brief	Unpack samples stored two in three bytes
+ * @param	pIn		: Packed payload
+ * @param	count	: Number of samples
+ * @param	pOut	: Room for count samples
+ */
+void unpack12(const uint8_t *pIn, size_t count, uint16_t *pOut);
+
+/** Stream decoder, keeps partial frames and lines between feed() calls */
+class Decoder {
+public:
+	explicit Decoder(Sink &sink);
+
+	/** Decode the next bytes of the stream */
+	void feed(const uint8_t *pData, size_t len);
+
+	const Stats &stats() const { return mStats; }
+
+private:
+	size_t parse(const uint8_t *p, size_t len);
+	int frameAt(const uint8_t *p, size_t len, size_t *pUsed);
+
+	Sink &mSink;
+	Stats mStats;
+	std::vector<uint8_t> mPending;
+	std::vector<uint16_t> mSamples;
+	uint32_t mNextSeq;
+	bool mHaveSeq;
+	bool mInSync;				/*!< Last frame was good */
+};
+
+/**
+ * Sample times from the frame time references. Every reference pairs a
+ * sample with the device cycle count and the last USB start of frame
+ * with its cycle count. The device cycles per sample and per 1 ms frame
+ * are measured over the whole run, so the sample rate and the drift of
+ * the device oscillator come out against the host's frame clock.
+ */
+class Timeline {
+public:
+	Timeline();
+
+	/** Take the time reference of a frame, frames without FRAME_FLAG_SOF are ignored */
+	void update(const Frame &frame);
+
+	/** Estimates are available after two references at least one frame apart */
+	bool ready() const { return mReady; }
+
+	/** Time of a sample, in ms on the USB frame clock counted by the device */
+	double sampleTime(const Frame &frame, uint32_t index) const;
+
+	/** Sample rate in Hz of the host clock */
+	double sampleRate() const { return 1000.0 * mCyclesPerMs / mCyclesPerSample; }
+
+	/** Device cycle clock against the host clock, in ppm from nominalHz */
+	double driftPpm(double nominalHz) const { return ((1000.0 * mCyclesPerMs / nominalHz) - 1.0) * 1e6; }
+
+private:
+	bool mStarted;
+	bool mReady;
+	uint32_t mLastCycles, mLastSofCycles;
+	uint64_t mCycles, mSofCycles;		/*!< Unwrapped cycle counts of the latest reference */
+	uint64_t mFirstCycles, mFirstSofCycles;
+	uint32_t mFirstIndex, mFirstSofFrame;
+	double mCyclesPerSample;
+	double mCyclesPerMs;
+};
+
+}	// namespace adcframe
+
+#endif /* __FRAME_DECODER_H_ */
@@ -0,0 +1,228 @@
+/*
+ * @brief Host check of the lossless block encoder
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+/*
+ * Host check of the device block encoder: lossless round trip, compression
+ * ratio and run time on synthetic traces and on recorded ones. A recorded
+ * trace is a text file of 12-bit samples, one per line, as written by
+ * rice_decode. Build from this directory with:
+ *
+ *   gcc -O2 -I../example/inc -o rice_bench rice_bench.c ../example/src/dsp_rice.c -lm
+ *
+ * and run it as "rice_bench [trace...]".
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "dsp_rice.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Samples per encoded block, the DMA block of the device */
+#define BENCH_BLOCK         256
+
+/* Length of the synthetic traces */
+#define BENCH_TRACE         (64 * 1024)
+
+/* Sample rate assumed by the synthetic traces */
+#define BENCH_FS_HZ         16000
+
+/* Longest recorded trace read */
+#define BENCH_TRACE_MAX     (4 * 1024 * 1024)
+
+static const char *const synthNames[] = {"dc + 2 LSB noise", "50 Hz 1500 LSB", "1 kHz 1800 LSB",
+										 "steps + 3 Hz", "full scale noise"};
+
+static uint16_t trace[BENCH_TRACE_MAX];
+static uint16_t decoded[BENCH_BLOCK];
+static uint8_t packed[DSP_RICE_MAX_BYTES(BENCH_BLOCK)];
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static double nowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+static uint64_t nowTicks(void)
+{
+#if defined(HAVE_TSC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/* Uniform noise in [-amp, amp] */
+static double noise(double amp)
+{
+	return amp * ((2.0 * rand() / RAND_MAX) - 1.0);
+}
+
+static uint16_t clip12(double v)
+{
+	long s = lround(v);
+
+	return (uint16_t) ((s < 0) ? 0 : ((s > 0xFFF) ? 0xFFF : s));
+}
+
+/* Fill trace[] with one of the synthetic signals, return its name */
+static const char *synthTrace(uint32_t num, uint32_t *pLen)
+{
+	uint32_t i;
+	double t;
+
+	srand(1);
+	*pLen = BENCH_TRACE;
+	for (i = 0; i < BENCH_TRACE; i++) {
+		t = (double) i / BENCH_FS_HZ;
+		switch (num) {
+		case 0:
+			trace[i] = clip12(1200 + noise(2));
+			break;
+
+		case 1:
+			trace[i] = clip12(2048 + 1500 * sin(2 * M_PI * 50 * t) + noise(3));
+			break;
+
+		case 2:
+			trace[i] = clip12(2048 + 1800 * sin(2 * M_PI * 1000 * t) + noise(3));
+			break;
+
+		case 3:
+			trace[i] = clip12(((i / 4000) & 1 ? 3000 : 800) + 200 * sin(2 * M_PI * 3 * t) + noise(2));
+			break;
+
+		case 4:
+			trace[i] = (uint16_t) (rand() & 0xFFF);
+			break;
+
+		default:
+			return NULL;
+		}
+	}
+
+	return synthNames[num];
+}
+
+/* Read a recorded trace, one sample per line */
+static bool loadTrace(const char *pPath, uint32_t *pLen)
+{
+	FILE *f = fopen(pPath, "r");
+	unsigned int v;
+	uint32_t n = 0;
+
+	if (f == NULL) {
+		return false;
+	}
+	while ((n < BENCH_TRACE_MAX) && (fscanf(f, "%u", &v) == 1)) {
+		trace[n++] = (uint16_t) (v & 0xFFF);
+	}
+	fclose(f);
+	*pLen = n;
+
+	return n >= BENCH_BLOCK;
+}
+
+/* Encode and decode a trace block by block, then time the encoder alone */
+static void benchTrace(const char *pName, uint32_t len)
+{
+	uint32_t i, n, bytes, total = 0;
+	double t0, encNs, decNs = 0;
+	uint64_t c0, ticks;
+
+	len -= len % BENCH_BLOCK;
+	for (i = 0; i < len; i += BENCH_BLOCK) {
+		bytes = DSP_Rice_Encode(&trace[i], BENCH_BLOCK, packed);
+		total += bytes;
+
+		t0 = nowNs();
+		n = DSP_Rice_Decode(packed, bytes, decoded, BENCH_BLOCK);
+		decNs += nowNs() - t0;
+		if ((n != BENCH_BLOCK) || (memcmp(decoded, &trace[i], sizeof(decoded)) != 0)) {
+			printf("%-20s: round trip FAILED at sample %u\n", pName, i);
+			return;
+		}
+	}
+
+	t0 = nowNs();
+	c0 = nowTicks();
+	for (i = 0; i < len; i += BENCH_BLOCK) {
+		DSP_Rice_Encode(&trace[i], BENCH_BLOCK, packed);
+	}
+	ticks = nowTicks() - c0;
+	encNs = nowNs() - t0;
+
+	printf("%-20s: %5.2f bits/sample, ratio %4.2f vs 16-bit, %4.2f vs 12-bit packed, "
+		   "encode %5.1f ns %5.1f ticks, decode %5.1f ns per sample\n",
+		   pName, (8.0 * total) / len, (2.0 * len) / total, (1.5 * len) / total,
+		   encNs / len, (double) ticks / len, decNs / len);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(int argc, char **argv)
+{
+	const char *pName;
+	uint32_t num, len;
+	int i;
+
+	printf("Blocks of %u samples, worst case %u bytes\n", BENCH_BLOCK, DSP_RICE_MAX_BYTES(BENCH_BLOCK));
+	for (num = 0; (pName = synthTrace(num, &len)) != NULL; num++) {
+		benchTrace(pName, len);
+	}
+	for (i = 1; i < argc; i++) {
+		if (!loadTrace(argv[i], &len)) {
+			printf("%s: cannot read a trace of at least %u samples\n", argv[i], BENCH_BLOCK);
+			continue;
+		}
+		benchTrace(argv[i], len);
+	}
+	return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * @brief Host decoder of the packed sample stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+/*
+ * Host decoder of the packed sample stream ("mode packed"). Reads the
+ * device output from stdin, rebuilds every block from its K header and Z
+ * records, decodes it and writes the samples to stdout, one per line.
+ * Blocks dropped by the device show up as gaps in the sample index and
+ * are reported on stderr with the compression ratio. Build from this
+ * directory with:
+ *
+ *   gcc -O2 -I../example/inc -o rice_decode rice_decode.c ../example/src/dsp_rice.c
+ *
+ * and run it as "rice_decode < capture.txt > trace.txt".
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsp_rice.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Largest block the device sends */
+#define DECODE_MAX_SAMPLES  1024
+
+static uint8_t block[DSP_RICE_MAX_BYTES(DECODE_MAX_SAMPLES)];
+static uint16_t samples[DECODE_MAX_SAMPLES];
+
+/* Block being rebuilt */
+static unsigned int blockStart, blockSamples, blockBytes, blockFill;
+static bool inBlock;
+
+/* Totals for stderr */
+static unsigned long blocks, badBlocks, gaps, lostSamples, totalSamples, totalBytes;
+static unsigned int nextStart;
+static bool started;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static int hexValue(char c)
+{
+	if ((c >= '0') && (c <= '9')) {
+		return c - '0';
+	}
+	if ((c >= 'A') && (c <= 'F')) {
+		return c - 'A' + 10;
+	}
+	if ((c >= 'a') && (c <= 'f')) {
+		return c - 'a' + 10;
+	}
+	return -1;
+}
+
+/* Decode the rebuilt block and write its samples */
+static void finishBlock(void)
+{
+	unsigned int i, n;
+
+	inBlock = false;
+	n = DSP_Rice_Decode(block, blockBytes, samples, DECODE_MAX_SAMPLES);
+	if (n != blockSamples) {
+		badBlocks++;
+		return;
+	}
+
+	if (started && (blockStart != nextStart)) {
+		gaps++;
+		lostSamples += blockStart - nextStart;
+	}
+	started = true;
+	nextStart = blockStart + n;
+
+	for (i = 0; i < n; i++) {
+		printf("%u\n", samples[i]);
+	}
+	blocks++;
+	totalSamples += n;
+	totalBytes += blockBytes;
+}
+
+/* Start a block from its K record */
+static void startBlock(const char *pArgs)
+{
+	if (inBlock) {
+		badBlocks++;
+	}
+	inBlock = (sscanf(pArgs, "%u %u %u", &blockStart, &blockSamples, &blockBytes) == 3) &&
+			  (blockSamples <= DECODE_MAX_SAMPLES) && (blockBytes <= sizeof(block));
+	blockFill = 0;
+}
+
+/* Append the bytes of a Z record */
+static void addData(const char *pArgs)
+{
+	unsigned int offset;
+	int pos, hi, lo;
+
+	if (!inBlock) {
+		return;
+	}
+	if ((sscanf(pArgs, "%u %n", &offset, &pos) != 1) || (offset != blockFill)) {
+		inBlock = false;
+		badBlocks++;
+		return;
+	}
+	pArgs += pos;
+	while (((hi = hexValue(pArgs[0])) >= 0) && ((lo = hexValue(pArgs[1])) >= 0) &&
+		   (blockFill < blockBytes)) {
+		block[blockFill++] = (uint8_t) ((hi << 4) | lo);
+		pArgs += 2;
+	}
+	if (blockFill == blockBytes) {
+		finishBlock();
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	char line[256];
+
+	while (fgets(line, sizeof(line), stdin) != NULL) {
+		if ((line[0] == 'K') && (line[1] == ' ')) {
+			startBlock(&line[2]);
+		}
+		else if ((line[0] == 'Z') && (line[1] == ' ')) {
+			addData(&line[2]);
+		}
+	}
+
+	fprintf(stderr, "%lu blocks, %lu samples, %lu bad blocks, %lu gaps (%lu samples lost)\n",
+			blocks, totalSamples, badBlocks, gaps, lostSamples);
+	if (totalBytes) {
+		fprintf(stderr, "%.2f bits per sample, ratio %.2f vs 16-bit\n",
+				(8.0 * totalBytes) / totalSamples, (2.0 * totalSamples) / totalBytes);
+	}
+	return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * @brief Simulated USB host for the audio stream
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2013
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+/*
+ * Host side stand-in for the USB stack around the audio stream
+ * (uac_stream.c). It plays the host controller sending a start of frame
+ * every millisecond on the host clock and the device around the stream:
+ * the SCT sample clock on a crystal that is off by a given amount, the
+ * DMA blocks handed over by the main loop after a random delay and the
+ * start of frame handler of usb_audio.c that trims the sample clock.
+ * Every scenario checks that the loop locks the sample clock to the
+ * frames, that the packets carry every sample once and in order, and
+ * how far the read position strays from the latency. Build from this
+ * directory with:
+ *
+ *   gcc -O2 -I../example/inc -o uac_sim uac_sim.c ../example/src/uac_stream.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "uac_stream.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Device as built: SCT clock, sample rate, DMA block and latency */
+#define SIM_SCT_HZ          72000000.0
+#define SIM_RATE_HZ         16000
+#define SIM_BLOCK_SAMPLES   256
+#define SIM_LATENCY         (SIM_BLOCK_SAMPLES + (8 * (SIM_RATE_HZ / 1000)))
+
+/* Seconds simulated, the loop must have settled after SIM_SETTLE_S */
+#define SIM_RUN_S           60
+#define SIM_SETTLE_S        10
+
+/* Start of frame interrupt latency and main loop delay before a block is
+   queued, both random up to these */
+#define SIM_SOF_JITTER_S    30e-6
+#define SIM_MAIN_DELAY_S    6e-3
+
+typedef struct {
+	const char *pName;
+	double ppm;					/* Crystal error of the device */
+	double pauseAt;				/* Sample clock stopped for a recalibration, 0 for none */
+	double pauseLen;
+} SCENARIO_T;
+
+static const SCENARIO_T scenarios[] = {
+	{"exact", 0, 0, 0},
+	{"fast 50 ppm", 50, 0, 0},
+	{"slow 50 ppm", -50, 0, 0},
+	{"fast 200 ppm", 200, 0, 0},
+	{"slow 200 ppm", -200, 0, 0},
+	{"recal pause 4 ms", 80, 30, 4e-3},
+};
+
+/* Device state */
+static double sampleTime;		/* Host time of the next conversion */
+static double tickSec;			/* SCT tick on the host clock */
+static uint32_t periodTicks, fracAcc;
+static uint32_t converted;		/* Conversions so far */
+static uint16_t block[SIM_BLOCK_SAMPLES];
+
+/* Blocks waiting for the main loop: index of the first sample and the
+   time it is queued */
+#define SIM_PENDING         8
+static uint32_t pendingIndex[SIM_PENDING];
+static double pendingTime[SIM_PENDING];
+static uint32_t pendingHead, pendingTail;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static double randUnit(void)
+{
+	return rand() / (RAND_MAX + 1.0);
+}
+
+/* Sample n of the test signal, a 12-bit ramp */
+static uint16_t sampleAt(uint32_t index)
+{
+	return (uint16_t) (index & 0xFFF);
+}
+
+/* ADC_Trig_SetPeriodFrac() */
+static void setPeriodFrac(uint32_t period)
+{
+	fracAcc += period & 0xFFFF;
+	periodTicks = (period >> 16) + (fracAcc >> 16);
+	fracAcc &= 0xFFFF;
+}
+
+/* Run the sample clock and the main loop up to host time t */
+static void runDevice(double t, const SCENARIO_T *pSc)
+{
+	uint32_t i, first;
+
+	while (sampleTime <= t) {
+		converted++;
+		if ((converted % SIM_BLOCK_SAMPLES) == 0) {
+			/* Block done, the main loop queues it a little later */
+			pendingIndex[pendingHead % SIM_PENDING] = converted - SIM_BLOCK_SAMPLES;
+			pendingTime[pendingHead % SIM_PENDING] = sampleTime + (randUnit() * SIM_MAIN_DELAY_S);
+			pendingHead++;
+		}
+		sampleTime += periodTicks * tickSec;
+		if ((pSc->pauseAt != 0) && (sampleTime >= pSc->pauseAt) && (sampleTime < (pSc->pauseAt + pSc->pauseLen))) {
+			sampleTime = pSc->pauseAt + pSc->pauseLen;
+		}
+	}
+
+	/* Blocks are queued in order, a late one holds back the next */
+	while ((pendingTail != pendingHead) && (pendingTime[pendingTail % SIM_PENDING] <= t)) {
+		first = pendingIndex[pendingTail % SIM_PENDING];
+		for (i = 0; i < SIM_BLOCK_SAMPLES; i++) {
+			block[i] = sampleAt(first + i);
+		}
+		UAC_Stream_Write(block, SIM_BLOCK_SAMPLES);
+		pendingTail++;
+	}
+}
+
+/* Run one scenario, return false if it fails */
+static bool runScenario(const SCENARIO_T *pSc)
+{
+	int16_t packet[UAC_STREAM_FRAME_MAX(SIM_RATE_HZ)];
+	const UAC_STREAM_STATS_T *pStats = UAC_Stream_GetStats();
+	const uint32_t nominal = (uint32_t) (((uint64_t) SIM_SCT_HZ * 65536) / SIM_RATE_HZ);
+	uint32_t frame, n, i, settleConverted = 0, breaks = 0, received = 0;
+	uint32_t settleFrame = SIM_SETTLE_S * 1000, underruns = 0, inserted = 0;
+	int32_t errorMax = 0, expect = -1, value;
+	double t, trimPpm, settleTime = 0, rateSeen;
+
+	converted = 0;
+	fracAcc = 0;
+	periodTicks = nominal >> 16;
+	tickSec = 1.0 / (SIM_SCT_HZ * (1.0 + (pSc->ppm * 1e-6)));
+	sampleTime = periodTicks * tickSec;
+	pendingHead = pendingTail = 0;
+	UAC_Stream_Init(SIM_RATE_HZ, SIM_LATENCY);
+
+	for (frame = 0; frame < (SIM_RUN_S * 1000); frame++) {
+		t = (frame * 1e-3) + (randUnit() * SIM_SOF_JITTER_S);
+		runDevice(t, pSc);
+
+		/* The host selects the streaming setting after enumeration */
+		if (frame == 100) {
+			UAC_Stream_Start();
+		}
+
+		/* usb_audio_sof_event() */
+		n = UAC_Stream_Frame(converted, packet);
+		setPeriodFrac(nominal + (int32_t) (((int64_t) nominal * UAC_Stream_GetTrim()) >> 24));
+
+		/* Check the packet as the host reads it, silence may come
+		   between two samples of the ramp */
+		for (i = 0; i < n; i++) {
+			if ((packet[i] == 0) && (expect != 0x800)) {
+				continue;
+			}
+			value = ((packet[i] + 0x8000) >> 4) & 0xFFF;
+			if ((expect >= 0) && (value != expect)) {
+				breaks++;
+			}
+			expect = (value + 1) & 0xFFF;
+		}
+		if (frame >= settleFrame) {
+			received += n;
+			if (abs(pStats->error) > errorMax) {
+				errorMax = abs(pStats->error);
+			}
+		}
+		if (frame == settleFrame) {
+			settleConverted = converted;
+			settleTime = t;
+			underruns = pStats->underruns;
+			inserted = pStats->inserted;
+		}
+	}
+
+	trimPpm = UAC_Stream_GetTrim() * (1e6 / (1 << 24));
+	/* Silence sent during a pause stands in for samples of the clock */
+	inserted = pStats->inserted - inserted;
+	rateSeen = (converted - settleConverted + inserted) / (t - settleTime);
+	underruns = pStats->underruns - underruns;
+	printf("%-18s trim %+7.1f ppm, rate %.2f Hz, error max %d, breaks %u, underruns %u, inserted %u, "
+		   "resyncs %u, %u samples in %u frames\n", pSc->pName, trimPpm, rateSeen, errorMax, breaks, underruns,
+		   inserted, pStats->resyncs, received, (SIM_RUN_S - SIM_SETTLE_S) * 1000);
+
+	/* Locked within 1 ppm and no sample lost */
+	if ((rateSeen < (SIM_RATE_HZ * (1 - 1e-6))) || (rateSeen > (SIM_RATE_HZ * (1 + 1e-6)))) {
+		return false;
+	}
+	return (breaks == 0) && (underruns == 0) && (pStats->resyncs == 0);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	uint32_t i, failed = 0;
+
+	srand(1);
+	for (i = 0; i < (sizeof(scenarios) / sizeof(scenarios[0])); i++) {
+		if (!runScenario(&scenarios[i])) {
+			printf("  FAILED\n");
+			failed++;
+		}
+	}
+	return failed ? 1 : 0;
+}